@@ -4,11 +4,14 @@
    @brief QML element to equalize axes.
 */
 
-#include <map>
 #include <utility>
+#include <vector>
+#include <QHash>
 #include <QObject>
 #include <QPointF>
 #include <QRectF>
+#include <QString>
+#include <QTimer>
 
 /**
    @brief Helper QML element to ensure that axes of a plot have equal scaling.
@@ -17,6 +20,27 @@
    plot area. It is useful in connection with QtChart plots, to automatically resize axes
    ranges to enforce equal scaling of axes.
 
+   Changes of the registered ranges and of the plot area are collected, and evaluated at
+   most once per frame. The bounding box is extended incrementally, and only recomputed from
+   all series when a series that defined one of its edges shrinks. Axes can therefore be
+   set directly from equalAxisChanged(), without a bind loop through the plot area.
+
+   \rst
+   .. code-block:: qml
+
+     AxisEqualizer {
+       id: mapEqualizer;
+       plotArea: map.plotArea;
+       onEqualAxisChanged: {
+         mapX.min = mapEqualizer.equalAxisX.x;
+         mapX.max = mapEqualizer.equalAxisX.y;
+         mapY.min = mapEqualizer.equalAxisY.x;
+         mapY.max = mapEqualizer.equalAxisY.y;
+       }
+     }
+
+   \endrst
+
 */
 class AxisEqualizer : public QObject
 {
@@ -32,7 +56,8 @@ public:
   /**
      @brief Constructor.
 
-     Connects signals boundingBoxChanged() and plotAreaChanged() to slot calculateEqualAxes().
+     Connects signal boundingBoxChanged() to slot calculateEqualAxes(), and plotAreaChanged()
+     to a deferred evaluation.
 
      @param[in] parent QObject pointer.
   */
@@ -95,7 +120,8 @@ public slots:
      This function registers a data series' x-range and y-range. These ranges signifies
      the bounding box of a data series. All registered ranges are used when updating the
      global bounding box. This function is typically called when the range of a data
-     series changes, and the plotting region potentially needs to be updated.
+     series changes, and the plotting region potentially needs to be updated. The bounding
+     box is evaluated with the next frame, so many calls are handled together.
 
      @param[in] seriesName Name of the data series to register or update.
      @param[in] xR x-axis value range.
@@ -113,9 +139,9 @@ public slots:
   /**
      @brief Evaluate bounding box ranges bboxX bboxY.
 
-     Iterates over all data series that are registered wit registerBox() and finds the
+     Iterates over all data series that are registered with registerBox() and finds the
      bounding box that contains all the data series. Conditionally emits
-     bondingBoxChanged().
+     boundingBoxChanged().
 
   */
   void evaluateBoundingBox();
@@ -125,10 +151,26 @@ public slots:
   */
   void setPlotArea(QRectF plotArea);
 
+private slots:
+  /**
+     @brief Emit the changes collected since the last frame.
+  */
+  void flush();
+
+private:
+  /**
+     @brief Emit boundingBoxChanged() if the bounding box differs from the last emitted.
+  */
+  void emitBoundingBox();
+
 protected:
-  /// Data structure to hold value ranges for two axes of a named data series. Set with registerBox().
-  std::map<QString, std::pair<QPointF, QPointF>> m_ranges;
+  /// Data structure to hold value ranges for two axes of each data series. Set with registerBox().
+  std::vector<std::pair<QPointF, QPointF>> m_ranges;
+  QHash<QString, size_t> m_rangeIndex; ///< Index into m_ranges for a data series name.
   std::pair<QPointF, QPointF> m_bbox; ///< Global bounding box ranges.
+  std::pair<QPointF, QPointF> m_emittedBox; ///< Bounding box at the last boundingBoxChanged().
+  bool m_bboxStale; ///< Bounding box must be recomputed from all ranges.
+  QTimer m_frameTimer; ///< Defers evaluation to the next frame.
   std::pair<QPointF, QPointF> m_equalAxes; ///< Equal axes ranges.
   QRectF m_plotArea; ///< Plot area.
   //double m_marginPercent;
@@ -5,6 +5,7 @@
 */
 
 #include "sinspekto/QtToDds.hpp"
+#include "sinspekto/DdsPublisher.hpp"
 
 /**
    @brief Subscriber for DDS type Bit as a QML element.
@@ -86,7 +87,7 @@ private:
    DDS signal type from a writable QML property.
 
 */
-class DdsBitPublisher : public QObject
+class DdsBitPublisher : public DdsPublisher
 {
   Q_OBJECT
   Q_PROPERTY(bool signal READ signal WRITE setSignal NOTIFY signalChanged) ///< DDS Bit as bool QML property.
@@ -148,6 +149,10 @@ public slots:
   */
   void publish();
 
+protected:
+  /// Writes the sample on DDS.
+  void writeSample() override;
+
 private:
   std::unique_ptr<sinspekto::Writer<fkin::Bit>> m_writer; ///< The DDS writer wrapper class.
 };
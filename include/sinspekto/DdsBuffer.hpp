@@ -1,14 +1,22 @@
 #pragma once
 
+#include <atomic>
+#include <functional>
 #include <map>
+#include <tuple>
+#include <vector>
 #include <QObject>
 #include <QDateTime>
 #include <QAbstractSeries>
+#include <QQuickItem>
 
 #include "sinspekto/DdsDoubleBuffer.hpp"
+#include "sinspekto/DdsLatencyTrace.hpp"
 #include "sinspekto/DdsTimepointBuffer.hpp"
+#include "sinspekto/SeqLock.hpp"
+#include "sinspekto/SinspektoMetrics.hpp"
 
-namespace qml_enums{ enum class DimId; }
+namespace qml_enums{ enum class DimId; enum class JoinMode; }
 
 QT_CHARTS_USE_NAMESPACE
 
@@ -18,6 +26,11 @@ QT_CHARTS_USE_NAMESPACE
    This class has a virtual slot function updateBuffers() that needs to be defined in the
    derived class.
 
+   The buffers are written on the thread owning this object, usually the GUI thread. Other
+   threads can take consistent copies of a dimension with snapshot(), which does not block
+   the writer. Derived classes must append samples within a sinspekto::SeqLock::WriteGuard
+   on m_seqlock.
+
 */
 class DdsBuffer : public QObject
 {
@@ -48,6 +61,83 @@ class DdsBuffer : public QObject
      @brief Access function for maximal time point in buffer as QML property.
   */
   QDateTime rangeTmax() const;
+  /**
+     @brief Access the buffer of a dimension, e.g. to read its rolling statistics in QML.
+
+     \rst
+     .. code-block:: qml
+
+       Component.onCompleted: aBuffer.dimension(FKIN.X).statistics = true;
+       Label { text: aBuffer.dimension(FKIN.X).mean; }
+
+     \endrst
+
+     @param[in] dim Dimension identifier, cannot be DimId::T.
+     @return Pointer to the dimension's buffer, nullptr if the dimension does not exist.
+  */
+  Q_INVOKABLE DdsDoubleBuffer* dimension(qml_enums::DimId dim) const;
+  /**
+     @brief Take a consistent copy of time points and values of a dimension.
+
+     This function is safe to call from any thread while the buffers are being appended
+     to, see sinspekto::SeqLock. It retries the copy until it was not disturbed by a
+     write. Reuse the output vectors to avoid allocations.
+
+     @note The buffer must be initialized with init() before any thread calls this.
+
+     @param[in] dim Dimension identifier, cannot be DimId::T.
+     @param[out] time Time points in milliseconds since epoch.
+     @param[out] values Values of the dimension, same length as time.
+     @return False if the dimension does not exist.
+  */
+  bool snapshot(
+      qml_enums::DimId dim,
+      std::vector<int64_t>& time,
+      std::vector<double>& values) const;
+  /**
+     @brief Access function to the time point buffer.
+
+     @return Pointer to the time point buffer.
+  */
+  DdsTimepointBuffer* timepoints() const { return m_time; }
+  /**
+     @brief Hint whether a series is shown, to skip updates of hidden series.
+
+     While a series is hidden, updateSeries() and joinSeries() only remember the latest
+     request for it. The request is carried out when the series is shown again. Series
+     without a hint are always updated.
+
+     @param[in] series Series that is updated from this buffer.
+     @param[in] visible False if the series is not on screen.
+  */
+  Q_INVOKABLE void setSeriesVisible(QAbstractSeries *series, bool visible);
+  /**
+     @brief Follow the visibility of an item, typically the chart showing a series.
+
+     The effective visibility of a Qt Quick item includes its parents, so a chart on an
+     inactive page of a StackLayout is hidden. See setSeriesVisible(). A series follows one
+     item, calling it again replaces the item.
+
+     \rst
+     .. code-block:: qml
+
+       Component.onCompleted: ddsBuffer.trackVisibility(lineSeries, chartView);
+
+     \endrst
+
+     @param[in] series Series that is updated from this buffer.
+     @param[in] item Item whose visibility applies to the series.
+  */
+  Q_INVOKABLE void trackVisibility(QAbstractSeries *series, QQuickItem *item);
+  /**
+     @brief Note that a series was updated from this buffer, for DdsLatencyTrace.
+
+     Called by updateSeries() and joinSeries(), and by items that draw the buffer
+     themselves, such as DdsLineSeries. Does nothing unless a drained group awaits it.
+  */
+  void traceUploaded();
+  /// Counters of this buffer, shown by SinspektoMetrics.
+  SinspektoMetrics::Counters& metrics() { return m_metrics; }
 
 signals:
   /**
@@ -78,6 +168,10 @@ public slots:
      and are fetched using a specific DimId enum. This enables indexing in QML scripting
      using e.g. `Fkin.Course`, instead of integer indexing.
 
+     Each combination of series and dimensions keeps its own point storage, which is
+     reused on subsequent calls, see sinspekto::SeriesStaging. Updates of hidden series
+     are deferred, see setSeriesVisible().
+
      @note yDim cannot be a time axis, that is, not DimId::T.
 
      @param[in,out] series Pointer to series to be updated.
@@ -89,6 +183,38 @@ public slots:
       qml_enums::DimId xDim,
       qml_enums::DimId yDim);
 
+  /**
+     @brief Updates a QAbstractSeries with data from this buffer paired with another buffer
+
+     The x-values are taken from xDim of this buffer, and the y-values from yDim of the
+     other buffer, aligned on the time points of this buffer. Both buffers are traversed
+     once in a single merge pass, which assumes that time points are non-decreasing.
+     Points of this buffer that precede the first sample of the other buffer, or that
+     cannot be matched within the tolerance, are left out.
+
+     \rst
+     .. code-block:: qml
+
+       ddsFish.joinSeries(depthSeries, FKIN.PosZ, ddsLeadline, FKIN.X, FKIN.Linear, 1000)
+
+     \endrst
+
+     @param[in,out] series Pointer to series to be updated.
+     @param[in] xDim Dimension identifier in this buffer, may be DimId::T.
+     @param[in] other Buffer to take y-values from, may be this buffer.
+     @param[in] yDim Dimension identifier in the other buffer, cannot be DimId::T.
+     @param[in] mode How to align the other buffer's samples on this buffer's time points.
+     @param[in] toleranceMs For JoinMode::AsOf the maximal age of the matched sample, for
+     JoinMode::Linear the maximal time between the interpolated samples. No limit if 0.
+  */
+  void joinSeries(
+      QAbstractSeries *series,
+      qml_enums::DimId xDim,
+      DdsBuffer *other,
+      qml_enums::DimId yDim,
+      qml_enums::JoinMode mode,
+      int toleranceMs = 0);
+
   /**
      @brief A function that should update the buffers with new data.
 
@@ -101,6 +227,15 @@ public slots:
   */
   virtual void updateBuffers() = 0;
 
+  /**
+     @brief Calls updateBuffers(), and stamps the drained samples for DdsLatencyTrace.
+
+     Buffers with a listener call this on each DDS event. It counts the drained samples
+     for SinspektoMetrics, and otherwise, without tracing enabled, it is the same as
+     updateBuffers().
+  */
+  void drain();
+
   /**
      @brief Clears all buffers
   */
@@ -109,11 +244,78 @@ public slots:
   /**
      @brief Initialize buffer and connect signals and slots for the time range properties.
 
+     Also adds the buffer to SinspektoMetrics, named after m_topic.
+
      @param[in] buffer_size Set capacity of DdsTimepointBuffer
   */
   void init(int buffer_size);
 
 protected:
+  /**
+     @brief Get the reusable point storage for a series and dimension pair.
+
+     The storage is created on first use and released when the series is destroyed.
+
+     @param[in] series Series the points are used for.
+     @param[in] xDim First dimension identifier.
+     @param[in] yDim Second dimension identifier.
+     @return Reference to the point storage.
+  */
+  sinspekto::SeriesStaging& staging(
+      QAbstractSeries *series,
+      qml_enums::DimId xDim,
+      qml_enums::DimId yDim);
+  /**
+     @brief Wrap the signal given to the DDS listener, to stamp the reception time.
+
+     \rst
+     .. code-block:: cpp
+
+       m_reader->listener = sinspekto::DdsReaderListener<fkin::IdVec2d>(
+           traceReception(std::bind(&DdsIdVec2dBuffer::eventHeard, this)));
+
+     \endrst
+
+     @param[in] signal Function emitting the signal connected to drain().
+     @return Function for the listener, called on a DDS thread.
+  */
+  std::function<void()> traceReception(std::function<void()> signal);
+  /**
+     @brief Note that samples were appended, for DdsLatencyTrace.
+
+     Called by updateBuffers() of derived classes right before emitting newData(), so
+     that series updated by its handlers count towards the upload stage, not the append
+     stage. Does nothing outside drain().
+  */
+  void traceAppended();
+
+  QString m_topic; ///< Topic name, set by init() of derived classes, names the latency trace.
   std::map<qml_enums::DimId, DdsDoubleBuffer *> m_buffers; ///< A map of buffers, key is DimId, value is DdsDoubleBuffer
   DdsTimepointBuffer* m_time; ///< Pointer to time point buffer.
+  sinspekto::SeqLock m_seqlock; ///< Guards the buffers for readers on other threads.
+
+private:
+  /// Visibility hint of a series, with the update deferred while it is hidden.
+  struct SeriesVisibility
+  {
+    bool visible = true; ///< Series is on screen.
+    std::function<void()> pending; ///< Latest update requested while hidden.
+    QMetaObject::Connection tracked; ///< Follows the item given to trackVisibility().
+  };
+
+  /// Hand the awaiting group to DdsLatencyTrace with its upload stamp.
+  void completeUpload(int64_t uploaded);
+
+  std::map<QAbstractSeries *, SeriesVisibility> m_visibility; ///< Visibility hints per series.
+
+  /// Key for series point storage: series and its x and y dimension.
+  typedef std::tuple<QAbstractSeries *, qml_enums::DimId, qml_enums::DimId> StagingKey;
+  std::map<StagingKey, sinspekto::SeriesStaging> m_staging; ///< Point storage per series binding.
+
+  std::atomic<int64_t> m_traceReceived; ///< First reception since the last drain, 0 if none.
+  DdsLatencyTrace::Group m_traceAwaiting; ///< Oldest drained group not yet shown, appended is 0 if none.
+  bool m_traceDraining; ///< Within updateBuffers() called by drain().
+  int64_t m_traceDrainAppended; ///< First append within the current drain, 0 if none.
+  int64_t m_traceDrainUpload; ///< First series update within the current drain, 0 if none.
+  SinspektoMetrics::Counters m_metrics; ///< Counters shown by SinspektoMetrics.
 };
@@ -5,8 +5,9 @@
 */
 
 #include <cinttypes>
+#include <unordered_map>
 #include "sinspekto/QtToDds.hpp"
-#include <QTimer>
+#include "sinspekto/TimerWheel.hpp"
 
 /**
    @brief Subscriber for DDS type Command as a QML element.
@@ -96,21 +97,23 @@ signals:
 
 public slots:
   /**
-     @brief Takes all new samples from the subscribed topic and uses the last sample.
+     @brief Takes all new samples from the subscribed topic and handles each in turn.
 
-     This slot calls take() from the DDS reader and stores the last new sample as the
-     current command value. If there were a new sample it emits commandChanged(),
-     commandNameChanged() and sendReply().
+     This slot calls take() from the DDS reader and makes each new sample the current
+     command value, in the order they were sent, emitting commandChanged() and
+     commandNameChanged() for each. With a reply topic, every command is acknowledged, and
+     the replies are written together after the last command.
   */
   void updateCommand();
   /**
-     @brief Sends a command acknowledgment on DDS
-
-     This slot is called from updateCommand().
+     @brief Sends an acknowledgment of the current command on DDS.
   */
   void sendReply();
 
 private:
+  /// Acknowledgment of a command.
+  fkin::CommandResponse reply(const fkin::Command& command) const;
+
   std::unique_ptr<sinspekto::Reader<fkin::Command>> m_reader; ///< The DDS reader wrapper class.
   std::unique_ptr<sinspekto::Writer<fkin::CommandResponse>> m_writer; ///< The DDS writer wrapper class.
   QString m_recipient; ///< Recipient identifier string.
@@ -122,6 +125,12 @@ private:
    This class is a QML element and enables QML applications to gain access to a DDS signal
    type as a read-only QML properties.
 
+   With a response topic, every sent command is kept in a table of pending requests until
+   its response arrives or its deadline passes, and each outcome is reported with
+   requestCompleted() or requestTimedOut(). Several commands can thus be outstanding at
+   once, and responses may arrive in any order. responseMessage and responseStatus follow
+   the latest outcome.
+
    @rst
    .. note ::
 
@@ -140,6 +149,7 @@ class DdsCommandPublisher : public QObject
   Q_PROPERTY(QString commandName READ commandName NOTIFY commandNameChanged) ///< Human readable command name.
   Q_PROPERTY(QString responseMessage READ responseMessage NOTIFY responseMessageChanged) ///< Response message on a command.
   Q_PROPERTY(bool responseStatus READ responseStatus NOTIFY responseStatusChanged) ///< Response status of a sent command.
+  Q_PROPERTY(int pendingRequests READ pendingRequests NOTIFY pendingRequestsChanged) ///< Number of commands awaiting a response.
 public:
   /**
      @brief Constructor
@@ -173,6 +183,27 @@ public:
      @return Response status. True is OK.
   */
   bool responseStatus() const;
+  /**
+     @brief Property accessor for the number of commands awaiting a response.
+     @return Number of pending requests.
+  */
+  int pendingRequests() const;
+  /**
+     @brief Whether a command is still awaiting its response.
+     @param[in] sequenceNr Sequence number returned by sendCommand().
+     @return True if neither a response nor a timeout has been reported.
+  */
+  Q_INVOKABLE bool isPending(int sequenceNr) const;
+  /**
+     @brief Sends a command over DDS without waiting for earlier commands.
+
+     Emits commandChanged() and commandNameChanged(). If a responseTopic is defined in
+     init(), the command is added to the pending requests, except BOGUS_COMMAND.
+
+     @param[in] command Command to send.
+     @return Sequence number of the command, or -1 if not initialized.
+  */
+  Q_INVOKABLE int sendCommand(fkin::CommandType command);
   /**
      @brief Initializes DDS writer and connects Qt signals and slots.
 
@@ -236,21 +267,41 @@ signals:
      @param[out] sequenceNr Sequence number of confirmed command.
   */
   void confirmedResponseSeqNr(int sequenceNr);
+  /**
+     @brief A pending command got its response.
+
+     @param[out] sequenceNr Sequence number of the command.
+     @param[out] success Response status.
+     @param[out] message Response message.
+  */
+  void requestCompleted(int sequenceNr, bool success, const QString& message);
+  /**
+     @brief A pending command got no response before its deadline.
+
+     @param[out] sequenceNr Sequence number of the command.
+  */
+  void requestTimedOut(int sequenceNr);
+  /**
+     @brief Number of commands awaiting a response has changed.
+
+     @param[out] count New number of pending requests.
+  */
+  void pendingRequestsChanged(int count);
 
 public slots:
   /**
      @brief Sets command and sends over DDS
 
-     Sends requested command over DDS. Emits commandChanged() and commandNameChanged().
-     If a responseTopic is defined in init(), starts the response timer.
+     Same as sendCommand(), for the QML property.
 
      @param[in] command Command to send.
   */
   void setCommand(fkin::CommandType command);
   /**
-     @brief Reads the command response from DDS.
+     @brief Reads the command responses from DDS.
 
-     If there is a response, emits confirmedResponseSeqNr()
+     Each response that matches a pending request completes it, and emits
+     requestCompleted() and confirmedResponseSeqNr(). Other responses are dropped.
   */
   void updateResponse();
   /**
@@ -271,11 +322,21 @@ public slots:
   void handleNoResponse();
 
 private:
+  /// Command awaiting its response.
+  struct PendingRequest
+  {
+    fkin::CommandType command; ///< Sent command.
+    sinspekto::TimerWheel::TimerId deadline; ///< Timer that reports the timeout.
+  };
+
+  /// Reports that a pending request got no response in time.
+  void expireRequest(std::int32_t sequenceNr);
+
   std::unique_ptr<sinspekto::Writer<fkin::Command>> m_writer; ///< The DDS writer wrapper class.
   std::unique_ptr<sinspekto::Reader<fkin::CommandResponse>> m_reader; ///< The DDS writer wrapper class.
   QString m_recipient; ///< Recipient identifier string.
   QString m_responseMessage; ///< Response message variable.
   bool m_responseStatus; ///< Response status.
-  std::int32_t m_awaitingSeqNr; ///< Sequence number of message.
-  QTimer m_timer; ///< Response timer.
+  int m_responseTimeoutMs; ///< Time to wait for each response.
+  std::unordered_map<std::int32_t, PendingRequest> m_pending; ///< Pending requests by sequence number.
 };
@@ -5,6 +5,7 @@
 */
 
 #include "sinspekto/QtToDds.hpp"
+#include "sinspekto/DdsPublisher.hpp"
 #include "QDateTime"
 
 /**
@@ -103,7 +104,7 @@ private:
    DDS signal type from a writable QML property.
 
 */
-class DdsDoublePublisher : public QObject
+class DdsDoublePublisher : public DdsPublisher
 {
   Q_OBJECT
   Q_PROPERTY(double value READ value WRITE setValue NOTIFY valueChanged) ///< DDS Real as double QML property.
@@ -164,6 +165,10 @@ public slots:
   */
   void publish();
 
+protected:
+  /// Writes the sample on DDS.
+  void writeSample() override;
+
 private:
   std::unique_ptr<sinspekto::Writer<fkin::Real>> m_writer; ///< The DDS writer wrapper class.
 };
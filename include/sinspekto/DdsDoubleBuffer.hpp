@@ -2,6 +2,7 @@
 
 #include <cinttypes>
 #include <utility>
+#include <vector>
 #include <boost/circular_buffer.hpp>
 
 #include <QAbstractSeries>
@@ -21,6 +22,32 @@ namespace sinspekto
   */
   typedef std::pair<std::pair<double, double>, std::pair<double, double>> RangeXY;
 
+  /**
+     @brief Reusable point storage for replacing the data of a QXYSeries.
+
+     QXYSeries::replace() keeps a shared copy of the given QVector until the next call to
+     replace(). Filling that same vector again would detach it and allocate. This class
+     alternates between two vectors, so the one handed out by next() is no longer
+     referenced by the series and its memory can be reused. Once both vectors have grown
+     to the buffer size, converting buffers to series points does no heap allocation.
+
+  */
+  class SeriesStaging
+  {
+  public:
+    /**
+       @brief Get the point vector to fill for the next series update.
+
+       @param[in] size Number of points needed.
+       @return Reference to a vector with size elements.
+    */
+    QVector<QPointF>& next(int size);
+
+  private:
+    QVector<QPointF> m_points[2]; ///< Alternating point vectors.
+    int m_current = 0; ///< Index of the vector last returned by next().
+  };
+
   /**
      @brief Replace data points in a QXYSeries.
 
@@ -36,6 +63,130 @@ namespace sinspekto
       boost::circular_buffer<double>& b1,
       boost::circular_buffer<double>& b2,
       QXYSeries *xySeries);
+
+  /**
+     @brief Replace data points in a QXYSeries using reusable point storage.
+
+     Same as replace_double_points() above, but the points are written to storage owned
+     by the caller, see SeriesStaging.
+
+     @param[in] b1 Buffer of real values to set.
+     @param[in] b2 Buffer of real values to set.
+     @param[in,out] xySeries QXYSeries pointer to update.
+     @param[in,out] staging Point storage reused across calls for the same series.
+     @return The ranges of each dimens (min and max values).
+  */
+  RangeXY replace_double_points(
+      boost::circular_buffer<double>& b1,
+      boost::circular_buffer<double>& b2,
+      QXYSeries *xySeries,
+      SeriesStaging& staging);
+
+  /**
+     @brief Compact quantile sketch with bounded relative error that supports removal.
+
+     Values are counted in logarithmically sized buckets, so that any quantile estimate is
+     within a relative error of the true value. Since each bucket is a plain counter,
+     values can be removed again, which makes the sketch usable for sliding windows.
+     Memory grows with the logarithm of the value range, not with the number of values.
+
+  */
+  class QuantileSketch
+  {
+  public:
+    /**
+       @brief Constructor.
+
+       @param[in] relativeAccuracy Relative error bound of quantile estimates.
+    */
+    explicit QuantileSketch(double relativeAccuracy = 0.01);
+    /// Count a value.
+    void add(double value);
+    /// Remove a value that was previously added.
+    void remove(double value);
+    /// Remove all values, keeps allocated buckets.
+    void clear();
+    /// Number of values in the sketch.
+    uint64_t count() const { return m_count; }
+    /**
+       @brief Estimate a quantile.
+
+       @param[in] q Quantile in [0, 1], e.g. 0.5 for the median.
+       @return Estimated value, NaN if the sketch is empty.
+    */
+    double quantile(double q) const;
+
+  private:
+    /// Dense bucket counters covering the bucket index range seen so far.
+    struct Store
+    {
+      std::vector<uint32_t> counts; ///< Bucket counters.
+      int offset = 0; ///< Bucket index of counts[0].
+      uint64_t total = 0; ///< Sum of counters.
+      void add(int index);
+      void remove(int index);
+    };
+
+    int index(double absValue) const;
+    double value(int index) const;
+
+    double m_gamma; ///< Bucket growth factor.
+    double m_logGamma; ///< Natural logarithm of m_gamma.
+    Store m_positive; ///< Buckets for positive values.
+    Store m_negative; ///< Buckets for absolute values of negative values.
+    uint64_t m_zeros; ///< Number of values too close to zero to be bucketed.
+    uint64_t m_count; ///< Number of values in the sketch.
+  };
+
+  /**
+     @brief Statistics over a sliding window of values with constant time updates.
+
+     Mean and variance are maintained with Welford's algorithm, extended with the inverse
+     update for removal. Minimum and maximum are kept in monotonic queues, and quantiles are
+     estimated with a QuantileSketch. Values must be removed in the same order as they
+     were added, which is how a circular buffer evicts them. NaN and infinite values are
+     ignored, both when added and when removed, so the statistics cover the finite values
+     in the window.
+
+  */
+  class RollingStatistics
+  {
+  public:
+    /**
+       @brief Constructor.
+
+       @param[in] capacity Maximum number of values in the window.
+    */
+    explicit RollingStatistics(int capacity = 0);
+    /// Set maximum window length and clear statistics.
+    void setCapacity(int capacity);
+    /// Add a value to the window.
+    void add(double value);
+    /// Remove the oldest value from the window, must equal the value added first.
+    void removeOldest(double value);
+    /// Clear statistics.
+    void clear();
+    /// Number of finite values in window.
+    uint64_t count() const { return m_count; }
+    /// Mean value, NaN if empty.
+    double mean() const;
+    /// Sample standard deviation, NaN if less than two values.
+    double stddev() const;
+    /// Minimum value, NaN if empty.
+    double minimum() const;
+    /// Maximum value, NaN if empty.
+    double maximum() const;
+    /// Estimated quantile, q in [0, 1], NaN if empty.
+    double quantile(double q) const;
+
+  private:
+    uint64_t m_count; ///< Number of values.
+    double m_mean; ///< Running mean.
+    double m_m2; ///< Running sum of squared differences from the mean.
+    boost::circular_buffer<double> m_minQueue; ///< Non-decreasing candidates for minimum.
+    boost::circular_buffer<double> m_maxQueue; ///< Non-increasing candidates for maximum.
+    QuantileSketch m_sketch; ///< Quantile estimator.
+  };
 }
 
 /**
@@ -45,13 +196,27 @@ namespace sinspekto
    QPointF Qt data type is used for the data range. This makes it available in QML and
    compatible with e.g. QtChart.
 
-   @note This class is not currently exposed as a QML element, but rather used by DdsBuffer.
+   Optionally, the buffer maintains rolling statistics of the values currently in the
+   circular buffer. These are updated in constant time as values are appended and evicted,
+   see sinspekto::RollingStatistics. Statistics are disabled by default and are enabled
+   with the statistics property.
+
+   @note This class is not creatable in QML, but is used by DdsBuffer. An instance for a
+   given dimension is available in QML with DdsBuffer::dimension().
 
 */
 class DdsDoubleBuffer : public QObject
 {
   Q_OBJECT
   Q_PROPERTY(QPointF range READ range NOTIFY rangeChanged) ///< The value range in the buffer
+  Q_PROPERTY(bool statistics READ statistics WRITE setStatistics NOTIFY statisticsEnabledChanged) ///< Maintain rolling statistics.
+  Q_PROPERTY(double mean READ mean NOTIFY statisticsChanged) ///< Mean of buffered values.
+  Q_PROPERTY(double stddev READ stddev NOTIFY statisticsChanged) ///< Sample standard deviation of buffered values.
+  Q_PROPERTY(double minimum READ minimum NOTIFY statisticsChanged) ///< Minimum of buffered values.
+  Q_PROPERTY(double maximum READ maximum NOTIFY statisticsChanged) ///< Maximum of buffered values.
+  Q_PROPERTY(double median READ median NOTIFY statisticsChanged) ///< Estimated median of buffered values.
+  Q_PROPERTY(QList<qreal> quantileLevels READ quantileLevels WRITE setQuantileLevels NOTIFY quantileLevelsChanged) ///< Quantile levels in [0, 1] to estimate.
+  Q_PROPERTY(QList<qreal> quantiles READ quantiles NOTIFY statisticsChanged) ///< Estimated quantiles for quantileLevels.
 
 public:
   /**
@@ -80,12 +245,69 @@ public:
      @return Reference to the circular buffer.
   */
   boost::circular_buffer<double>& Buffer() { return m_buffer; }
+  /// Read-only access to the circular buffer.
+  const boost::circular_buffer<double>& Buffer() const { return m_buffer; }
+  /**
+     @brief Append a value to the circular buffer.
+
+     If statistics are enabled, the evicted value, if any, and the new value are
+     accounted for. Use this function rather than Buffer().push_back() to keep the
+     statistics consistent.
+
+     @param[in] value Value to append.
+  */
+  void append(double value);
+  /**
+     @brief Remove all values and reset statistics.
+  */
+  void clear();
+
+  /// Property accessor for whether statistics are maintained.
+  bool statistics() const;
+  /// Property accessor for mean value.
+  double mean() const;
+  /// Property accessor for standard deviation.
+  double stddev() const;
+  /// Property accessor for minimum value.
+  double minimum() const;
+  /// Property accessor for maximum value.
+  double maximum() const;
+  /// Property accessor for median value.
+  double median() const;
+  /// Property accessor for quantile levels.
+  QList<qreal> quantileLevels() const;
+  /// Property accessor for quantiles at quantileLevels.
+  QList<qreal> quantiles() const;
+  /**
+     @brief Estimate a quantile of the buffered values.
+
+     @param[in] q Quantile in [0, 1].
+     @return Estimated quantile, NaN if statistics are disabled or buffer is empty.
+  */
+  Q_INVOKABLE double quantile(double q) const;
 
 signals:
   /**
      @brief Signal to indicate that data range has changed.
   */
   void rangeChanged(QPointF range);
+  /**
+     @brief Signal to indicate that statistics have been enabled or disabled.
+
+     @param[out] enabled Whether statistics are maintained.
+  */
+  void statisticsEnabledChanged(bool enabled);
+  /**
+     @brief Signal to indicate that the statistics have changed.
+
+     Emitted at most once per Qt event loop iteration, regardless of how many values were
+     appended.
+  */
+  void statisticsChanged();
+  /**
+     @brief Signal to indicate that quantile levels have changed.
+  */
+  void quantileLevelsChanged();
 
 public slots:
   /**
@@ -99,8 +321,29 @@ public slots:
 
   */
   void updateRange(double min, double max);
+  /**
+     @brief Enable or disable rolling statistics.
+
+     When enabled, the statistics are initialized from the values already in the buffer.
+
+     @param[in] enabled Whether to maintain statistics.
+  */
+  void setStatistics(bool enabled);
+  /**
+     @brief Set the quantile levels used for the quantiles property.
+
+     @param[in] levels Quantile levels in [0, 1].
+  */
+  void setQuantileLevels(const QList<qreal>& levels);
 
 private:
+  /// Schedule a single statisticsChanged() for the current event loop iteration.
+  void notifyStatistics();
+
   boost::circular_buffer<double> m_buffer; ///< A ring buffer with time points, held as double.
   QPointF m_range; ///< Data range of buffer. QPointF.x() is minimum, QPoint.y() is maximum.
+  bool m_statisticsEnabled; ///< Whether statistics are maintained.
+  bool m_statisticsPending; ///< Whether statisticsChanged() is scheduled.
+  sinspekto::RollingStatistics m_statistics; ///< Rolling statistics of the buffered values.
+  QList<qreal> m_quantileLevels; ///< Quantile levels for the quantiles property.
 };
@@ -5,6 +5,7 @@
 */
 
 #include "sinspekto/QtToDds.hpp"
+#include "sinspekto/DdsPublisher.hpp"
 #include "QDateTime"
 
 /**
@@ -104,7 +105,7 @@ private:
    This class is a QML element and enables QML applications to publish a
    DDS signal type from a writable QML property.
 */
-class DdsIdVec1dPublisher : public QObject
+class DdsIdVec1dPublisher : public DdsPublisher
 {
   Q_OBJECT
   Q_PROPERTY(double value READ value WRITE setValue NOTIFY valueChanged) ///< DDS 1d-vector as double QML property.
@@ -174,6 +175,71 @@ public slots:
   void publish();
 
 
+protected:
+  /// Writes the sample on DDS.
+  void writeSample() override;
+
 private:
   std::unique_ptr<sinspekto::Writer<fkin::IdVec1d>> m_writer; ///< The DDS writer wrapper class.
 };
+
+/**
+   @brief Batch publisher for DDS type BatchIdVec1d as a QML element.
+
+   Appended samples are timestamped and written together as one BatchIdVec1d sample,
+   see DdsBatchPublisher for when the batch is written. The batch can be read with a
+   DdsIdVec1dBuffer initialized with use_batch.
+*/
+class DdsBatchIdVec1dPublisher : public DdsBatchPublisher
+{
+  Q_OBJECT
+
+public:
+  /**
+     @brief Constructor
+
+     The initialization is deferred to an init() function.
+
+     @param[in] parent QObject pointer.
+  */
+  explicit DdsBatchIdVec1dPublisher(QObject *parent = nullptr);
+  /**
+     @brief Destructor.
+  */
+  virtual ~DdsBatchIdVec1dPublisher();
+
+  /**
+     @brief Initializes DDS writer.
+
+     @param[in] dds Pointer to QtToDds instance.
+     @param[in] topic Name of DDS topic to publish.
+     @param[in] id Key identifier for the topic instance.
+  */
+  Q_INVOKABLE void init(
+      QtToDds* dds,
+      const QString& topic,
+      const QString& id);
+  /**
+     @brief Append a sample timestamped with the current time.
+     @param[in] value Value of the sample.
+  */
+  Q_INVOKABLE void append(double value);
+  /**
+     @brief Append a sample with a given timestamp.
+     @param[in] value Value of the sample.
+     @param[in] timestamp Time of the sample.
+  */
+  Q_INVOKABLE void append(double value, const QDateTime& timestamp);
+  /// Number of samples waiting to be written.
+  int batchSize() const override;
+
+protected:
+  /// Writes the batch on DDS, and clears it unless it must be retried.
+  void writeSample() override;
+
+private:
+  /// Append a sample to the batch.
+  void appendAt(double value, int64_t unix_millis);
+
+  std::unique_ptr<sinspekto::Writer<fkin::BatchIdVec1d>> m_writer; ///< The DDS writer wrapper class.
+};
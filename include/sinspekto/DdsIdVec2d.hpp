@@ -5,6 +5,7 @@
 */
 
 #include "sinspekto/QtToDds.hpp"
+#include "sinspekto/DdsPublisher.hpp"
 #include "QDateTime"
 #include "QVector2D"
 
@@ -107,7 +108,7 @@ private:
    DDS signal type from a writable QML property.
 
 */
-class DdsIdVec2dPublisher : public QObject
+class DdsIdVec2dPublisher : public DdsPublisher
 {
   Q_OBJECT
   Q_PROPERTY(QVector2D value READ value WRITE setValue NOTIFY valueChanged) ///< DDS 2d-vector as QVector2D QML property.
@@ -176,6 +177,10 @@ public slots:
   */
   void publish();
 
+protected:
+  /// Writes the sample on DDS.
+  void writeSample() override;
+
 private:
   std::unique_ptr<sinspekto::Writer<fkin::IdVec2d>> m_writer; ///< The DDS writer wrapper class.
 };
@@ -5,6 +5,7 @@
 */
 
 #include "sinspekto/QtToDds.hpp"
+#include "sinspekto/DdsPublisher.hpp"
 #include "QDateTime"
 #include "QVector3D"
 
@@ -107,7 +108,7 @@ private:
    DDS signal type from a writable QML property.
 
 */
-class DdsIdVec3dPublisher : public QObject
+class DdsIdVec3dPublisher : public DdsPublisher
 {
   Q_OBJECT
   Q_PROPERTY(QVector3D value READ value WRITE setValue NOTIFY valueChanged) ///< DDS 3d-vector as QVector3D QML property.
@@ -175,6 +176,10 @@ public slots:
   */
   void publish();
 
+protected:
+  /// Writes the sample on DDS.
+  void writeSample() override;
+
 private:
   std::unique_ptr<sinspekto::Writer<fkin::IdVec3d>> m_writer; ///< The DDS writer wrapper class.
 };
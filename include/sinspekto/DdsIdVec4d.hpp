@@ -5,6 +5,7 @@
 */
 
 #include "sinspekto/QtToDds.hpp"
+#include "sinspekto/DdsPublisher.hpp"
 #include "QDateTime"
 #include "QVector4D"
 
@@ -104,7 +105,7 @@ private:
    This class is a QML element and enables QML applications to publish a
    DDS signal type from a writable QML property.
 */
-class DdsIdVec4dPublisher : public QObject
+class DdsIdVec4dPublisher : public DdsPublisher
 {
   Q_OBJECT
   Q_PROPERTY(QVector4D value READ value WRITE setValue NOTIFY valueChanged) ///< DDS 4d-vector as QVector4D QML property.
@@ -172,6 +173,10 @@ public slots:
   */
   void publish();
 
+protected:
+  /// Writes the sample on DDS.
+  void writeSample() override;
+
 private:
   std::unique_ptr<sinspekto::Writer<fkin::IdVec4d>> m_writer; ///< The DDS writer wrapper class.
 };
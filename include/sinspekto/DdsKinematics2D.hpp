@@ -5,6 +5,7 @@
 */
 
 #include "sinspekto/QtToDds.hpp"
+#include "sinspekto/DdsPublisher.hpp"
 #include "QDateTime"
 #include "QVector2D"
 
@@ -132,7 +133,7 @@ private:
    This class is a QML element and enables QML applications to publish a
    DDS signal type from a writable QML property.
 */
-class DdsKinematics2DPublisher : public QObject
+class DdsKinematics2DPublisher : public DdsPublisher
 {
   Q_OBJECT
   Q_PROPERTY(QVector2D position READ position WRITE setPosition NOTIFY positionChanged) ///< 2D position as QVector2D QML property.
@@ -212,7 +213,7 @@ public slots:
      This slot updates the DDS sample with the new position. It emits a positionChanged().
 
      @note It only emits a signal if the QML property value has changed!
-     @note This function does not publish the DDS sample. sendSample() must be called.
+     @note This function does not publish the DDS sample. publish() or commit() must be called.
 
      @param[in] position New vector value.
   */
@@ -223,7 +224,7 @@ public slots:
      This slot updates the DDS sample with the new speed. It emits a speedChanged().
 
      @note It only emits a signal if the QML property value has changed!
-     @note This function does not publish the DDS sample. sendSample() must be called.
+     @note This function does not publish the DDS sample. publish() or commit() must be called.
 
      @param[in] speed New speed value.
   */
@@ -234,7 +235,7 @@ public slots:
      This slot updates the DDS sample with the new course. It emits a courseChanged().
 
      @note It only emits a signal if the QML property value has changed!
-     @note This function does not publish the DDS sample. sendSample() must be called.
+     @note This function does not publish the DDS sample. publish() or commit() must be called.
 
      @param[in] course New course value.
   */
@@ -248,6 +249,75 @@ public slots:
   */
   void publish();
 
+protected:
+  /// Writes the sample on DDS.
+  void writeSample() override;
+
 private:
   std::unique_ptr<sinspekto::Writer<fkin::Kinematics2D>> m_writer; ///< The DDS writer wrapper class.
 };
+
+/**
+   @brief Batch publisher for DDS type BatchKinematics2D as a QML element.
+
+   Appended samples are timestamped and written together as one BatchKinematics2D sample,
+   see DdsBatchPublisher for when the batch is written. The batch can be read with a
+   DdsKinematics2DBuffer initialized with use_batch.
+*/
+class DdsBatchKinematics2DPublisher : public DdsBatchPublisher
+{
+  Q_OBJECT
+
+public:
+  /**
+     @brief Constructor
+
+     The initialization is deferred to an init() function.
+
+     @param[in] parent QObject pointer.
+  */
+  explicit DdsBatchKinematics2DPublisher(QObject *parent = nullptr);
+  /**
+     @brief Destructor.
+  */
+  virtual ~DdsBatchKinematics2DPublisher();
+
+  /**
+     @brief Initializes DDS writer.
+
+     @param[in] dds Pointer to QtToDds instance.
+     @param[in] topic Name of DDS topic to publish.
+     @param[in] id Key identifier for the topic instance.
+  */
+  Q_INVOKABLE void init(
+      QtToDds* dds,
+      const QString& topic,
+      const QString& id);
+  /**
+     @brief Append a sample timestamped with the current time.
+     @param[in] position 2D position.
+     @param[in] speed Speed.
+     @param[in] course Course.
+  */
+  Q_INVOKABLE void append(QVector2D position, double speed, double course);
+  /**
+     @brief Append a sample with a given timestamp.
+     @param[in] position 2D position.
+     @param[in] speed Speed.
+     @param[in] course Course.
+     @param[in] timestamp Time of the sample.
+  */
+  Q_INVOKABLE void append(QVector2D position, double speed, double course, const QDateTime& timestamp);
+  /// Number of samples waiting to be written.
+  int batchSize() const override;
+
+protected:
+  /// Writes the batch on DDS, and clears it unless it must be retried.
+  void writeSample() override;
+
+private:
+  /// Append a sample to the batch.
+  void appendAt(QVector2D position, double speed, double course, int64_t unix_millis);
+
+  std::unique_ptr<sinspekto::Writer<fkin::BatchKinematics2D>> m_writer; ///< The DDS writer wrapper class.
+};
@@ -5,6 +5,7 @@
 */
 
 #include "sinspekto/QtToDds.hpp"
+#include "sinspekto/DdsPublisher.hpp"
 #include "QDateTime"
 #include "QVector3D"
 
@@ -136,7 +137,7 @@ private:
    This class is a QML element and enables QML applications to publish a
    DDS signal type from a writable QML property.
 */
-class DdsKinematics6DPublisher : public QObject
+class DdsKinematics6DPublisher : public DdsPublisher
 {
   Q_OBJECT
   /// 3D position as QVector3D QML property.
@@ -219,7 +220,7 @@ public slots:
      This slot updates the DDS sample with the new position. It emits a positionChanged().
 
      @note It only emits a signal if the QML property value has changed!
-     @note This function does not publish the DDS sample. sendSample() must be called.
+     @note This function does not publish the DDS sample. publish() or commit() must be called.
 
      @param[in] position New vector value.
   */
@@ -230,7 +231,7 @@ public slots:
      This slot updates the DDS sample with the new velocity. It emits a velocityChanged().
 
      @note It only emits a signal if the QML property value has changed!
-     @note This function does not publish the DDS sample. sendSample() must be called.
+     @note This function does not publish the DDS sample. publish() or commit() must be called.
 
      @param[in] velocity New vector value.
   */
@@ -241,7 +242,7 @@ public slots:
      This slot updates the DDS sample with the new euler. It emits a eulerChanged().
 
      @note It only emits a signal if the QML property value has changed!
-     @note This function does not publish the DDS sample. sendSample() must be called.
+     @note This function does not publish the DDS sample. publish() or commit() must be called.
 
      @param[in] euler New vector value.
   */
@@ -255,6 +256,75 @@ public slots:
   */
   void publish();
 
+protected:
+  /// Writes the sample on DDS.
+  void writeSample() override;
+
 private:
   std::unique_ptr<sinspekto::Writer<fkin::Kinematics6D>> m_writer; ///< The DDS writer wrapper class.
 };
+
+/**
+   @brief Batch publisher for DDS type BatchKinematics6D as a QML element.
+
+   Appended samples are timestamped and written together as one BatchKinematics6D sample,
+   see DdsBatchPublisher for when the batch is written. The batch can be read with a
+   DdsKinematics6DBuffer initialized with use_batch.
+*/
+class DdsBatchKinematics6DPublisher : public DdsBatchPublisher
+{
+  Q_OBJECT
+
+public:
+  /**
+     @brief Constructor
+
+     The initialization is deferred to an init() function.
+
+     @param[in] parent QObject pointer.
+  */
+  explicit DdsBatchKinematics6DPublisher(QObject *parent = nullptr);
+  /**
+     @brief Destructor.
+  */
+  virtual ~DdsBatchKinematics6DPublisher();
+
+  /**
+     @brief Initializes DDS writer.
+
+     @param[in] dds Pointer to QtToDds instance.
+     @param[in] topic Name of DDS topic to publish.
+     @param[in] id Key identifier for the topic instance.
+  */
+  Q_INVOKABLE void init(
+      QtToDds* dds,
+      const QString& topic,
+      const QString& id);
+  /**
+     @brief Append a sample timestamped with the current time.
+     @param[in] position 3D position.
+     @param[in] velocity 3D velocity.
+     @param[in] euler 3D euler angles.
+  */
+  Q_INVOKABLE void append(QVector3D position, QVector3D velocity, QVector3D euler);
+  /**
+     @brief Append a sample with a given timestamp.
+     @param[in] position 3D position.
+     @param[in] velocity 3D velocity.
+     @param[in] euler 3D euler angles.
+     @param[in] timestamp Time of the sample.
+  */
+  Q_INVOKABLE void append(QVector3D position, QVector3D velocity, QVector3D euler, const QDateTime& timestamp);
+  /// Number of samples waiting to be written.
+  int batchSize() const override;
+
+protected:
+  /// Writes the batch on DDS, and clears it unless it must be retried.
+  void writeSample() override;
+
+private:
+  /// Append a sample to the batch.
+  void appendAt(QVector3D position, QVector3D velocity, QVector3D euler, int64_t unix_millis);
+
+  std::unique_ptr<sinspekto::Writer<fkin::BatchKinematics6D>> m_writer; ///< The DDS writer wrapper class.
+};
@@ -0,0 +1,185 @@
+#pragma once
+/**
+   @file DdsLatencyTrace.hpp
+   @brief Latency of DDS samples from their source timestamp to the presented frame.
+*/
+
+#include <array>
+#include <atomic>
+#include <cinttypes>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVariantMap>
+
+#include "sinspekto/LogHistogram.hpp"
+
+class QQuickWindow;
+
+/**
+   @brief Collects per-topic latency histograms of the stages between DDS and the screen.
+
+   When enabled, each group of samples that a DdsBuffer drains in one go is stamped with
+   the source timestamp of its newest sample, the reception by the DDS listener, the
+   dispatch on the Qt event loop and the end of the append to the buffers. The oldest
+   group that has not been shown yet is additionally stamped when a series is updated
+   from the buffer, and completed by the next frameSwapped() of a watched window. The
+   intervals between the stamps are collected in histograms per topic:
+
+   \rst
+   .. table::
+
+     +--------------+-----------------------------------------------+
+     | Stage        | Interval                                      |
+     +--------------+-----------------------------------------------+
+     | ``delivery`` | source timestamp to DDS listener              |
+     +--------------+-----------------------------------------------+
+     | ``queue``    | DDS listener to dispatch on the Qt event loop |
+     +--------------+-----------------------------------------------+
+     | ``append``   | dispatch to samples appended to the buffers   |
+     +--------------+-----------------------------------------------+
+     | ``upload``   | appended to series updated from the buffer    |
+     +--------------+-----------------------------------------------+
+     | ``render``   | series updated to next frame swapped          |
+     +--------------+-----------------------------------------------+
+     | ``total``    | source timestamp to next frame swapped        |
+     +--------------+-----------------------------------------------+
+
+   .. code-block:: qml
+
+     Component.onCompleted: DdsLatencyTrace.enabled = true;
+     Label { text: "p99 " + DdsLatencyTrace.summary("fkinKinematics").total.p99 + " ms"; }
+     Button { onClicked: DdsLatencyTrace.dump("/tmp/latency.json"); }
+
+   \endrst
+
+   Tracing is disabled by default, and then costs a relaxed atomic load per drain. The
+   delivery stage compares clocks of two hosts when the publisher is remote, so it
+   includes their offset. Negative intervals are recorded as 0.
+
+   Groups are only kept for the render and total stages while a window is watched, and
+   at most max_waiting of them wait for a frame, the oldest are dropped beyond that.
+
+   @note Buffers polled by a QML Timer are only traced if the timer calls
+   DdsBuffer::drain() instead of DdsBuffer::updateBuffers(), and have no delivery and
+   queue stages.
+*/
+class DdsLatencyTrace : public QObject
+{
+  Q_OBJECT
+  Q_PROPERTY(bool enabled READ enabled WRITE setEnabled NOTIFY enabledChanged) ///< Stamp drained samples.
+  Q_PROPERTY(QStringList topics READ topics NOTIFY topicsChanged) ///< Topics with recorded latencies.
+
+public:
+  /// Stamps of a group of samples, microseconds since epoch, 0 if not stamped.
+  struct Group
+  {
+    int64_t source = 0; ///< Source timestamp of the newest sample.
+    int64_t received = 0; ///< DDS listener was called.
+    int64_t dispatched = 0; ///< Drain started on the Qt event loop.
+    int64_t appended = 0; ///< Samples were appended to the buffers.
+    int64_t uploaded = 0; ///< A series was updated from the buffer.
+  };
+
+  /// Latency trace shared by the library, also the QML singleton.
+  static DdsLatencyTrace& instance();
+  /// Whether tracing is enabled, cheap enough for every drain.
+  static bool active() { return s_active.load(std::memory_order_relaxed); }
+  /// Current time in microseconds since epoch.
+  static int64_t nowMicros();
+
+  /// Property accessor for enabled.
+  bool enabled() const;
+  /**
+     @brief Switch tracing on or off.
+
+     Switching on watches the frames of all Qt Quick windows that exist at the time, and
+     of those shown while enabled, see watchWindow(). Recorded histograms are kept when
+     switched off, groups waiting for a frame are dropped.
+
+     @param[in] enabled True to stamp drained samples.
+  */
+  void setEnabled(bool enabled);
+  /// Property accessor for the topics with recorded latencies.
+  QStringList topics() const;
+
+  /**
+     @brief Complete traces on the frames of a window, e.g. one never shown while enabled.
+     @param[in] window Window that shows series of traced buffers.
+  */
+  Q_INVOKABLE void watchWindow(QQuickWindow *window);
+  /**
+     @brief Latency statistics of a topic.
+
+     @param[in] topic Topic name.
+     @return Map from stage name to a map with count, mean, p50, p90, p99 and max, all in
+     milliseconds except count. Empty if the topic has no recorded latencies.
+  */
+  Q_INVOKABLE QVariantMap summary(const QString& topic) const;
+  /**
+     @brief Write the statistics of all topics as JSON.
+
+     The file holds an object with the topics as keys and summary() as values.
+
+     @param[in] fileName Output file, overwritten.
+     @return False if the file could not be written.
+  */
+  Q_INVOKABLE bool dump(const QString& fileName) const;
+  /// Forget all recorded latencies.
+  Q_INVOKABLE void reset();
+
+  /**
+     @brief Record the stages up to the append of a drained group.
+     @param[in] topic Topic of the buffer.
+     @param[in] group Stamps up to Group::appended.
+  */
+  void drained(const QString& topic, const Group& group);
+  /**
+     @brief Record the upload stage of a group, and complete it on the next frame.
+     @param[in] topic Topic of the buffer.
+     @param[in] group Stamps up to Group::uploaded.
+  */
+  void uploaded(const QString& topic, const Group& group);
+
+signals:
+  /**
+     @brief Tracing has been switched on or off.
+     @param[out] enabled New setting.
+  */
+  void enabledChanged(bool enabled);
+  /**
+     @brief A topic was recorded for the first time, or the topics were reset.
+  */
+  void topicsChanged();
+
+protected:
+  /// Watch Qt Quick windows that are shown while enabled.
+  bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+  /// Stages in the order of the table above.
+  enum Stage { Delivery, Queue, Append, Upload, Render, Total, StageCount };
+
+  /// Histograms of microseconds per stage.
+  typedef std::array<sinspekto::LogHistogram, StageCount> Stages;
+
+  explicit DdsLatencyTrace(QObject *parent = nullptr);
+  /// Record an interval, if both stamps were taken. Requires m_mutex.
+  static void record(Stages& stages, Stage stage, int64_t from, int64_t to);
+  /// Histograms of a topic, created on first use. Requires m_mutex.
+  Stages& stages(const QString& topic, bool& created);
+  /// Complete the uploaded groups, called on the render thread with threaded rendering.
+  void frameSwapped();
+
+  static constexpr size_t max_waiting = 1024; ///< Bound of m_uploaded.
+
+  static std::atomic<bool> s_active; ///< Tracing is enabled.
+  mutable std::mutex m_mutex; ///< Guards the members below, frames come from the render thread.
+  std::map<QString, Stages> m_topics; ///< Histograms per topic.
+  std::deque<std::pair<QString, Group>> m_uploaded; ///< Groups waiting for the next frame.
+  QSet<QObject *> m_windows; ///< Watched windows, series may be uploaded on the render thread.
+};
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <vector>
+#include <QColor>
+#include <QPointF>
+#include <QQuickItem>
+
+#include "sinspekto/QtToDds.hpp"
+#include "sinspekto/DdsBuffer.hpp"
+
+/**
+   @brief Line series item that draws a DdsBuffer directly in the Qt Quick scene graph
+
+   This is an alternative to a QtCharts LineSeries updated with DdsBuffer::updateSeries(),
+   for plots with many points or high sample rates. Only the samples appended since the
+   last frame are converted and uploaded, while the mapping from data to item coordinates
+   is applied as a transform. Changing the visible range, e.g. scrolling a time axis, does
+   therefore not touch the vertex data.
+
+   The vertices are kept relative to an origin close to the data, such that single
+   precision is sufficient also for time stamps in milliseconds since epoch.
+
+   The item is drawn with OpenGL when available, and with QPainter when the scene graph
+   uses the software backend. It clips to its bounds, so it is usually anchored to the plot
+   area of a chart with matching axes.
+
+   \rst
+   .. code-block:: qml
+
+     DdsLineSeries {
+       anchors.fill: chart.plotArea
+       source: ddsBuffer
+       xDim: FKIN.T
+       yDim: FKIN.X
+       minX: timeAxis.min.getTime()
+       maxX: timeAxis.max.getTime()
+       minY: valueAxis.min
+       maxY: valueAxis.max
+       color: "steelblue"
+     }
+
+   \endrst
+
+   @note The buffer must be initialized with DdsBuffer::init() before it is set as source.
+*/
+class DdsLineSeries : public QQuickItem
+{
+  Q_OBJECT
+  Q_PROPERTY(DdsBuffer* source READ source WRITE setSource NOTIFY sourceChanged) ///< Buffer to draw from.
+  Q_PROPERTY(qml_enums::DimId xDim READ xDim WRITE setXDim NOTIFY xDimChanged) ///< Dimension along x, may be DimId::T.
+  Q_PROPERTY(qml_enums::DimId yDim READ yDim WRITE setYDim NOTIFY yDimChanged) ///< Dimension along y, may be DimId::T.
+  Q_PROPERTY(double minX READ minX WRITE setMinX NOTIFY rangeChanged) ///< Data value at the left edge.
+  Q_PROPERTY(double maxX READ maxX WRITE setMaxX NOTIFY rangeChanged) ///< Data value at the right edge.
+  Q_PROPERTY(double minY READ minY WRITE setMinY NOTIFY rangeChanged) ///< Data value at the bottom edge.
+  Q_PROPERTY(double maxY READ maxY WRITE setMaxY NOTIFY rangeChanged) ///< Data value at the top edge.
+  Q_PROPERTY(QColor color READ color WRITE setColor NOTIFY colorChanged) ///< Line color.
+  Q_PROPERTY(qreal lineWidth READ lineWidth WRITE setLineWidth NOTIFY lineWidthChanged) ///< Line width in pixels.
+
+ public:
+  /**
+     @brief Constructor
+
+     @param [in] parent QQuickItem pointer.
+  */
+  explicit DdsLineSeries(QQuickItem *parent = nullptr);
+  /**
+     @brief Destructor
+  */
+  virtual ~DdsLineSeries();
+
+  DdsBuffer* source() const { return m_source; } ///< Access function for source.
+  void setSource(DdsBuffer *source); ///< Set source buffer.
+  qml_enums::DimId xDim() const { return m_xDim; } ///< Access function for x dimension.
+  void setXDim(qml_enums::DimId dim); ///< Set x dimension.
+  qml_enums::DimId yDim() const { return m_yDim; } ///< Access function for y dimension.
+  void setYDim(qml_enums::DimId dim); ///< Set y dimension.
+  double minX() const { return m_minX; } ///< Access function for left edge value.
+  void setMinX(double value); ///< Set left edge value.
+  double maxX() const { return m_maxX; } ///< Access function for right edge value.
+  void setMaxX(double value); ///< Set right edge value.
+  double minY() const { return m_minY; } ///< Access function for bottom edge value.
+  void setMinY(double value); ///< Set bottom edge value.
+  double maxY() const { return m_maxY; } ///< Access function for top edge value.
+  void setMaxY(double value); ///< Set top edge value.
+  QColor color() const { return m_color; } ///< Access function for line color.
+  void setColor(const QColor& color); ///< Set line color.
+  qreal lineWidth() const { return m_lineWidth; } ///< Access function for line width.
+  void setLineWidth(qreal width); ///< Set line width.
+
+signals:
+  void sourceChanged(); ///< Signal when source has changed.
+  void xDimChanged(); ///< Signal when x dimension has changed.
+  void yDimChanged(); ///< Signal when y dimension has changed.
+  void rangeChanged(); ///< Signal when any of the range limits has changed.
+  void colorChanged(); ///< Signal when color has changed.
+  void lineWidthChanged(); ///< Signal when line width has changed.
+
+protected:
+  /**
+     @brief Create or update the scene graph nodes, called on the render thread.
+
+     The GUI thread is blocked while this runs, so the item's members can be read.
+  */
+  QSGNode *updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *) override;
+
+private slots:
+  /**
+     @brief Read the samples appended to the source since the last call.
+  */
+  void sourceUpdated();
+  /**
+     @brief Forget the source when it is destroyed.
+  */
+  void sourceDestroyed();
+
+private:
+  /**
+     @brief Read all samples from the source, and mark all vertices to be updated.
+  */
+  void rebuild();
+  /**
+     @brief Look up the buffers of both dimensions in the source.
+
+     Called when the source or a dimension changes, such that a missing dimension is
+     reported once rather than on every update.
+  */
+  void resolveDims();
+  /**
+     @brief Value of a dimension in the source.
+
+     @param[in] dim Buffer of the dimension, nullptr gives the time points.
+     @param[in] index Index in the source buffers, 0 is the oldest sample.
+     @return The value.
+  */
+  double sample(const DdsDoubleBuffer *dim, size_t index) const;
+
+  DdsBuffer *m_source; ///< Buffer to draw from, not owned.
+  qml_enums::DimId m_xDim; ///< Dimension along x.
+  qml_enums::DimId m_yDim; ///< Dimension along y.
+  const DdsDoubleBuffer *m_xBuffer; ///< Buffer of m_xDim in the source, nullptr for DimId::T.
+  const DdsDoubleBuffer *m_yBuffer; ///< Buffer of m_yDim in the source, nullptr for DimId::T.
+  bool m_validDims; ///< Both dimensions exist in the source.
+  double m_minX; ///< Data value at left edge.
+  double m_maxX; ///< Data value at right edge.
+  double m_minY; ///< Data value at bottom edge.
+  double m_maxY; ///< Data value at top edge.
+  QColor m_color; ///< Line color.
+  qreal m_lineWidth; ///< Line width.
+
+  std::vector<QPointF> m_points; ///< Ring of samples relative to m_origin, sample n in slot n % capacity.
+  QPointF m_origin; ///< Origin of the vertex coordinates in data space.
+  uint64_t m_appended; ///< Number of samples read from the source since it was cleared.
+  uint64_t m_first; ///< Sample number of the oldest sample in m_points.
+  uint64_t m_dirtyFrom; ///< Sample number of the oldest sample not yet given to the scene graph.
+  bool m_rebuildNodes; ///< All vertices must be updated, e.g. after a change of source or capacity.
+};
@@ -0,0 +1,321 @@
+#pragma once
+/**
+   @file DdsPublisher.hpp
+   @brief Common base of the QML publisher elements.
+*/
+
+#include <atomic>
+#include <cinttypes>
+#include <functional>
+#include <memory>
+#include <QObject>
+#include <QTimer>
+
+/**
+   @brief Base class of publishers, controls when samples are written.
+
+   Derived publishers modify their DDS sample and call requestWrite(). With the default
+   maxRateHz of 0 the sample is written immediately. With a positive maxRateHz, changes
+   that come faster than the rate are collapsed into the latest sample, which is written
+   from the shared sinspekto::TimerWheel as soon as the rate allows. The latest value is
+   thus always sent, while a QML Slider bound to a publisher produces at most maxRateHz
+   writes per second while dragged.
+
+   \rst
+   .. code-block:: qml
+
+     DdsDoublePublisher {
+       id: ddsSetpoint;
+       maxRateHz: 20;
+       value: slider.value;
+     }
+
+   \endrst
+
+   Several changes can be combined into one sample with beginUpdate() and commit(). Within
+   an update, changes are only collected, and commit() writes one sample if anything
+   changed. This also applies to publishers whose setters do not write by themselves, such
+   as DdsKinematics2DPublisher.
+
+   \rst
+   .. code-block:: qml
+
+     ddsKinematics.beginUpdate();
+     ddsKinematics.position = Qt.vector2d(north, east);
+     ddsKinematics.course = course;
+     ddsKinematics.speed = speed;
+     ddsKinematics.commit(); // one write
+
+   \endrst
+
+   With asyncWrite set, the DDS write is carried out by a writer thread shared by all
+   publishers, so that a slow reliable reader cannot block the GUI thread. The samples are
+   handed over through a bounded lock-free queue, see sinspekto::MpscQueue. When the queue,
+   or this publisher's share of it given by maxQueuedWrites, is full, the write is retried
+   as a pending write and congested is set until a write gets through again. Switching
+   asyncWrite off clears congested.
+
+   @note A sample that is pending when the publisher is destroyed is not written.
+*/
+class DdsPublisher : public QObject
+{
+  Q_OBJECT
+  Q_PROPERTY(double maxRateHz READ maxRateHz WRITE setMaxRateHz NOTIFY maxRateHzChanged) ///< Maximal write rate, 0 is unlimited.
+  Q_PROPERTY(bool asyncWrite READ asyncWrite WRITE setAsyncWrite NOTIFY asyncWriteChanged) ///< Write on the shared writer thread.
+  Q_PROPERTY(int maxQueuedWrites READ maxQueuedWrites WRITE setMaxQueuedWrites NOTIFY maxQueuedWritesChanged) ///< Limit of queued writes of this publisher.
+  Q_PROPERTY(bool congested READ congested NOTIFY congestedChanged) ///< The last asynchronous write could not be queued.
+
+public:
+  /**
+     @brief Constructor
+     @param[in] parent QObject pointer.
+  */
+  explicit DdsPublisher(QObject *parent = nullptr);
+  /**
+     @brief Destructor, drops a pending write.
+  */
+  virtual ~DdsPublisher();
+
+  /// Property accessor for the maximal write rate.
+  double maxRateHz() const;
+  /**
+     @brief Sets the maximal write rate.
+
+     A pending write is rescheduled according to the new rate.
+
+     @param[in] rate Writes per second, 0 or less for no limit.
+  */
+  void setMaxRateHz(double rate);
+  /**
+     @brief Start collecting changes into one sample.
+
+     Calls can be nested, the sample is written by the outermost commit().
+  */
+  Q_INVOKABLE void beginUpdate();
+  /**
+     @brief Finish collecting changes, and write the sample if anything changed.
+
+     The write is subject to maxRateHz as any other write.
+  */
+  Q_INVOKABLE void commit();
+  /// True between beginUpdate() and the matching commit().
+  bool updating() const { return m_updateDepth > 0; }
+  /// Property accessor for asynchronous writes.
+  bool asyncWrite() const;
+  /// Sets whether to write on the shared writer thread.
+  void setAsyncWrite(bool async);
+  /// Property accessor for the limit of queued writes.
+  int maxQueuedWrites() const;
+  /// Sets the limit of queued writes of this publisher.
+  void setMaxQueuedWrites(int limit);
+  /// Property accessor for congestion of asynchronous writes.
+  bool congested() const;
+  /// Number of writes of this publisher waiting for the writer thread.
+  Q_INVOKABLE int queuedWrites() const;
+  /// Whether the last call of write() wrote the sample or queued it for the writer thread.
+  bool written() const { return m_written; }
+
+signals:
+  /**
+     @brief Maximal write rate has changed.
+     @param[out] rate New rate.
+  */
+  void maxRateHzChanged(double rate);
+  /**
+     @brief Asynchronous writes have been switched on or off.
+     @param[out] async New setting.
+  */
+  void asyncWriteChanged(bool async);
+  /**
+     @brief Limit of queued writes has changed.
+     @param[out] limit New limit.
+  */
+  void maxQueuedWritesChanged(int limit);
+  /**
+     @brief Asynchronous writes became congested or got through again.
+     @param[out] congested True if the last write could not be queued.
+  */
+  void congestedChanged(bool congested);
+
+protected:
+  /**
+     @brief Write the sample, now or when the rate allows.
+
+     To be called by derived classes after their sample has changed.
+  */
+  void requestWrite();
+  /**
+     @brief Note a change that does not by itself write the sample.
+
+     Within beginUpdate() and commit() it makes commit() write the sample. Otherwise it has
+     no effect, the change is written by an explicit publish.
+  */
+  void markChanged();
+  /**
+     @brief Write the sample now, regardless of the rate, and cancel a pending write.
+  */
+  void writeNow();
+  /**
+     @brief Write the current sample on DDS, implemented by derived classes.
+  */
+  virtual void writeSample() = 0;
+  /**
+     @brief Write the sample of a sinspekto::Writer, on the writer thread if asyncWrite.
+
+     To be used by writeSample(). For asynchronous writes the sample, the instance handle
+     and the reference counted DDS writer or loopback topic are copied, so the publisher
+     may change or go away meanwhile.
+
+     @param[in] writer Wrapper with DDS writer and sample.
+  */
+  template <typename W>
+  void write(W& writer)
+  {
+    if(!m_asyncWrite)
+    {
+      writer.write();
+      m_written = true;
+      setCongested(false);
+      return;
+    }
+    auto dataWriter = writer.writer;
+    auto loopback = writer.loopback;
+    auto sample = writer.sample;
+    auto handle = writer.handle;
+    enqueue(
+        [dataWriter, loopback, sample, handle]() mutable
+        {
+          W::write_sample(dataWriter, loopback, sample, handle);
+        });
+  }
+
+private:
+  /// Write the sample at m_dueMs, on the shared timer wheel.
+  void schedulePending();
+  /// Drop the pending write.
+  void cancelPending();
+  /// Hand a write to the writer thread, or retry later if the queue is full.
+  void enqueue(std::function<void()>&& task);
+  /// Sets congested and notifies on change.
+  void setCongested(bool congested);
+
+  double m_maxRateHz; ///< Maximal write rate, 0 is unlimited.
+  int64_t m_lastWriteMs; ///< Time of the last write, steady clock milliseconds.
+  int64_t m_dueMs; ///< Time when the pending write is due, steady clock milliseconds.
+  bool m_pending; ///< A write is pending.
+  uint64_t m_pendingTimer; ///< Timer of the pending write, see sinspekto::TimerWheel.
+  int m_updateDepth; ///< Nesting depth of beginUpdate().
+  bool m_updateChanged; ///< The sample changed since the outermost beginUpdate().
+  bool m_asyncWrite; ///< Write on the writer thread.
+  int m_maxQueuedWrites; ///< Limit of queued writes of this publisher.
+  bool m_congested; ///< The last asynchronous write could not be queued.
+  bool m_written; ///< The last write() was carried out or queued.
+  std::shared_ptr<std::atomic<int>> m_queued; ///< Queued writes, shared with the queued tasks.
+};
+
+/**
+   @brief Base class of batch publishers, collects samples and writes them as one batch.
+
+   Derived publishers append samples with their timestamps to the batch of their DDS
+   sample. The batch is written when it holds maxBatchSize samples, or maxBatchAgeMs
+   milliseconds after its first sample was appended, whichever comes first. flush() writes
+   the batch right away. The batch is written regardless of maxRateHz, since the batch
+   limits decide the write rate.
+
+   \rst
+   .. code-block:: qml
+
+     DdsBatchIdVec1dPublisher {
+       id: ddsBatch;
+       maxBatchSize: 200;
+       maxBatchAgeMs: 100;
+       Component.onCompleted: {
+         ddsBatch.init(QtToDds, "topic", "id");
+       }
+     }
+
+     ddsBatch.append(value); // timestamped now
+
+   \endrst
+
+   With asyncWrite, a batch that could not be queued is kept and grows until the retry
+   gets through, so no samples are dropped while congested.
+*/
+class DdsBatchPublisher : public DdsPublisher
+{
+  Q_OBJECT
+  Q_PROPERTY(int maxBatchSize READ maxBatchSize WRITE setMaxBatchSize NOTIFY maxBatchSizeChanged) ///< Number of samples that triggers a write.
+  Q_PROPERTY(int maxBatchAgeMs READ maxBatchAgeMs WRITE setMaxBatchAgeMs NOTIFY maxBatchAgeMsChanged) ///< Age of the first sample that triggers a write.
+  Q_PROPERTY(int batchSize READ batchSize NOTIFY batchSizeChanged) ///< Number of samples waiting to be written.
+
+public:
+  /**
+     @brief Constructor
+     @param[in] parent QObject pointer.
+  */
+  explicit DdsBatchPublisher(QObject *parent = nullptr);
+  /**
+     @brief Destructor, drops samples that have not been written.
+  */
+  virtual ~DdsBatchPublisher();
+
+  /// Property accessor for the number of samples that triggers a write.
+  int maxBatchSize() const;
+  /// Sets the number of samples that triggers a write, at least 1.
+  void setMaxBatchSize(int size);
+  /// Property accessor for the age that triggers a write.
+  int maxBatchAgeMs() const;
+  /// Sets the age of the first sample that triggers a write, 0 or less for no limit.
+  void setMaxBatchAgeMs(int age);
+  /// Number of samples waiting to be written, implemented by derived classes.
+  virtual int batchSize() const = 0;
+
+signals:
+  /**
+     @brief Number of samples that triggers a write has changed.
+     @param[out] size New size.
+  */
+  void maxBatchSizeChanged(int size);
+  /**
+     @brief Age that triggers a write has changed.
+     @param[out] age New age in milliseconds.
+  */
+  void maxBatchAgeMsChanged(int age);
+  /**
+     @brief Samples were appended or the batch was written.
+     @param[out] size Number of samples waiting to be written.
+  */
+  void batchSizeChanged(int size);
+
+public slots:
+  /**
+     @brief Write the samples collected so far, if any.
+  */
+  void flush();
+
+protected:
+  /**
+     @brief To be called by derived classes after appending a sample.
+
+     Writes the batch when it is full, or starts the age limit with the first sample.
+  */
+  void sampleAppended();
+  /**
+     @brief Whether the batch just handed to write() can be cleared.
+
+     False if an asynchronous write could not be queued, then the batch is kept for the
+     retry.
+  */
+  bool batchWritten() const { return written(); }
+  /**
+     @brief To be called by derived classes after clearing a written batch.
+  */
+  void batchCleared();
+  /// Current time as milliseconds since epoch, for timestamps of appended samples.
+  static int64_t nowMillis();
+
+private:
+  int m_maxBatchSize; ///< Number of samples that triggers a write.
+  int m_maxBatchAgeMs; ///< Age of the first sample that triggers a write.
+  QTimer m_ageTimer; ///< Writes the batch when its first sample is too old.
+};
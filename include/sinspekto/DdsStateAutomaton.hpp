@@ -1,9 +1,13 @@
 #pragma once
 /**
    @file DdsStateAutomaton.hpp
-   @brief DDS subscribe adapter for ProcessStateAutomaton signals in QML.
+   @brief DDS subscribe adapters for ProcessStateAutomaton signals in QML.
 */
 
+#include <vector>
+#include <QAbstractListModel>
+#include <QDateTime>
+#include <QHash>
 #include "sinspekto/QtToDds.hpp"
 
 /**
@@ -107,3 +111,137 @@ private:
   std::unique_ptr<sinspekto::Reader<fkin::ProcessStateAutomaton>> m_reader; ///< The DDS reader wrapper class.
   QString m_identifier; ///< Key identifier for topic instance.
 };
+
+/**
+   @brief List model of the process states of all identifiers on one DDS topic.
+
+   One reader receives the ProcessStateAutomaton samples of every process, instead of one
+   DdsStateAutomaton per identifier. Each identifier gets a row the first time it is heard
+   of, found again through a hash from identifier to row. New samples only emit
+   dataChanged() for the rows whose state changed, so a view of many processes only
+   redraws the delegates that changed.
+
+   The roles are identifier, state, stateName and timestamp.
+
+   \rst
+   .. code-block:: qml
+
+     ListView {
+       model: DdsProcessStateModel {
+         id: processStates;
+         Component.onCompleted: {
+           processStates.init(QtToDds, "fkinStateNotification");
+         }
+       }
+       delegate: Text { text: identifier + ": " + stateName; }
+     }
+
+   \endrst
+
+   @rst
+   .. note ::
+
+     The reader has the same QoS as DdsStateAutomaton.
+   @endrst
+
+*/
+class DdsProcessStateModel : public QAbstractListModel
+{
+  Q_OBJECT
+  Q_PROPERTY(int count READ count NOTIFY countChanged) ///< Number of processes.
+
+public:
+  /// Roles of the model.
+  enum Roles
+  {
+    IdentifierRole = Qt::UserRole + 1, ///< Key identifier of the process.
+    StateRole, ///< State as fkin::ProcessStateKind.
+    StateNameRole, ///< Human readable name of state.
+    TimestampRole ///< Source time of the last state sample.
+  };
+  Q_ENUM(Roles)
+
+  /**
+     @brief Constructor
+
+     The initialization is deferred to an init() function.
+
+     @param [in] parent QObject pointer.
+  */
+  explicit DdsProcessStateModel(QObject *parent = nullptr);
+  /**
+     @brief Destructor.
+  */
+  virtual ~DdsProcessStateModel();
+
+  /**
+     @brief Initializes DDS reader and connects Qt signals and slots.
+
+     @param[in] dds Pointer to QtToDds instance.
+     @param[in] topic Name of DDS topic for which to subscribe.
+  */
+  Q_INVOKABLE void init(QtToDds* dds, const QString& topic);
+
+  /// Number of rows.
+  int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+  /// Data of a row for a role.
+  QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+  /// Role names for QML delegates.
+  QHash<int, QByteArray> roleNames() const override;
+
+  /// Property accessor for the number of processes.
+  int count() const { return static_cast<int>(m_rows.size()); }
+  /**
+     @brief Row of a process.
+     @param[in] identifier Key identifier of the process.
+     @return Row, or -1 if not heard of.
+  */
+  Q_INVOKABLE int indexOf(const QString& identifier) const;
+  /**
+     @brief State of a process.
+     @param[in] identifier Key identifier of the process.
+     @return State, UNKNOWN if not heard of.
+  */
+  Q_INVOKABLE fkin::ProcessStateKind state(const QString& identifier) const;
+
+signals:
+  /// Number of processes has changed.
+  void countChanged();
+  /**
+     @brief The state of a process has changed.
+
+     Emitted after the model is updated, so state() and the rows include the change.
+
+     @param[out] identifier Key identifier of the process.
+     @param[out] state New state.
+  */
+  void processStateChanged(const QString& identifier, fkin::ProcessStateKind state);
+  /**
+     @brief DdsReaderListener calls this signal when there is data available on the subscribed topic.
+
+     signal eventHeard() is connected to the slot updateStates().
+  */
+  void eventHeard();
+
+public slots:
+  /**
+     @brief Takes all new samples and updates the rows they concern.
+
+     New identifiers are appended as rows, and dataChanged() is emitted for each row whose
+     state changed.
+  */
+  void updateStates();
+
+private:
+  /// State of one process.
+  struct Row
+  {
+    QString identifier; ///< Key identifier.
+    fkin::ProcessStateKind state; ///< Last state.
+    QDateTime timestamp; ///< Source time of the last sample.
+  };
+
+  std::unique_ptr<sinspekto::Reader<fkin::ProcessStateAutomaton>> m_reader; ///< The DDS reader wrapper class.
+  std::vector<Row> m_rows; ///< One row per identifier, in order of first sample.
+  QHash<QString, int> m_rowIndex; ///< Row of each identifier.
+};
@@ -7,6 +7,8 @@
 #include <QXYSeries>
 #include <QDateTime>
 
+#include "sinspekto/DdsDoubleBuffer.hpp"
+
 QT_CHARTS_USE_NAMESPACE
 
 namespace sinspekto
@@ -36,6 +38,24 @@ namespace sinspekto
       boost::circular_buffer<int64_t>& b1,
       boost::circular_buffer<double>& b2,
       QXYSeries *xySeries);
+
+  /**
+     @brief Replace data points in a QXYSeries using reusable point storage.
+
+     Same as replace_data_points() above, but the points are written to storage owned by
+     the caller, see SeriesStaging.
+
+     @param[in] b1 Buffer of time points to set.
+     @param[in] b2 Buffer of real values to set.
+     @param[in,out] xySeries QXYSeries pointer to update.
+     @param[in,out] staging Point storage reused across calls for the same series.
+     @return The range of time and range of data value (min and max values).
+  */
+  RangeTX replace_data_points(
+      boost::circular_buffer<int64_t>& b1,
+      boost::circular_buffer<double>& b2,
+      QXYSeries *xySeries,
+      SeriesStaging& staging);
 }
 
 /**
@@ -85,6 +105,25 @@ public:
      @return Reference to the circular buffer.
   */
   boost::circular_buffer<int64_t>& Buffer() { return m_buffer; }
+  /// Read-only access to the circular buffer.
+  const boost::circular_buffer<int64_t>& Buffer() const { return m_buffer; }
+  /**
+     @brief Append a time point to the circular buffer.
+
+     @param[in] timepoint Milliseconds since epoch.
+  */
+  void append(int64_t timepoint);
+  /**
+     @brief Remove all time points.
+  */
+  void clear();
+  /**
+     @brief Number of time points appended since construction or the last clear().
+
+     Together with the buffer size, this tells which elements are new since an earlier
+     call, e.g. for incremental rendering.
+  */
+  uint64_t appended() const { return m_appended; }
 
 signals:
   /**
@@ -121,4 +160,5 @@ private:
   boost::circular_buffer<int64_t> m_buffer; ///< A ring buffer with time points, held as int64_t.
   QDateTime m_min_t, ///< Minimum time point value.
     m_max_t; ///< Maximal time point value.
+  uint64_t m_appended; ///< Number of time points appended since last clear.
 };
@@ -0,0 +1,212 @@
+#pragma once
+/**
+   @file EventLoopMonitor.hpp
+   @brief Congestion of the GUI event loop by the DDS adapters.
+*/
+
+#include <atomic>
+#include <cinttypes>
+#include <unordered_map>
+#include <vector>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVariantList>
+
+class QEvent;
+
+/**
+   @brief Watches the GUI event loop and names the adapters that keep it busy.
+
+   Every adapter posts a queued signal to the GUI thread when DDS data is available, and
+   handles it in a slot such as updateValue() or DdsBuffer::drain(). These slots are
+   connected with sinspekto::connect_event(), which counts the signals waiting in the
+   event queue and, while enabled, times each slot per adapter.
+
+   While enabled, a probe event is posted every probeIntervalMs. Its latency is the time
+   from when it was due until it is dispatched, covering both a late timer and the wait
+   behind other posted events. Once a second the largest latency, the queue depth and the
+   slowest slots are evaluated against the thresholds. When any is exceeded, congested is
+   set, offenders lists the adapters whose slots took longest, and warning describes it.
+
+   \rst
+   .. code-block:: qml
+
+     Component.onCompleted: EventLoopMonitor.enabled = true;
+
+     Label {
+       visible: EventLoopMonitor.congested;
+       color: "red";
+       text: EventLoopMonitor.warning;
+     }
+
+   \endrst
+
+   @note Only the event queue of the GUI thread is monitored, and only signals posted by
+   the adapters are counted in the queue depth.
+*/
+class EventLoopMonitor : public QObject
+{
+  Q_OBJECT
+  Q_PROPERTY(bool enabled READ enabled WRITE setEnabled NOTIFY enabledChanged) ///< Post probes and time slots.
+  Q_PROPERTY(int probeIntervalMs READ probeIntervalMs WRITE setProbeIntervalMs NOTIFY thresholdsChanged) ///< Period of probe events.
+  Q_PROPERTY(double latencyThresholdMs READ latencyThresholdMs WRITE setLatencyThresholdMs NOTIFY thresholdsChanged) ///< Probe latency that is congestion.
+  Q_PROPERTY(double slotThresholdMs READ slotThresholdMs WRITE setSlotThresholdMs NOTIFY thresholdsChanged) ///< Slot duration that is congestion.
+  Q_PROPERTY(int queueThreshold READ queueThreshold WRITE setQueueThreshold NOTIFY thresholdsChanged) ///< Queue depth that is congestion.
+  Q_PROPERTY(double latencyMs READ latencyMs NOTIFY statisticsChanged) ///< Largest probe latency of the last second.
+  Q_PROPERTY(int queueDepth READ queueDepth NOTIFY statisticsChanged) ///< Largest number of adapter signals waiting in the last second.
+  Q_PROPERTY(bool congested READ congested NOTIFY statisticsChanged) ///< A threshold was exceeded in the last second.
+  Q_PROPERTY(QStringList offenders READ offenders NOTIFY statisticsChanged) ///< Adapters with the slowest slots, slowest first.
+  Q_PROPERTY(QString warning READ warning NOTIFY statisticsChanged) ///< Description of the congestion, empty if none.
+
+public:
+  /**
+     @brief Marks the dispatch of an adapter's slot, and times it while enabled.
+
+     Created by sinspekto::connect_event() around the slot.
+  */
+  class Dispatch
+  {
+  public:
+    /**
+       @brief Start of the slot.
+       @param[in] adapter Adapter whose slot is called.
+       @param[in] name Name of the adapter in offenders.
+       @param[in,out] pending Signals of the adapter waiting in the event queue.
+    */
+    Dispatch(const QObject *adapter, const QString& name, std::atomic<int>& pending);
+    /// End of the slot.
+    ~Dispatch();
+    Dispatch(const Dispatch&) = delete;
+    Dispatch& operator=(const Dispatch&) = delete;
+
+  private:
+    const QObject *m_adapter; ///< Adapter whose slot is called.
+    const QString& m_name; ///< Name of the adapter.
+    int64_t m_start; ///< Start in steady microseconds, 0 if not timed.
+  };
+
+  /// Monitor shared by the library, also the QML singleton.
+  static EventLoopMonitor& instance();
+  virtual ~EventLoopMonitor();
+
+  /**
+     @brief A signal of an adapter was posted to the event queue, from any thread.
+     @param[in,out] pending Signals of the adapter waiting in the event queue.
+  */
+  static void posted(std::atomic<int>& pending)
+  {
+    pending.fetch_add(1, std::memory_order_relaxed);
+    s_queued.fetch_add(1, std::memory_order_relaxed);
+  }
+  /**
+     @brief An adapter was destroyed, and Qt discarded its signals still in the event queue.
+     @param[in,out] pending Signals of the adapter waiting in the event queue, reset to 0.
+  */
+  static void discarded(std::atomic<int>& pending)
+  {
+    s_queued.fetch_sub(pending.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+  }
+
+  /// Property accessor for enabled.
+  bool enabled() const { return s_active.load(std::memory_order_relaxed); }
+  /// Start or stop the probes and the timing of slots.
+  void setEnabled(bool enabled);
+  /// Property accessor for the probe period.
+  int probeIntervalMs() const { return m_probeIntervalMs; }
+  /// Sets the probe period, at least 10 ms.
+  void setProbeIntervalMs(int interval);
+  /// Property accessor for the latency threshold.
+  double latencyThresholdMs() const { return m_latencyThresholdMs; }
+  /// Sets the latency threshold.
+  void setLatencyThresholdMs(double threshold);
+  /// Property accessor for the slot threshold.
+  double slotThresholdMs() const { return m_slotThresholdMs; }
+  /// Sets the slot threshold.
+  void setSlotThresholdMs(double threshold);
+  /// Property accessor for the queue threshold.
+  int queueThreshold() const { return m_queueThreshold; }
+  /// Sets the queue threshold.
+  void setQueueThreshold(int threshold);
+
+  /// Property accessor for the largest probe latency.
+  double latencyMs() const { return m_latencyMs; }
+  /// Property accessor for the queue depth.
+  int queueDepth() const { return m_queueDepth; }
+  /// Property accessor for congestion.
+  bool congested() const { return !m_warning.isEmpty(); }
+  /// Property accessor for the offending adapters.
+  QStringList offenders() const { return m_offenders; }
+  /// Property accessor for the warning.
+  QString warning() const { return m_warning; }
+
+  /**
+     @brief Slowest slots of the last second.
+
+     @param[in] count Maximal number of slots.
+     @return List of maps with name, calls, maxMs and meanMs, slowest first.
+  */
+  Q_INVOKABLE QVariantList slowestSlots(int count = 5) const;
+
+signals:
+  /**
+     @brief Monitoring has been switched on or off.
+     @param[out] enabled New setting.
+  */
+  void enabledChanged(bool enabled);
+  /// A threshold or the probe period has changed.
+  void thresholdsChanged();
+  /// Statistics of the last second were evaluated.
+  void statisticsChanged();
+  /**
+     @brief The event loop became congested, or other adapters became the offenders.
+     @param[out] warning Description of the congestion.
+     @param[out] offenders Adapters with the slowest slots, slowest first.
+  */
+  void congestionWarning(const QString& warning, const QStringList& offenders);
+
+protected:
+  /// Handles the probe events.
+  bool event(QEvent *event) override;
+
+private:
+  /// Duration of an adapter's slots within the last second.
+  struct SlotStats
+  {
+    QString name; ///< Name of the adapter.
+    uint64_t calls = 0; ///< Number of calls.
+    int64_t totalUs = 0; ///< Sum of durations in microseconds.
+    int64_t maxUs = 0; ///< Longest duration in microseconds.
+  };
+
+  explicit EventLoopMonitor(QObject *parent = nullptr);
+  /// Post a probe, called periodically from the shared timer wheel.
+  void postProbe();
+  /// Compare the last second to the thresholds, and start the next second.
+  void evaluate(int64_t now);
+  /// Slots of the last second, slowest first.
+  std::vector<SlotStats> sortedSlots() const;
+  /// Record the duration of a slot.
+  void slotFinished(const QObject *adapter, const QString& name, int64_t durationUs);
+  /// Steady clock in microseconds.
+  static int64_t steadyMicros();
+
+  static std::atomic<bool> s_active; ///< Monitoring is enabled.
+  static std::atomic<int> s_queued; ///< Adapter signals waiting in the event queue.
+
+  int m_probeIntervalMs; ///< Period of probe events.
+  double m_latencyThresholdMs; ///< Probe latency that is congestion.
+  double m_slotThresholdMs; ///< Slot duration that is congestion.
+  int m_queueThreshold; ///< Queue depth that is congestion.
+  uint64_t m_timer; ///< Periodic probe, see sinspekto::TimerWheel.
+  int64_t m_lastProbe; ///< Steady microseconds of the last probe posted.
+  int64_t m_windowStart; ///< Steady microseconds of the start of the current second.
+  int64_t m_windowLatencyUs; ///< Largest probe latency of the current second.
+  int m_windowQueueDepth; ///< Largest queue depth of the current second.
+  std::unordered_map<const QObject *, SlotStats> m_slots; ///< Slots of the current second.
+  std::vector<SlotStats> m_lastSlots; ///< Slots of the last second, slowest first.
+  double m_latencyMs; ///< Largest probe latency of the last second.
+  int m_queueDepth; ///< Largest queue depth of the last second.
+  QStringList m_offenders; ///< Adapters with the slowest slots.
+  QString m_warning; ///< Description of the congestion, empty if none.
+};
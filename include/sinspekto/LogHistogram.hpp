@@ -0,0 +1,135 @@
+#pragma once
+/**
+   @file LogHistogram.hpp
+   @brief Log-linear histogram of non-negative integers, e.g. latencies in microseconds.
+*/
+
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace sinspekto
+{
+
+  /**
+     @brief Histogram with buckets of 1/8 of a power of two, relative error below 12.5 %.
+
+     Values below 8 have a bucket each, larger values share 8 buckets per power of two.
+     Values from 2^max_msb go to the last bucket. Exact count, minimum, maximum, mean and
+     standard deviation are kept alongside.
+
+     \rst
+     .. code-block:: cpp
+
+       sinspekto::LogHistogram latency;
+       latency.add(now - source);
+       std::cout << "p99 " << latency.quantile(0.99) << " us" << std::endl;
+
+     \endrst
+
+     @note Not thread-safe, the owner guards it.
+  */
+  class LogHistogram
+  {
+  public:
+    static constexpr unsigned sub_bits = 3; ///< Buckets per power of two are 2^sub_bits.
+    static constexpr uint64_t sub_buckets = uint64_t(1) << sub_bits; ///< Buckets per power of two.
+    static constexpr unsigned max_msb = 40; ///< Larger values go to the last bucket.
+
+    LogHistogram() :
+      m_buckets((max_msb - 1)*sub_buckets, 0),
+      m_count(0),
+      m_min(std::numeric_limits<uint64_t>::max()),
+      m_max(0),
+      m_sum(0.0),
+      m_sumSq(0.0)
+    {}
+
+    /// Add a value.
+    void add(uint64_t value)
+    {
+      ++m_buckets[index(value)];
+      ++m_count;
+      m_min = std::min(m_min, value);
+      m_max = std::max(m_max, value);
+      const double v = static_cast<double>(value);
+      m_sum += v;
+      m_sumSq += v*v;
+    }
+
+    /// Number of values.
+    uint64_t count() const { return m_count; }
+    /// Smallest value, 0 if empty.
+    uint64_t min() const { return m_count ? m_min : 0; }
+    /// Largest value, 0 if empty.
+    uint64_t max() const { return m_max; }
+    /// Mean value, 0 if empty.
+    double mean() const { return m_count ? m_sum/static_cast<double>(m_count) : 0.0; }
+
+    /// Sample standard deviation, 0 for less than two values.
+    double stddev() const
+    {
+      if(m_count < 2) return 0.0;
+      const double n = static_cast<double>(m_count);
+      const double m = m_sum/n;
+      return std::sqrt(std::max(0.0, (m_sumSq - n*m*m)/(n - 1.0)));
+    }
+
+    /// Upper bound of the bucket that holds quantile q, at most max().
+    uint64_t quantile(double q) const
+    {
+      if(m_count == 0) return 0;
+      const uint64_t rank = std::max<uint64_t>(
+          1, static_cast<uint64_t>(std::ceil(q*static_cast<double>(m_count))));
+      uint64_t seen = 0;
+      for(size_t i = 0; i < m_buckets.size(); ++i)
+      {
+        seen += m_buckets[i];
+        if(seen >= rank)
+          return std::min(m_max, upper(i));
+      }
+      return m_max;
+    }
+
+    /// Counts per bucket, see upper() for their bounds.
+    const std::vector<uint64_t>& buckets() const { return m_buckets; }
+
+    /// Largest value of bucket i.
+    static uint64_t upper(size_t i) { return lower(i + 1) - 1; }
+
+  private:
+    /// Highest set bit, value must not be 0.
+    static unsigned msb(uint64_t value)
+    {
+      unsigned bit = 0;
+      while(value >>= 1) ++bit;
+      return bit;
+    }
+
+    static size_t index(uint64_t value)
+    {
+      if(value < sub_buckets) return static_cast<size_t>(value);
+      const unsigned bit = std::min(msb(value), max_msb);
+      const uint64_t sub = bit < max_msb ? (value >> (bit - sub_bits)) & (sub_buckets - 1) : sub_buckets - 1;
+      return static_cast<size_t>((bit - sub_bits + 1)*sub_buckets + sub);
+    }
+
+    /// Smallest value of bucket i.
+    static uint64_t lower(size_t i)
+    {
+      if(i < 2*sub_buckets) return i;
+      const unsigned bit = static_cast<unsigned>(i/sub_buckets) + sub_bits - 1;
+      return (sub_buckets + i%sub_buckets) << (bit - sub_bits);
+    }
+
+    std::vector<uint64_t> m_buckets; ///< Counts per bucket.
+    uint64_t m_count; ///< Number of values.
+    uint64_t m_min; ///< Smallest value.
+    uint64_t m_max; ///< Largest value.
+    double m_sum; ///< Sum of values.
+    double m_sumSq; ///< Sum of squared values.
+  };
+
+}
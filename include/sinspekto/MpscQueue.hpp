@@ -0,0 +1,140 @@
+#pragma once
+/**
+   @file MpscQueue.hpp
+   @brief Bounded lock-free queue for multiple producers and a single consumer.
+*/
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace sinspekto
+{
+
+  /**
+     @brief Bounded lock-free queue with many producer threads and one consumer thread.
+
+     Each cell carries a sequence number that tells whether it is free for the producer
+     with a given ticket, or filled for the consumer. Producers claim tickets with a
+     compare-and-swap, and never wait for each other or the consumer. A full queue is
+     reported by push() instead of blocking, such that the caller can apply back-pressure.
+
+     \rst
+     .. code-block:: cpp
+
+       sinspekto::MpscQueue<int> queue(1024);
+
+       // Any thread
+       if(!queue.push(42)) { ... } // full
+
+       // Consumer thread
+       int value;
+       while(queue.pop(value)) { ... }
+
+     \endrst
+
+  */
+  template <typename T>
+  class MpscQueue
+  {
+  public:
+    /**
+       @brief Constructor.
+       @param[in] capacity Number of elements, rounded up to a power of two.
+    */
+    explicit MpscQueue(size_t capacity) :
+      m_mask(roundUp(capacity) - 1),
+      m_cells(new Cell[m_mask + 1]),
+      m_enqueue(0),
+      m_dequeue(0)
+    {
+      for(size_t i = 0; i <= m_mask; ++i)
+        m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    /// Number of elements the queue can hold.
+    size_t capacity() const { return m_mask + 1; }
+
+    /**
+       @brief Add an element, from any thread.
+       @param[in] value Element, moved from only if the push succeeds.
+       @return False if the queue is full.
+    */
+    bool push(T&& value)
+    {
+      size_t pos = m_enqueue.load(std::memory_order_relaxed);
+      Cell *cell;
+      for(;;)
+      {
+        cell = &m_cells[pos & m_mask];
+        const size_t seq = cell->sequence.load(std::memory_order_acquire);
+        const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+        if(diff == 0)
+        {
+          if(m_enqueue.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            break;
+        }
+        else if(diff < 0)
+          return false; // the consumer has not freed this cell yet
+        else
+          pos = m_enqueue.load(std::memory_order_relaxed);
+      }
+      cell->value = std::move(value);
+      cell->sequence.store(pos + 1, std::memory_order_release);
+      return true;
+    }
+
+    /**
+       @brief Take the oldest element, only from the consumer thread.
+       @param[out] value Element taken from the queue.
+       @return False if the queue is empty.
+    */
+    bool pop(T& value)
+    {
+      const size_t pos = m_dequeue.load(std::memory_order_relaxed);
+      Cell& cell = m_cells[pos & m_mask];
+      const size_t seq = cell.sequence.load(std::memory_order_acquire);
+      if(static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1) < 0)
+        return false;
+
+      value = std::move(cell.value);
+      cell.value = T(); // release resources held by the element now
+      cell.sequence.store(pos + m_mask + 1, std::memory_order_release);
+      m_dequeue.store(pos + 1, std::memory_order_relaxed);
+      return true;
+    }
+
+    /// True if there is no element for the consumer, only reliable on the consumer thread.
+    bool empty() const
+    {
+      const size_t pos = m_dequeue.load(std::memory_order_relaxed);
+      const size_t seq = m_cells[pos & m_mask].sequence.load(std::memory_order_acquire);
+      return static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1) < 0;
+    }
+
+  private:
+    /// Element with sequence number, see class description.
+    struct Cell
+    {
+      std::atomic<size_t> sequence; ///< Ticket the cell is ready for.
+      T value; ///< Element.
+    };
+
+    /// Smallest power of two not less than n, and at least 2.
+    static size_t roundUp(size_t n)
+    {
+      size_t p = 2;
+      while(p < n) p <<= 1;
+      return p;
+    }
+
+    const size_t m_mask; ///< Capacity minus one.
+    std::unique_ptr<Cell[]> m_cells; ///< Ring of cells.
+    alignas(64) std::atomic<size_t> m_enqueue; ///< Next producer ticket.
+    alignas(64) std::atomic<size_t> m_dequeue; ///< Next consumer ticket.
+  };
+}
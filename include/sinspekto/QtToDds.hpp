@@ -197,6 +197,23 @@ namespace qml_enums
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
   Q_ENUM_NS(DimId);
 #endif
+
+  /**
+     @brief Methods to align samples from two buffers on time.
+
+     Used by DdsBuffer::joinSeries() to pair values from buffers with different time
+     points.
+
+  */
+  Q_NAMESPACE
+  enum class JoinMode
+    {
+     AsOf,  ///< Use the latest sample at or before the time point.
+     Linear ///< Interpolate linearly between the samples around the time point.
+    };
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+  Q_ENUM_NS(JoinMode);
+#endif
 }
 #ifdef __GNUC__
 #pragma GCC diagnostic pop
@@ -213,17 +230,46 @@ namespace qml_enums
    this component and initalize it before adding any sinspekto DDS adapters, <a
    href="../rst/intro.html#minimal-qml-example">see the minimal example</a>.
 
+   Instead of DDS, initLoopback() selects an in-process transport, where the adapters of
+   the application exchange samples without OpenSplice or a running DDS daemon. It serves
+   headless tests and benchmarks of the ingest and rendering paths, with publishers
+   driving the buffers of the same application.
+
+   \rst
+   .. code-block:: qml
+
+     QtToDds { id: qtToDds; }
+     Component.onCompleted: {
+       qtToDds.initLoopback(0);
+       ddsPublisher.init(qtToDds, "topic", "id", 0.0, false);
+       ddsBuffer.init(qtToDds, "topic", "id", 1000, false, true);
+     }
+
+   \endrst
+
+   @note The loopback transport supports the adapters that take the latest sample of an
+   instance, which are all except DdsCommandSubscriber, DdsCommandPublisher and
+   DdsProcessStateModel. These report an error and stay uninitialized. Durability and
+   reliability QoS are not emulated: a reader only receives samples written after it was
+   created, and keeps at most 4096 samples that have not been taken.
+
 */
 struct QtToDds : public QObject
 {
   Q_OBJECT
   Q_PROPERTY(bool initialized READ initialized NOTIFY initializedChanged) ///< Indicator whether QtToDds has been initialized.
+  Q_PROPERTY(bool loopback READ loopback NOTIFY initializedChanged) ///< Initialized with the loopback transport.
 
   /**
      @brief Access function used by QML property.
      @return boolean whether DDS is initialized.
   */
   bool initialized() const;
+  /**
+     @brief Access function used by QML property.
+     @return boolean whether the loopback transport is used instead of DDS.
+  */
+  bool loopback() const;
 
 public:
   /**
@@ -247,6 +293,13 @@ public:
   */
   Q_INVOKABLE void init(int domain);
 
+  /**
+     @brief Initializes the in-process loopback transport instead of DDS.
+
+     @param[in] domain Separates topics of the loopback transport, as a DDS domain.
+  */
+  Q_INVOKABLE void initLoopback(int domain = 0);
+
 signals:
   /**
      @brief DDS initialized state has has changed.
@@ -262,5 +315,6 @@ public:
   std::unique_ptr<Dds> dds; ///< Opaque pointer to QtToDds::Dds.
 private:
   bool m_ready; ///< Holds the property on whether DDS is ready.
+  bool m_loopback; ///< Holds the property on whether the loopback transport is used.
 
 };
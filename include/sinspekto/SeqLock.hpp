@@ -0,0 +1,145 @@
+#pragma once
+/**
+   @file SeqLock.hpp
+   @brief Sequence lock for single writer, multiple reader access to buffers.
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <cinttypes>
+#include <thread>
+#include <vector>
+#include <boost/circular_buffer.hpp>
+
+namespace sinspekto
+{
+
+  /**
+     @brief Sequence lock for one writer thread and any number of reader threads.
+
+     The writer increments a sequence counter before and after modifying the protected
+     data, so the counter is odd while a write is in progress. A reader records the
+     counter, copies the data, and retries if the counter was odd or has changed in the
+     meantime. The writer never waits for readers, and readers never block each other.
+
+     \rst
+     .. code-block:: cpp
+
+       // Writer
+       {
+         sinspekto::SeqLock::WriteGuard write(lock);
+         buffer.push_back(value);
+       }
+
+       // Reader
+       uint64_t seq;
+       do {
+         seq = lock.beginRead();
+         copy = buffer; // must tolerate torn data, which is discarded
+       } while(lock.retryRead(seq));
+
+     \endrst
+
+     @note The protected data must not be reallocated while readers may access it, since
+     a reader can observe the data at any time.
+
+  */
+  class SeqLock
+  {
+  public:
+    /// Constructor.
+    SeqLock() : m_sequence(0) {}
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+
+    /// Mark the start of a write, only to be called from the writer thread.
+    void beginWrite()
+    {
+      m_sequence.store(m_sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    /// Mark the end of a write, only to be called from the writer thread.
+    void endWrite()
+    {
+      m_sequence.store(m_sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    /**
+       @brief Start reading, waits until no write is in progress.
+       @return Sequence number to pass to retryRead().
+    */
+    uint64_t beginRead() const
+    {
+      uint64_t seq = m_sequence.load(std::memory_order_acquire);
+      while(seq & 1)
+      {
+        std::this_thread::yield();
+        seq = m_sequence.load(std::memory_order_acquire);
+      }
+      return seq;
+    }
+
+    /**
+       @brief Finish reading.
+       @param[in] seq Sequence number from beginRead().
+       @return True if a write happened while reading, and the read must be repeated.
+    */
+    bool retryRead(uint64_t seq) const
+    {
+      std::atomic_thread_fence(std::memory_order_acquire);
+      return m_sequence.load(std::memory_order_relaxed) != seq;
+    }
+
+    /// Number of completed writes.
+    uint64_t writes() const { return m_sequence.load(std::memory_order_acquire) >> 1; }
+
+    /// Scoped write section, calls beginWrite() and endWrite().
+    class WriteGuard
+    {
+    public:
+      /// Constructor, starts the write.
+      explicit WriteGuard(SeqLock& lock) : m_lock(lock) { m_lock.beginWrite(); }
+      /// Destructor, ends the write.
+      ~WriteGuard() { m_lock.endWrite(); }
+      WriteGuard(const WriteGuard&) = delete;
+      WriteGuard& operator=(const WriteGuard&) = delete;
+    private:
+      SeqLock& m_lock; ///< The lock being written.
+    };
+
+  private:
+    std::atomic<uint64_t> m_sequence; ///< Odd while a write is in progress.
+  };
+
+  /**
+     @brief Copy the contents of a circular buffer that may be modified concurrently.
+
+     Intended to be used within a SeqLock read section. The copy is always confined to
+     the buffer's allocated storage, even if the buffer is modified during the copy, in
+     which case the result is garbage and the SeqLock read must be retried.
+
+     @param[in] ring Circular buffer to copy from, its capacity must not change.
+     @param[out] out Vector with a copy of the ring contents, oldest element first.
+     @return False if the buffer state was observed to be inconsistent.
+  */
+  template <typename T>
+  bool copy_ring(const boost::circular_buffer<T>& ring, std::vector<T>& out)
+  {
+    const auto one = ring.array_one();
+    const auto two = ring.array_two(); // two.first is always the start of the storage
+    const T *base = two.first;
+    const size_t capacity = ring.capacity();
+
+    if(one.first < base || static_cast<size_t>(one.first - base) > capacity)
+      return false;
+
+    const size_t n1 = std::min(one.second, capacity - static_cast<size_t>(one.first - base));
+    const size_t n2 = std::min(two.second, capacity - n1);
+
+    out.resize(n1 + n2);
+    std::copy(one.first, one.first + n1, out.begin());
+    std::copy(two.first, two.first + n2, out.begin() + static_cast<std::ptrdiff_t>(n1));
+    return true;
+  }
+}
@@ -0,0 +1,168 @@
+#pragma once
+/**
+   @file SinspektoMetrics.hpp
+   @brief Registry of per-adapter counters, shown as a model and exported to file.
+*/
+
+#include <atomic>
+#include <cinttypes>
+#include <functional>
+#include <vector>
+#include <QAbstractListModel>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QString>
+
+/**
+   @brief Model of counters of the adapters, for a diagnostics page and for tuning.
+
+   Adapters own a Counters structure that they increment with relaxed atomic operations,
+   and attach it to the registry. Every intervalMs milliseconds the registry turns the
+   counters into rates, updates the model in one dataChanged(), and, if exportFile is
+   set, appends a record per adapter to the file. A file ending in ``.json`` gets one
+   JSON object per line and interval, any other file gets CSV with a header line.
+
+   DdsBuffer attaches itself in init(), named after its topic. Its samples, drains and
+   coalesced drains are counted by DdsBuffer::drain(), and its series rebuilds and points
+   by DdsBuffer::updateSeries(), DdsBuffer::joinSeries() and DdsLineSeries.
+
+   \rst
+   .. code-block:: qml
+
+     ListView {
+       model: SinspektoMetrics
+       delegate: Label {
+         text: name + ": " + samplesPerSecond.toFixed(0) + " samples/s, "
+               + coalescedEvents + " coalesced, " + (bytesBuffered/1024).toFixed(0) + " KiB";
+       }
+     }
+
+     Component.onCompleted: SinspektoMetrics.exportFile = "/tmp/sinspekto-metrics.csv";
+
+   \endrst
+*/
+class SinspektoMetrics : public QAbstractListModel
+{
+  Q_OBJECT
+  Q_PROPERTY(int count READ count NOTIFY countChanged) ///< Number of adapters.
+  Q_PROPERTY(int intervalMs READ intervalMs WRITE setIntervalMs NOTIFY intervalMsChanged) ///< Period of rates and export.
+  Q_PROPERTY(QString exportFile READ exportFile WRITE setExportFile NOTIFY exportFileChanged) ///< File to append records to, empty for none.
+
+public:
+  /// Counters of an adapter, incremented from any thread.
+  struct Counters
+  {
+    std::atomic<uint64_t> samples{0}; ///< Samples appended.
+    std::atomic<uint64_t> drains{0}; ///< Calls that took samples from DDS.
+    std::atomic<uint64_t> coalesced{0}; ///< Drains that found nothing, as an earlier drain took their samples.
+    std::atomic<uint64_t> rebuilds{0}; ///< Series rebuilt from the whole buffer.
+    std::atomic<uint64_t> points{0}; ///< Points handed to series.
+  };
+
+  /// Roles of the model.
+  enum Roles
+  {
+    NameRole = Qt::UserRole + 1, ///< Name of the adapter, usually its topic.
+    TypeRole, ///< Class name of the adapter.
+    SamplesPerSecondRole, ///< Samples appended per second.
+    DrainsPerSecondRole, ///< Drains per second.
+    CoalescedEventsRole, ///< Coalesced drains since attached.
+    SeriesRebuildsRole, ///< Series rebuilds since attached.
+    PointsPerSecondRole, ///< Points handed to series per second.
+    PointsUploadedRole, ///< Points handed to series since attached.
+    BytesBufferedRole ///< Bytes of samples held by the adapter.
+  };
+  Q_ENUM(Roles)
+
+  /// Registry shared by the library, also the QML singleton.
+  static SinspektoMetrics& instance();
+  virtual ~SinspektoMetrics();
+
+  /**
+     @brief Add an adapter to the model, or rename it if already added.
+
+     @param[in] adapter Adapter, must call detach() before its counters go away.
+     @param[in] name Name shown in the model.
+     @param[in] counters Counters of the adapter.
+     @param[in] bytesBuffered Called on the GUI thread each interval, may be empty.
+  */
+  void attach(
+      QObject *adapter,
+      const QString& name,
+      const Counters *counters,
+      std::function<uint64_t()> bytesBuffered = nullptr);
+  /**
+     @brief Remove an adapter from the model.
+     @param[in] adapter Adapter given to attach().
+  */
+  void detach(QObject *adapter);
+
+  /// Number of rows.
+  int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+  /// Data of a row for a role.
+  QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+  /// Role names for QML delegates.
+  QHash<int, QByteArray> roleNames() const override;
+
+  /// Property accessor for the number of adapters.
+  int count() const { return static_cast<int>(m_rows.size()); }
+  /// Property accessor for the period.
+  int intervalMs() const { return m_intervalMs; }
+  /// Sets the period of rates and export, at least 100 ms.
+  void setIntervalMs(int interval);
+  /// Property accessor for the export file.
+  QString exportFile() const { return m_exportFile.fileName(); }
+  /**
+     @brief Start appending records to a file, which is truncated first.
+     @param[in] fileName File name, empty to stop exporting.
+  */
+  void setExportFile(const QString& fileName);
+
+signals:
+  /// Number of adapters has changed.
+  void countChanged();
+  /**
+     @brief Period has changed.
+     @param[out] interval New period in milliseconds.
+  */
+  void intervalMsChanged(int interval);
+  /// Export file has changed.
+  void exportFileChanged();
+
+public slots:
+  /**
+     @brief Update rates and write records now, also called each interval.
+  */
+  void refresh();
+
+private:
+  /// Adapter with its counters and the values of the last interval.
+  struct Row
+  {
+    QObject *adapter; ///< Adapter, identifies the row.
+    QString name; ///< Name shown in the model.
+    QString type; ///< Class name of the adapter.
+    const Counters *counters; ///< Counters of the adapter.
+    std::function<uint64_t()> bytesBuffered; ///< Bytes held by the adapter.
+    uint64_t samples = 0; ///< Samples at the last interval.
+    uint64_t drains = 0; ///< Drains at the last interval.
+    uint64_t points = 0; ///< Points at the last interval.
+    double samplesPerSecond = 0.0; ///< Samples per second in the last interval.
+    double drainsPerSecond = 0.0; ///< Drains per second in the last interval.
+    double pointsPerSecond = 0.0; ///< Points per second in the last interval.
+    uint64_t bytes = 0; ///< Bytes held at the last interval.
+  };
+
+  explicit SinspektoMetrics(QObject *parent = nullptr);
+  /// Schedule refresh() on the shared timer wheel.
+  void schedule();
+  /// Append the rows to the export file.
+  void writeRecords(qint64 timestamp);
+
+  std::vector<Row> m_rows; ///< Adapters in order of attach.
+  int m_intervalMs; ///< Period of rates and export.
+  uint64_t m_timer; ///< Periodic refresh, see sinspekto::TimerWheel.
+  QElapsedTimer m_elapsed; ///< Time since the last refresh.
+  QFile m_exportFile; ///< Export file, open while exporting.
+  bool m_exportJson; ///< Write JSON lines instead of CSV.
+};
@@ -0,0 +1,136 @@
+#pragma once
+/**
+   @file TimeAxisController.hpp
+   @brief QML element to scroll time axes along with a buffer.
+*/
+
+#include <cinttypes>
+#include <vector>
+#include <QObject>
+#include <QDateTime>
+#include <QTimer>
+#include <QAbstractAxis>
+
+#include "sinspekto/DdsBuffer.hpp"
+
+QT_CHARTS_USE_NAMESPACE
+
+/**
+   @brief Helper QML element that keeps time axes scrolled to the newest data of a buffer.
+
+   The axes show a window of horizonMS milliseconds, that extends futureMS milliseconds
+   beyond the newest time point in the source buffer. Any number of DateTimeAxis can be
+   attached, such that several charts scroll together from one clock. The axes are updated
+   at most once per frame, regardless of the rate of new data.
+
+   \rst
+   .. code-block:: qml
+
+     TimeAxisController {
+       id: timeController;
+       source: ddsBuffer;
+       horizonMS: 29000;
+       futureMS: 1000;
+       Component.onCompleted: {
+         timeController.attachAxis(firstChart.axisT);
+         timeController.attachAxis(secondChart.axisT);
+       }
+     }
+
+   \endrst
+
+*/
+class TimeAxisController : public QObject
+{
+  Q_OBJECT
+  Q_PROPERTY(DdsBuffer* source READ source WRITE setSource NOTIFY sourceChanged) ///< Buffer that drives the time axes.
+  Q_PROPERTY(int horizonMS READ horizonMS WRITE setHorizonMS NOTIFY horizonMSChanged) ///< Time range of the axes, milliseconds.
+  Q_PROPERTY(int futureMS READ futureMS WRITE setFutureMS NOTIFY futureMSChanged) ///< Time beyond the newest time point, milliseconds.
+  Q_PROPERTY(QDateTime min READ min NOTIFY rangeChanged) ///< Current minimum of the axes.
+  Q_PROPERTY(QDateTime max READ max NOTIFY rangeChanged) ///< Current maximum of the axes.
+
+public:
+  /**
+     @brief Constructor.
+     @param[in] parent QObject pointer.
+  */
+  explicit TimeAxisController(QObject *parent = nullptr);
+  /**
+     @brief Destructor.
+  */
+  virtual ~TimeAxisController();
+
+  /// Property accessor for source buffer.
+  DdsBuffer* source() const;
+  /// Property accessor for time horizon.
+  int horizonMS() const;
+  /// Property accessor for time beyond the newest time point.
+  int futureMS() const;
+  /// Property accessor for axes minimum.
+  QDateTime min() const;
+  /// Property accessor for axes maximum.
+  QDateTime max() const;
+
+  /**
+     @brief Let this controller set the range of a time axis.
+
+     The axis is released when it is destroyed.
+
+     @param[in] axis A DateTimeAxis, other axis types are ignored.
+  */
+  Q_INVOKABLE void attachAxis(QAbstractAxis *axis);
+  /**
+     @brief Stop setting the range of a time axis.
+     @param[in] axis A previously attached axis.
+  */
+  Q_INVOKABLE void detachAxis(QAbstractAxis *axis);
+
+signals:
+  /// Signal triggered when source has changed.
+  void sourceChanged();
+  /// Signal triggered when horizonMS has changed.
+  void horizonMSChanged();
+  /// Signal triggered when futureMS has changed.
+  void futureMSChanged();
+  /// Signal triggered after the axes range has changed.
+  void rangeChanged();
+
+public slots:
+  /**
+     @brief Sets the source buffer.
+
+     The newest time point is read from the buffer when it signals new data.
+
+     @param[in] source Buffer, or nullptr to only use setLatest().
+  */
+  void setSource(DdsBuffer *source);
+  /// Sets the time horizon.
+  void setHorizonMS(int horizon);
+  /// Sets the time beyond the newest time point.
+  void setFutureMS(int future);
+  /**
+     @brief Sets the newest time point directly, e.g. when there is no source buffer.
+     @param[in] latest Newest time point.
+  */
+  void setLatest(const QDateTime& latest);
+
+private slots:
+  /// Reads the newest time point of the source.
+  void sourceUpdated();
+  /// Sets the range of attached axes, called once per frame.
+  void flush();
+
+private:
+  /// Evaluate the range with the next frame.
+  void schedule();
+
+  DdsBuffer *m_source; ///< Source buffer, not owned.
+  int m_horizonMS; ///< Time horizon.
+  int m_futureMS; ///< Time beyond the newest time point.
+  int64_t m_latestMS; ///< Newest time point, milliseconds since epoch.
+  bool m_hasLatest; ///< The newest time point has been set.
+  int64_t m_minMS; ///< Current axes minimum.
+  int64_t m_maxMS; ///< Current axes maximum.
+  std::vector<QAbstractAxis *> m_axes; ///< Attached time axes.
+  QTimer m_frameTimer; ///< Defers axes updates to the next frame.
+};
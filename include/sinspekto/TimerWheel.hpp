@@ -0,0 +1,156 @@
+#pragma once
+/**
+   @file TimerWheel.hpp
+   @brief Hierarchical timer wheel, many deadlines driven by one Qt timer.
+*/
+
+#include <cinttypes>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <QPointer>
+#include <QTimer>
+
+namespace sinspekto
+{
+
+  /**
+     @brief Hierarchical timer wheel for one-shot and periodic callbacks on the GUI thread.
+
+     Timers are kept in four levels of 64 slots, where a slot of level l spans 64^l ticks.
+     A timer is linked into the slot of its expiry at the lowest level that reaches it, and
+     moves down a level each time the wheel below wraps around. Scheduling and cancelling
+     are thus constant time, regardless of the number of timers, and expired timers cost
+     constant time each. Timers further away than 64^4 ticks wait in the top level until
+     they come within reach.
+
+     The wheel is driven by a single QTimer, which is only started for the next slot that
+     holds timers, found from a bitmap of occupied slots per level. An idle wheel does not
+     wake up.
+
+     \rst
+     .. code-block:: cpp
+
+       auto& wheel = sinspekto::TimerWheel::instance();
+       auto id = wheel.schedule(1000, [this](){ handleTimeout(); });
+       ...
+       wheel.cancel(id); // response arrived
+
+     \endrst
+
+     @note Not thread-safe, only use it from the thread that runs the Qt event loop.
+  */
+  class TimerWheel
+  {
+  public:
+    /// Handle of a scheduled timer, never 0.
+    using TimerId = uint64_t;
+
+    /**
+       @brief Constructor.
+       @param[in] tickMs Resolution in milliseconds, deadlines are rounded up to it.
+    */
+    explicit TimerWheel(int tickMs = 1);
+    /**
+       @brief Destructor, drops all timers without calling them.
+    */
+    ~TimerWheel();
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    /// Wheel with 1 ms resolution shared by the library.
+    static TimerWheel& instance();
+
+    /**
+       @brief Call a function once after a delay.
+       @param[in] delayMs Delay in milliseconds, at least one tick.
+       @param[in] callback Function to call.
+       @return Handle for cancel().
+    */
+    TimerId schedule(int64_t delayMs, std::function<void()> callback);
+    /**
+       @brief Call a function repeatedly.
+
+       Periods that are missed, e.g. while the event loop is blocked, are skipped.
+
+       @param[in] periodMs Period in milliseconds, at least one tick.
+       @param[in] callback Function to call.
+       @return Handle for cancel().
+    */
+    TimerId schedulePeriodic(int64_t periodMs, std::function<void()> callback);
+    /**
+       @brief Stop a timer, also from within its own callback.
+       @param[in] id Handle from schedule() or schedulePeriodic().
+       @return False if the timer has already fired or was cancelled.
+    */
+    bool cancel(TimerId id);
+    /// True if the timer will still fire.
+    bool pending(TimerId id) const;
+    /// Number of timers that will still fire.
+    size_t size() const { return m_size; }
+    /// Resolution in milliseconds.
+    int tickMs() const { return m_tickMs; }
+
+    /**
+       @brief Run the timers that are due at a point in time, in order of expiry.
+
+       Called by the internal timer with the current time. Benchmarks may call it with a
+       later time to run the wheel faster than real time.
+
+       @param[in] nowMs Steady clock time in milliseconds.
+    */
+    void advance(int64_t nowMs);
+
+  private:
+    static constexpr unsigned level_bits = 6; ///< 64 slots per level.
+    static constexpr unsigned slots = 1u << level_bits; ///< Slots per level.
+    static constexpr unsigned levels = 4; ///< Number of levels.
+    static constexpr uint32_t firing_list = levels*slots; ///< List of timers being called.
+    static constexpr uint32_t npos = 0xffffffffu; ///< No node or no list.
+
+    /// Timer, linked into a slot by index.
+    struct Node
+    {
+      uint64_t expiry = 0; ///< Tick of expiry.
+      uint64_t period = 0; ///< Period in ticks, 0 for one-shot.
+      std::function<void()> callback; ///< Function to call.
+      uint32_t prev = npos; ///< Previous node in the list.
+      uint32_t next = npos; ///< Next node in the list, or in the free list.
+      uint32_t list = npos; ///< Slot or firing list the node is linked into.
+      uint32_t generation = 1; ///< Incremented on reuse, to detect stale handles.
+      bool firing = false; ///< The callback is running.
+      bool cancelled = false; ///< Cancelled while its callback is running.
+    };
+
+    TimerId add(uint64_t delayTicks, uint64_t period, std::function<void()>&& callback);
+    Node* find(TimerId id);
+    const Node* find(TimerId id) const;
+    /// Link a node into the slot of its expiry.
+    void place(uint32_t idx);
+    void link(uint32_t idx, uint32_t list);
+    void unlink(uint32_t idx);
+    void release(uint32_t idx);
+    /// Advance one tick, cascade and call the expired timers.
+    void step();
+    /// Move the timers of a slot down to lower levels.
+    void cascade(uint32_t list);
+    /// Next tick where a slot must be cascaded or fired, or 0 if none.
+    uint64_t nextEvent() const;
+    /// Current tick of the steady clock.
+    uint64_t clockTick() const;
+    /// Start the Qt timer for a tick, unless it will wake up earlier.
+    void arm(uint64_t tick);
+    void onTimeout();
+
+    const int m_tickMs; ///< Resolution in milliseconds.
+    const int64_t m_originMs; ///< Steady clock time of tick 0.
+    uint64_t m_now; ///< Last processed tick.
+    size_t m_size; ///< Pending timers.
+    std::deque<Node> m_nodes; ///< Node pool, a deque so nodes stay put while called.
+    uint32_t m_free; ///< Head of the free list.
+    uint32_t m_heads[levels*slots + 1]; ///< List heads of slots and the firing list.
+    uint64_t m_occupied[levels]; ///< Bitmap of non-empty slots per level.
+    QPointer<QTimer> m_timer; ///< Drives the wheel, owned by the application.
+    uint64_t m_armedTick; ///< Tick the Qt timer is started for, while active.
+  };
+}
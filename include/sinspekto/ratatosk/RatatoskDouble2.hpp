@@ -5,6 +5,7 @@
 */
 
 #include "sinspekto/QtToDds.hpp"
+#include "sinspekto/DdsPublisher.hpp"
 #include "QDateTime"
 #include "QVector2D"
 
@@ -104,7 +105,7 @@ private:
    DDS signal type from a writable QML property.
 
 */
-class RatatoskDouble2Publisher : public QObject
+class RatatoskDouble2Publisher : public DdsPublisher
 {
   Q_OBJECT
   Q_PROPERTY(QVector2D value READ value WRITE setValue NOTIFY valueChanged) ///< DDS 2d-vector as QVector2D QML property.
@@ -171,6 +172,10 @@ public slots:
   */
   void publish();
 
+protected:
+  /// Writes the sample on DDS.
+  void writeSample() override;
+
 private:
   std::unique_ptr<sinspekto::Writer<ratatosk::types::Double2>> m_writer; ///< The DDS writer wrapper class.
 };
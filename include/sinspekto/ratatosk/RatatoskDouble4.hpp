@@ -5,6 +5,7 @@
 */
 
 #include "sinspekto/QtToDds.hpp"
+#include "sinspekto/DdsPublisher.hpp"
 #include "QDateTime"
 #include "QVector4D"
 
@@ -104,7 +105,7 @@ private:
    DDS signal type from a writable QML property.
 
 */
-class RatatoskDouble4Publisher : public QObject
+class RatatoskDouble4Publisher : public DdsPublisher
 {
   Q_OBJECT
   Q_PROPERTY(QVector4D value READ value WRITE setValue NOTIFY valueChanged) ///< DDS 3d-vector as QVector4D QML property.
@@ -171,6 +172,10 @@ public slots:
   */
   void publish();
 
+protected:
+  /// Writes the sample on DDS.
+  void writeSample() override;
+
 private:
   std::unique_ptr<sinspekto::Writer<ratatosk::types::Double4>> m_writer; ///< The DDS writer wrapper class.
 };
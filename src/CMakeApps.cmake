@@ -127,26 +127,33 @@ set_target_properties(${APP_NAME}
 
 
 #=====================
-# Sinspekto Publisher
+# Sinspekto Load generator
 
-add_executable(sinspekto-pub programs/publisher.cpp)
-target_link_libraries(sinspekto-pub PRIVATE
+add_executable(sinspekto-loadgen programs/publisher.cpp)
+target_link_libraries(sinspekto-loadgen PRIVATE
   sinspekto-api
-  sinspekto-fkin)
+  sinspekto-fkin
+  sinspekto-ratatosk)
 
-set_target_properties(sinspekto-pub
+set_target_properties(sinspekto-loadgen
   PROPERTIES
     DEBUG_POSTFIX ${CMAKE_DEBUG_POSTFIX})
 
 # This executable is not installed
 
 #======================
-# Sinspekto Subscriber
+# Sinspekto Probe
 
-add_executable(sinspekto-sub programs/subscriber.cpp)
-target_link_libraries(sinspekto-sub PRIVATE sinspekto-fkin)
+add_executable(sinspekto-probe programs/subscriber.cpp)
+target_link_libraries(sinspekto-probe PRIVATE
+  sinspekto-fkin
+  sinspekto-ratatosk)
 
-set_target_properties(sinspekto-sub
+# Only uses the header-only histogram of the library
+target_include_directories(sinspekto-probe PRIVATE
+  ${PROJECT_SOURCE_DIR}/include)
+
+set_target_properties(sinspekto-probe
   PROPERTIES
   DEBUG_POSTFIX ${CMAKE_DEBUG_POSTFIX})
 
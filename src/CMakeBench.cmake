@@ -0,0 +1,49 @@
+message(STATUS "Building benchmark applications")
+
+#======================
+# Sinspekto Benchmarks
+
+add_executable(sinspekto-bench programs/bench/bench.cpp)
+target_link_libraries(sinspekto-bench PRIVATE
+  sinspekto-api
+  Boost::boost
+  ${SINSPEKTO_QT_TARGETS})
+
+set_target_properties(sinspekto-bench
+  PROPERTIES
+  DEBUG_POSTFIX ${CMAKE_DEBUG_POSTFIX})
+
+# Writes bench.json to the build directory, compare two runs with --baseline
+add_custom_target(bench
+  COMMAND sinspekto-bench --output ${CMAKE_BINARY_DIR}/bench.json
+  DEPENDS sinspekto-bench
+  USES_TERMINAL)
+
+# This executable is not installed
+
+#==============================
+# Sinspekto Rendering Benchmark
+
+set(RESOURCES
+  qml/bench.qrc
+  ${PROJECT_SOURCE_DIR}/data/qtresources.qrc)
+
+add_executable(sinspekto-render-bench
+  programs/bench/render.cpp
+  ${RESOURCES})
+
+target_link_libraries(sinspekto-render-bench PRIVATE
+  ${SINSPEKTO_QT_TARGETS}
+  sinspekto-api)
+
+set_target_properties(sinspekto-render-bench
+  PROPERTIES
+  DEBUG_POSTFIX ${CMAKE_DEBUG_POSTFIX})
+
+# Renders offscreen, writes render-bench.json to the build directory
+add_custom_target(render-bench
+  COMMAND sinspekto-render-bench --output ${CMAKE_BINARY_DIR}/render-bench.json
+  DEPENDS sinspekto-render-bench
+  USES_TERMINAL)
+
+# This executable is not installed
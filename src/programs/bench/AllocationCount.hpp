@@ -0,0 +1,63 @@
+#pragma once
+/**
+   @file AllocationCount.hpp
+   @brief Counts heap allocations of a program, for benchmarks and tests.
+
+   With glibc, malloc, calloc and realloc are interposed, which also covers allocations
+   made inside Qt and the sinspekto library. Elsewhere only operator new is replaced, and
+   SINSPEKTO_COUNTS_MALLOC is 0.
+
+   @note Defines the allocation functions, so include it in one translation unit only.
+*/
+
+#include <atomic>
+#include <cinttypes>
+#include <cstdlib>
+#include <new>
+
+namespace sinspekto
+{
+  inline std::atomic<uint64_t> g_allocations(0); ///< Heap allocations since start.
+
+  /// Heap allocations since start.
+  inline uint64_t allocations() { return g_allocations.load(std::memory_order_relaxed); }
+}
+
+#if defined(__GLIBC__)
+#define SINSPEKTO_COUNTS_MALLOC 1
+extern "C"
+{
+  void *__libc_malloc(size_t size);
+  void *__libc_calloc(size_t count, size_t size);
+  void *__libc_realloc(void *ptr, size_t size);
+
+  void *malloc(size_t size) noexcept
+  {
+    sinspekto::g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+  }
+
+  void *calloc(size_t count, size_t size) noexcept
+  {
+    sinspekto::g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(count, size);
+  }
+
+  void *realloc(void *ptr, size_t size) noexcept
+  {
+    sinspekto::g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(ptr, size);
+  }
+}
+#else
+#define SINSPEKTO_COUNTS_MALLOC 0
+void *operator new(std::size_t size)
+{
+  sinspekto::g_allocations.fetch_add(1, std::memory_order_relaxed);
+  if(void *ptr = std::malloc(size ? size : 1)) return ptr;
+  throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+#endif
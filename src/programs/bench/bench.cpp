@@ -0,0 +1,505 @@
+/**
+   @file bench.cpp
+   @brief sinspekto-bench, microbenchmarks of the buffer and series hot paths.
+
+   Each benchmark runs its body repeatedly for at least --min-time milliseconds to find an
+   iteration count, and then measures --repetitions runs of that count. The median time
+   per iteration is reported, together with the time per item, e.g. per point or per
+   sample, and the number of heap allocations per iteration.
+
+   Allocations are counted by interposing malloc, calloc and realloc with glibc, which
+   also covers Qt containers. Elsewhere only operator new is counted. Steady state updates
+   of chart series through sinspekto::SeriesStaging are expected to allocate nothing in
+   sinspekto itself; allocations made by QXYSeries::replace() are included.
+
+   The results are written as JSON. Given a --baseline from an earlier run, benchmarks
+   that became slower than the tolerance allows, or that allocate more, are listed and
+   the program exits with status 1.
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLineSeries>
+#include <QSysInfo>
+
+#include "sinspekto/AxisEqualizer.hpp"
+#include "sinspekto/DdsBuffer.hpp"
+#include "sinspekto/QtToDds.hpp"
+#include "sinspekto/TimerWheel.hpp"
+#include "AllocationCount.hpp"
+
+QT_CHARTS_USE_NAMESPACE
+
+namespace
+{
+  const qml_enums::DimId dimIds[] = {
+    qml_enums::DimId::X, qml_enums::DimId::Y, qml_enums::DimId::Z,
+    qml_enums::DimId::W, qml_enums::DimId::PosX, qml_enums::DimId::PosY
+  };
+
+  const int64_t epochMs = 1700000000000; ///< Time of the first synthetic sample.
+
+  /// Buffer with synthetic samples instead of a DDS reader.
+  class BenchBuffer : public DdsBuffer
+  {
+  public:
+    BenchBuffer(int dims, int capacity)
+    {
+      for(int d = 0; d < dims; ++d)
+        m_buffers[dimIds[d]] = new DdsDoubleBuffer(this);
+      m_topic = "bench";
+      init(capacity);
+      for(auto& buf : m_buffers)
+        buf.second->setCapacity(capacity);
+    }
+
+    /// Append one sample to all dimensions.
+    void append(int64_t time, double value)
+    {
+      sinspekto::SeqLock::WriteGuard write(m_seqlock);
+      m_time->append(time);
+      for(auto& buf : m_buffers)
+        buf.second->append(value);
+    }
+
+    /// Append the elements of a batch, as the buffers do for Batch* types.
+    void appendBatch(const std::vector<int64_t>& time, const std::vector<double>& values)
+    {
+      sinspekto::SeqLock::WriteGuard write(m_seqlock);
+      for(size_t i = 0; i < time.size(); ++i)
+      {
+        m_time->append(time[i]);
+        for(auto& buf : m_buffers)
+          buf.second->append(values[i]);
+      }
+    }
+
+    /// Fill the buffer to capacity.
+    void fill()
+    {
+      for(size_t i = 0; i < m_time->Buffer().capacity(); ++i)
+        append(epochMs + static_cast<int64_t>(i), std::sin(0.01*static_cast<double>(i)));
+    }
+
+    void updateBuffers() override {}
+  };
+
+  struct Options
+  {
+    std::string filter; ///< Only run benchmarks whose name contains this.
+    double minTimeMs = 200.0; ///< Least time of the calibration run.
+    int repetitions = 5; ///< Measured runs, the median is reported.
+  };
+
+  struct Result
+  {
+    std::string name; ///< Name with parameters.
+    uint64_t iterations = 0; ///< Iterations per repetition.
+    double nsPerIteration = 0.0; ///< Median time per iteration.
+    double itemsPerIteration = 0.0; ///< Items processed per iteration.
+    double allocationsPerIteration = 0.0; ///< Heap allocations per iteration.
+  };
+
+  double elapsedNs(std::chrono::steady_clock::time_point start)
+  {
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  /// Runs benchmarks and collects their results.
+  class Runner
+  {
+  public:
+    explicit Runner(const Options& options) : m_options(options) {}
+
+    /**
+       @brief Measure a benchmark body.
+       @param[in] name Name with parameters, e.g. "ring_append/capacity=1000".
+       @param[in] items Items processed by one call of the body.
+       @param[in] body Benchmark body.
+    */
+    void run(const std::string& name, double items, const std::function<void()>& body)
+    {
+      if(!selected(name)) return;
+
+      // Warm up, so that reused storage is in place before counting allocations
+      body();
+      body();
+
+      uint64_t iterations = 1;
+      for(;;)
+      {
+        const auto start = std::chrono::steady_clock::now();
+        for(uint64_t i = 0; i < iterations; ++i) body();
+        if(elapsedNs(start) >= m_options.minTimeMs*1e6 || iterations >= (uint64_t(1) << 40)) break;
+        iterations *= 2;
+      }
+
+      std::vector<double> times;
+      const uint64_t allocations = sinspekto::allocations();
+      for(int r = 0; r < m_options.repetitions; ++r)
+      {
+        const auto start = std::chrono::steady_clock::now();
+        for(uint64_t i = 0; i < iterations; ++i) body();
+        times.push_back(elapsedNs(start)/static_cast<double>(iterations));
+      }
+      const uint64_t allocated = sinspekto::allocations() - allocations;
+      std::sort(times.begin(), times.end());
+
+      Result result;
+      result.name = name;
+      result.iterations = iterations;
+      result.nsPerIteration = times[times.size()/2];
+      result.itemsPerIteration = items;
+      result.allocationsPerIteration =
+       static_cast<double>(allocated)/static_cast<double>(iterations*static_cast<uint64_t>(m_options.repetitions));
+      m_results.push_back(result);
+
+      std::cerr
+        << std::left << std::setw(48) << name << std::right
+        << std::setw(14) << std::fixed << std::setprecision(1) << result.nsPerIteration << " ns"
+        << std::setw(12) << std::setprecision(3) << result.nsPerIteration/std::max(1.0, items) << " ns/item"
+        << std::setw(10) << std::setprecision(2) << result.allocationsPerIteration << " allocs"
+        << std::endl;
+    }
+
+    bool selected(const std::string& name) const
+    {
+      return m_options.filter.empty() || name.find(m_options.filter) != std::string::npos;
+    }
+
+    const std::vector<Result>& results() const { return m_results; }
+
+  private:
+    const Options& m_options;
+    std::vector<Result> m_results;
+  };
+
+  std::string param(const std::string& name, const char *key, long value)
+  {
+    return name + "/" + key + "=" + std::to_string(value);
+  }
+
+  void benchReplacePoints(Runner& runner)
+  {
+    for(int capacity : {1000, 10000, 100000})
+    {
+      boost::circular_buffer<int64_t> time(static_cast<size_t>(capacity));
+      boost::circular_buffer<double> x(static_cast<size_t>(capacity));
+      boost::circular_buffer<double> y(static_cast<size_t>(capacity));
+      for(int i = 0; i < capacity; ++i)
+      {
+        time.push_back(epochMs + i);
+        x.push_back(std::cos(0.01*i));
+        y.push_back(std::sin(0.01*i));
+      }
+
+      QLineSeries series;
+      sinspekto::SeriesStaging staging;
+
+      runner.run(param("replace_data_points", "capacity", capacity), capacity,
+       [&]() { sinspekto::replace_data_points(time, y, &series, staging); });
+      runner.run(param("replace_data_points_unstaged", "capacity", capacity), capacity,
+       [&]() { sinspekto::replace_data_points(time, y, &series); });
+      runner.run(param("replace_double_points", "capacity", capacity), capacity,
+       [&]() { sinspekto::replace_double_points(x, y, &series, staging); });
+    }
+  }
+
+  void benchUpdateSeries(Runner& runner)
+  {
+    for(int capacity : {1000, 10000, 100000})
+    {
+      for(int dims : {1, 3, 6})
+      {
+        const std::string name = param(param("update_series", "capacity", capacity), "dims", dims);
+        if(!runner.selected(name)) continue;
+
+        BenchBuffer buffer(dims, capacity);
+        buffer.fill();
+        std::vector<std::unique_ptr<QLineSeries>> series;
+        for(int d = 0; d < dims; ++d)
+          series.push_back(std::make_unique<QLineSeries>());
+
+        runner.run(name, static_cast<double>(capacity)*dims,
+         [&]()
+         {
+           for(int d = 0; d < dims; ++d)
+             buffer.updateSeries(series[static_cast<size_t>(d)].get(), qml_enums::DimId::T, dimIds[d]);
+         });
+      }
+    }
+  }
+
+  void benchRingAppend(Runner& runner)
+  {
+    const int chunk = 1000;
+    for(int capacity : {1000, 100000})
+    {
+      for(bool statistics : {false, true})
+      {
+        DdsDoubleBuffer buffer;
+        buffer.setCapacity(capacity);
+        buffer.setStatistics(statistics);
+        for(int i = 0; i < capacity; ++i) buffer.append(std::sin(0.01*i));
+
+        double value = 0.0;
+        runner.run(param(param("ring_append", "capacity", capacity), "statistics", statistics), chunk,
+         [&]()
+         {
+           // Full buffer, each append evicts the oldest value
+           for(int i = 0; i < chunk; ++i) buffer.append(value += 0.001);
+         });
+      }
+
+      DdsTimepointBuffer time;
+      time.setCapacity(capacity);
+      int64_t t = epochMs;
+      for(int i = 0; i < capacity; ++i) time.append(t++);
+      runner.run(param("timepoint_append", "capacity", capacity), chunk,
+       [&]() { for(int i = 0; i < chunk; ++i) time.append(t++); });
+    }
+  }
+
+  void benchBatchIngest(Runner& runner)
+  {
+    const int samples = 1000;
+    for(int batch : {1, 10, 100, 1000})
+    {
+      BenchBuffer buffer(3, 10000);
+      buffer.fill();
+
+      std::vector<int64_t> time(static_cast<size_t>(batch));
+      std::vector<double> values(static_cast<size_t>(batch), 1.0);
+      int64_t t = epochMs;
+
+      runner.run(param("batch_ingest", "batch", batch), samples,
+       [&]()
+       {
+         for(int n = 0; n < samples; n += batch)
+         {
+           for(auto& stamp : time) stamp = t++;
+           buffer.appendBatch(time, values);
+         }
+       });
+    }
+  }
+
+  void benchRegisterBox(Runner& runner)
+  {
+    for(int count : {10, 100, 1000})
+    {
+      AxisEqualizer equalizer;
+      std::vector<QString> names;
+      for(int i = 0; i < count; ++i)
+        names.push_back(QString("series%1").arg(i));
+
+      double shift = 0.0;
+      runner.run(param("register_box", "series", count), count,
+       [&]()
+       {
+         shift += 0.5;
+         for(int i = 0; i < count; ++i)
+           equalizer.registerBox(names[static_cast<size_t>(i)], QPointF(i, i + shift), QPointF(-shift, shift));
+       });
+    }
+  }
+
+  void benchTimerWheel(Runner& runner)
+  {
+    for(int count : {1000, 100000})
+    {
+      const std::string name = param("timer_wheel", "timers", count);
+      if(!runner.selected(name)) continue;
+
+      std::mt19937 rng(1);
+      std::uniform_int_distribution<int64_t> delay(1, 60000);
+      std::vector<int64_t> delays(static_cast<size_t>(count));
+      for(auto& d : delays) d = delay(rng);
+
+      const int64_t startMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+          std::chrono::steady_clock::now().time_since_epoch()).count();
+      sinspekto::TimerWheel wheel(1);
+      std::vector<sinspekto::TimerWheel::TimerId> ids(static_cast<size_t>(count));
+      int64_t virtualMs = 0;
+      uint64_t fired = 0;
+
+      runner.run(name, count,
+       [&]()
+       {
+         // Schedule all, cancel every other, and run the wheel past the last deadline
+         for(size_t i = 0; i < delays.size(); ++i)
+           ids[i] = wheel.schedule(delays[i], [&fired]() { ++fired; });
+         for(size_t i = 0; i < ids.size(); i += 2)
+           wheel.cancel(ids[i]);
+         virtualMs += 70000;
+         wheel.advance(startMs + virtualMs);
+       });
+
+      if(wheel.size() != 0)
+        std::cerr << name << ": " << wheel.size() << " timers did not fire" << std::endl;
+    }
+  }
+
+  QJsonDocument toJson(const std::vector<Result>& results)
+  {
+    QJsonArray benchmarks;
+    for(const Result& result : results)
+    {
+      benchmarks.append(QJsonObject{
+        { "name", QString::fromStdString(result.name) },
+        { "iterations", static_cast<qint64>(result.iterations) },
+        { "ns_per_iteration", result.nsPerIteration },
+        { "items_per_iteration", result.itemsPerIteration },
+        { "ns_per_item", result.nsPerIteration/std::max(1.0, result.itemsPerIteration) },
+        { "allocations_per_iteration", result.allocationsPerIteration }
+      });
+    }
+
+    const QJsonObject context{
+      { "date", QDateTime::currentDateTimeUtc().toString(Qt::ISODate) },
+      { "host", QSysInfo::machineHostName() },
+      { "cpu", QSysInfo::currentCpuArchitecture() },
+      { "qt", qVersion() },
+      { "counts_malloc", SINSPEKTO_COUNTS_MALLOC != 0 }
+    };
+    return QJsonDocument(QJsonObject{ { "context", context }, { "benchmarks", benchmarks } });
+  }
+
+  /// Compare with a baseline, return the number of regressions.
+  int compare(const std::vector<Result>& results, const QString& baselineFile, double tolerance)
+  {
+    QFile file(baselineFile);
+    if(!file.open(QIODevice::ReadOnly))
+    {
+      std::cerr << "Cannot read baseline " << baselineFile.toStdString() << std::endl;
+      return 1;
+    }
+
+    QJsonObject baseline;
+    for(const auto& entry : QJsonDocument::fromJson(file.readAll()).object()["benchmarks"].toArray())
+    {
+      const QJsonObject benchmark = entry.toObject();
+      baseline[benchmark["name"].toString()] = benchmark;
+    }
+
+    int regressions = 0;
+    for(const Result& result : results)
+    {
+      const QJsonObject base = baseline[QString::fromStdString(result.name)].toObject();
+      if(base.isEmpty()) continue;
+
+      const double baseNs = base["ns_per_iteration"].toDouble();
+      const double baseAllocations = base["allocations_per_iteration"].toDouble();
+      if(result.nsPerIteration > baseNs*(1.0 + tolerance))
+      {
+        std::cerr << "Regression: " << result.name << " " << baseNs << " ns -> "
+                  << result.nsPerIteration << " ns" << std::endl;
+        ++regressions;
+      }
+      // Counts may include a stray allocation from Qt, allow less than one per iteration
+      if(result.allocationsPerIteration >= baseAllocations + 1.0)
+      {
+        std::cerr << "Regression: " << result.name << " " << baseAllocations << " allocations -> "
+                  << result.allocationsPerIteration << " allocations" << std::endl;
+        ++regressions;
+      }
+    }
+    return regressions;
+  }
+
+  void usage(const char *program)
+  {
+    std::cout
+      << "Usage: " << program << " [options]\n"
+      << "\n"
+      << "Options:\n"
+      << "  --filter <text>      Only run benchmarks whose name contains text\n"
+      << "  --min-time <ms>      Least calibration time per benchmark (default 200)\n"
+      << "  --repetitions <n>    Measured runs per benchmark, median is reported (default 5)\n"
+      << "  --output <file>      Write JSON to file instead of standard output\n"
+      << "  --baseline <file>    Exit with status 1 on regressions against an earlier output\n"
+      << "  --tolerance <f>      Allowed relative slowdown against the baseline (default 0.25)\n"
+      << "\n"
+      << "Benchmarks: replace_data_points, replace_data_points_unstaged, replace_double_points,\n"
+      << "            update_series, ring_append, timepoint_append, batch_ingest,\n"
+      << "            register_box, timer_wheel\n";
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  Options options;
+  std::string output;
+  std::string baseline;
+  double tolerance = 0.25;
+
+  for(int i = 1; i < argc; ++i)
+  {
+    const std::string arg = argv[i];
+    const bool hasValue = i + 1 < argc;
+    if(arg == "-h" || arg == "--help")
+    {
+      usage(argv[0]);
+      return 0;
+    }
+    else if(arg == "--filter" && hasValue) options.filter = argv[++i];
+    else if(arg == "--min-time" && hasValue) options.minTimeMs = std::atof(argv[++i]);
+    else if(arg == "--repetitions" && hasValue) options.repetitions = std::max(1, std::atoi(argv[++i]));
+    else if(arg == "--output" && hasValue) output = argv[++i];
+    else if(arg == "--baseline" && hasValue) baseline = argv[++i];
+    else if(arg == "--tolerance" && hasValue) tolerance = std::atof(argv[++i]);
+    else
+    {
+      std::cerr << "Invalid argument: " << arg << std::endl;
+      usage(argv[0]);
+      return 1;
+    }
+  }
+
+  // Buffers and the timer wheel create Qt objects that expect an application
+  QCoreApplication app(argc, argv);
+
+  Runner runner(options);
+  benchReplacePoints(runner);
+  benchUpdateSeries(runner);
+  benchRingAppend(runner);
+  benchBatchIngest(runner);
+  benchRegisterBox(runner);
+  benchTimerWheel(runner);
+
+  const QByteArray json = toJson(runner.results()).toJson();
+  if(output.empty())
+    std::cout << json.toStdString();
+  else
+  {
+    QFile file(QString::fromStdString(output));
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+      std::cerr << "Cannot write " << output << std::endl;
+      return 1;
+    }
+    file.write(json);
+  }
+
+  if(!baseline.empty() && compare(runner.results(), QString::fromStdString(baseline), tolerance) > 0)
+    return 1;
+  return 0;
+}
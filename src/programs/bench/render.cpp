@@ -0,0 +1,600 @@
+/**
+   @file render.cpp
+   @brief sinspekto-render-bench, frame times of TimeChart and NorthEast dashboards.
+
+   Loads a dashboard of --buffers TimeChart panels, each showing its own
+   DdsIdVec1dBuffer, and a NorthEast map of a DdsKinematics2DBuffer. The window is
+   rendered with the offscreen platform plugin, unless QT_QPA_PLATFORM says otherwise, and
+   with the software scene graph when offscreen, unless QT_QUICK_BACKEND says otherwise.
+
+   The signals are published at --rate samples per second from a thread of their own,
+   through the publishers of the library and the in-process loopback transport. With
+   --dds the dashboard subscribes to a DDS domain instead, to be fed by sinspekto-loadgen,
+   e.g. ``sinspekto-loadgen idvec1d:benchSignal,ids=8,id=signal,rate=50``.
+
+   After --warmup seconds, the following is measured for --duration seconds:
+
+   - Frame interval and scene graph render time, mean and percentiles.
+   - CPU time of the GUI thread and of the process, in percent of one core.
+   - Points handed to series per second, from SinspektoMetrics.
+   - Samples published per second.
+   - Largest latency of the GUI event loop, from EventLoopMonitor.
+   - With --latency, the DdsLatencyTrace summary of the topics.
+
+   The results are written as JSON, and a summary line to standard error.
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <QApplication>
+#include <QDateTime>
+#include <QFile>
+#include <QFontDatabase>
+#include <QGuiApplication>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QQmlComponent>
+#include <QQmlContext>
+#include <QQmlEngine>
+#include <QQuickWindow>
+#include <QSGRendererInterface>
+#include <QSysInfo>
+#include <QThread>
+#include <QTimer>
+#include <QUrl>
+#include <QVector2D>
+#include <QDebug>
+
+#include "sinspekto/DdsIdVec1d.hpp"
+#include "sinspekto/DdsKinematics2D.hpp"
+#include "sinspekto/DdsLatencyTrace.hpp"
+#include "sinspekto/EventLoopMonitor.hpp"
+#include "sinspekto/QtToDds.hpp"
+#include "sinspekto/SinspektoMetrics.hpp"
+#include "sinspekto/SinspektoQml.hpp"
+
+namespace
+{
+  using Clock = std::chrono::steady_clock;
+
+  const double two_pi = 6.283185307179586;
+
+  struct Options
+  {
+    int buffers = 8; ///< Number of TimeChart panels.
+    double rate = 50.0; ///< Samples per second of each signal.
+    int capacity = 1000; ///< Buffer size of every buffer.
+    double warmupS = 2.0; ///< Seconds before measuring.
+    double durationS = 10.0; ///< Seconds of measurement.
+    QString mode = "series"; ///< "series" or "item".
+    bool batch = false; ///< Publish and subscribe Batch* types.
+    bool map = true; ///< Show the NorthEast map.
+    bool latency = false; ///< Enable DdsLatencyTrace.
+    int columns = 2; ///< Columns of the grid of panels.
+    int width = 1920; ///< Window width in pixels.
+    int height = 1080; ///< Window height in pixels.
+    int domain = -1; ///< DDS domain, negative for the loopback transport.
+  };
+
+  /// Nanoseconds between two time points.
+  double nanos(Clock::duration duration)
+  {
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+  }
+
+  /// CPU time of the calling thread in seconds, negative if not available.
+  double threadCpuSeconds()
+  {
+#if defined(CLOCK_THREAD_CPUTIME_ID)
+    timespec now;
+    if(clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now) == 0)
+      return static_cast<double>(now.tv_sec) + 1e-9*static_cast<double>(now.tv_nsec);
+#endif
+    return -1.0;
+  }
+
+  /// CPU time of the process in seconds.
+  double processCpuSeconds()
+  {
+    return static_cast<double>(std::clock())/CLOCKS_PER_SEC;
+  }
+
+  /// Points handed to series by all adapters since they were attached.
+  uint64_t pointsUploaded()
+  {
+    SinspektoMetrics& metrics = SinspektoMetrics::instance();
+    metrics.refresh();
+
+    uint64_t points = 0;
+    for(int row = 0; row < metrics.rowCount(); ++row)
+      points += metrics.data(metrics.index(row), SinspektoMetrics::PointsUploadedRole).toULongLong();
+    return points;
+  }
+
+  /// Mean, percentiles and max of durations in milliseconds.
+  QJsonObject percentiles(std::vector<double> values)
+  {
+    if(values.empty())
+      return QJsonObject{ { "count", 0 } };
+
+    std::sort(values.begin(), values.end());
+    double sum = 0.0;
+    for(double value : values) sum += value;
+    // Nearest rank
+    auto at = [&values](double p)
+    {
+      const size_t rank = static_cast<size_t>(std::ceil(p*static_cast<double>(values.size())));
+      return values[std::min(values.size() - 1, rank > 0 ? rank - 1 : 0)];
+    };
+
+    return QJsonObject{
+      { "count", static_cast<qint64>(values.size()) },
+      { "mean", sum/static_cast<double>(values.size()) },
+      { "p50", at(0.50) },
+      { "p90", at(0.90) },
+      { "p99", at(0.99) },
+      { "max", values.back() }
+    };
+  }
+
+  /**
+     @brief Frame intervals and render times of a window.
+
+     The signals of the window come from the render thread with the threaded render loop,
+     so the samples are guarded by a mutex.
+  */
+  class FrameStats
+  {
+  public:
+    explicit FrameStats(QQuickWindow *window) :
+      m_recording(false)
+    {
+      QObject::connect(window, &QQuickWindow::beforeRendering,
+                       [this]() { m_renderStart = Clock::now(); });
+      QObject::connect(window, &QQuickWindow::afterRendering,
+                       [this]()
+                       {
+                         const double ms = 1e-6*nanos(Clock::now() - m_renderStart);
+                         std::lock_guard<std::mutex> lock(m_mutex);
+                         if(m_recording) m_renderMs.push_back(ms);
+                       });
+      QObject::connect(window, &QQuickWindow::frameSwapped,
+                       [this]()
+                       {
+                         const Clock::time_point now = Clock::now();
+                         std::lock_guard<std::mutex> lock(m_mutex);
+                         if(m_recording && m_lastSwap != Clock::time_point())
+                           m_intervalMs.push_back(1e-6*nanos(now - m_lastSwap));
+                         m_lastSwap = now;
+                       });
+    }
+
+    /// Start recording, discarding earlier frames.
+    void start()
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_intervalMs.clear();
+      m_renderMs.clear();
+      m_recording = true;
+    }
+
+    /// Stop recording.
+    void stop()
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_recording = false;
+    }
+
+    /// Frame intervals in milliseconds.
+    std::vector<double> intervals() const
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      return m_intervalMs;
+    }
+
+    /// Render times in milliseconds.
+    std::vector<double> renders() const
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      return m_renderMs;
+    }
+
+  private:
+    mutable std::mutex m_mutex; ///< Guards the samples and m_lastSwap.
+    bool m_recording; ///< Samples are kept.
+    Clock::time_point m_renderStart; ///< Start of the current render, render thread only.
+    Clock::time_point m_lastSwap; ///< Previous frameSwapped().
+    std::vector<double> m_intervalMs; ///< Intervals between frames swapped.
+    std::vector<double> m_renderMs; ///< Durations from beforeRendering to afterRendering.
+  };
+
+  /**
+     @brief Publishes the signals of the dashboard from a thread of its own.
+
+     The samples of all signals are due at the same instants, such that the readers see
+     rate samples per second regardless of how late a tick of the timer is. The values
+     are sines with a phase per signal, and the vessel sails a circle.
+
+     The publishers are not rate limited and write synchronously, so they do not use the
+     timer wheel of the GUI thread.
+  */
+  class Generator
+  {
+  public:
+    Generator(QtToDds *dds, const Options& options) :
+      m_dds(dds),
+      m_options(options),
+      m_sent(0),
+      m_published(0)
+    {}
+
+    ~Generator() { stop(); }
+
+    /// Create the publishers on the thread and start publishing.
+    void start()
+    {
+      m_thread.start();
+      m_timer.moveToThread(&m_thread);
+      QObject::connect(&m_timer, &QTimer::timeout, &m_timer, [this]() { tick(); });
+      QMetaObject::invokeMethod(&m_timer, [this]() { setup(); }, Qt::BlockingQueuedConnection);
+    }
+
+    /// Stop publishing and destroy the publishers on the thread.
+    void stop()
+    {
+      if(!m_thread.isRunning()) return;
+      QMetaObject::invokeMethod(
+          &m_timer,
+          [this]()
+          {
+            m_timer.stop();
+            m_signals.clear();
+            m_batchSignals.clear();
+            m_vessel.reset();
+            m_batchVessel.reset();
+            m_timer.moveToThread(QCoreApplication::instance()->thread());
+          },
+          Qt::BlockingQueuedConnection);
+      m_thread.quit();
+      m_thread.wait();
+    }
+
+    /// Samples published since start.
+    uint64_t published() const { return m_published.load(std::memory_order_relaxed); }
+
+  private:
+    void setup()
+    {
+      for(int i = 0; i < m_options.buffers; ++i)
+      {
+        const QString id = QStringLiteral("signal%1").arg(i);
+        if(m_options.batch)
+        {
+          m_batchSignals.push_back(std::make_unique<DdsBatchIdVec1dPublisher>());
+          m_batchSignals.back()->init(m_dds, "benchSignal", id);
+        }
+        else
+        {
+          m_signals.push_back(std::make_unique<DdsIdVec1dPublisher>());
+          m_signals.back()->init(m_dds, "benchSignal", id, 0.0, false);
+        }
+      }
+
+      if(m_options.map && m_options.batch)
+      {
+        m_batchVessel = std::make_unique<DdsBatchKinematics2DPublisher>();
+        m_batchVessel->init(m_dds, "benchKinematics2D", "Vessel");
+      }
+      else if(m_options.map)
+      {
+        m_vessel = std::make_unique<DdsKinematics2DPublisher>();
+        m_vessel->init(m_dds, "benchKinematics2D", "Vessel");
+      }
+
+      m_start = Clock::now();
+      m_startMs = QDateTime::currentMSecsSinceEpoch();
+      m_timer.setTimerType(Qt::PreciseTimer);
+      m_timer.start(std::max(1, std::min(20, static_cast<int>(1000.0/m_options.rate))));
+    }
+
+    void tick()
+    {
+      const double elapsedS = 1e-9*nanos(Clock::now() - m_start);
+      const uint64_t due = static_cast<uint64_t>(elapsedS*m_options.rate);
+
+      for(; m_sent < due; ++m_sent)
+      {
+        const double t = static_cast<double>(m_sent)/m_options.rate;
+        const QDateTime timestamp = QDateTime::fromMSecsSinceEpoch(
+            m_startMs + static_cast<qint64>(1000.0*t));
+
+        for(size_t i = 0; i < m_signals.size(); ++i)
+          m_signals[i]->setValue(std::sin(two_pi*t/10.0 + static_cast<double>(i)));
+        for(size_t i = 0; i < m_batchSignals.size(); ++i)
+          m_batchSignals[i]->append(std::sin(two_pi*t/10.0 + static_cast<double>(i)), timestamp);
+
+        const double angle = two_pi*t/60.0;
+        const QVector2D position(40.0f*static_cast<float>(std::cos(angle)),
+                                 40.0f*static_cast<float>(std::sin(angle)));
+        const double speed = 40.0*two_pi/60.0;
+        const double course = std::fmod(angle + two_pi/4.0, two_pi);
+        if(m_vessel)
+        {
+          m_vessel->beginUpdate();
+          m_vessel->setPosition(position);
+          m_vessel->setSpeed(speed);
+          m_vessel->setCourse(course);
+          m_vessel->commit();
+        }
+        if(m_batchVessel)
+          m_batchVessel->append(position, speed, course, timestamp);
+
+        const size_t written = m_signals.size() + m_batchSignals.size()
+          + (m_vessel || m_batchVessel ? 1 : 0);
+        m_published.fetch_add(written, std::memory_order_relaxed);
+      }
+    }
+
+    QtToDds *m_dds; ///< Participant in loopback mode.
+    Options m_options; ///< Rates and number of signals.
+    QThread m_thread; ///< Thread of the publishers.
+    QTimer m_timer; ///< Periodic tick, lives on m_thread.
+    Clock::time_point m_start; ///< Time of the first sample.
+    qint64 m_startMs; ///< Timestamp of the first sample.
+    uint64_t m_sent; ///< Samples of each signal published so far.
+    std::atomic<uint64_t> m_published; ///< Samples of all signals published.
+    std::vector<std::unique_ptr<DdsIdVec1dPublisher>> m_signals; ///< Publishers without --batch.
+    std::vector<std::unique_ptr<DdsBatchIdVec1dPublisher>> m_batchSignals; ///< Publishers with --batch.
+    std::unique_ptr<DdsKinematics2DPublisher> m_vessel; ///< Vessel without --batch.
+    std::unique_ptr<DdsBatchKinematics2DPublisher> m_batchVessel; ///< Vessel with --batch.
+  };
+
+  void usage(const char *program)
+  {
+    std::cout
+      << "Usage: " << program << " [options]\n"
+      << "\n"
+      << "Options:\n"
+      << "  --buffers <n>        Number of TimeChart panels, one buffer each (default 8)\n"
+      << "  --rate <Hz>          Samples per second of each signal (default 50)\n"
+      << "  --capacity <n>       Buffer size of every buffer (default 1000)\n"
+      << "  --mode <mode>        series: LineSeries updated by updateSeries(),\n"
+      << "                       item: DdsLineSeries (default series)\n"
+      << "  --batch              Publish and subscribe the Batch* types\n"
+      << "  --no-map             Leave out the NorthEast map\n"
+      << "  --latency            Enable DdsLatencyTrace and report its summary\n"
+      << "  --columns <n>        Columns of the grid of panels (default 2)\n"
+      << "  --size <w>x<h>       Window size in pixels (default 1920x1080)\n"
+      << "  --warmup <s>         Seconds before measuring (default 2)\n"
+      << "  --duration <s>       Seconds of measurement (default 10)\n"
+      << "  --dds <domain>       Subscribe to a DDS domain instead of publishing on loopback\n"
+      << "  --output <file>      Write JSON to file instead of standard output\n";
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  Options options;
+  std::string output;
+
+  for(int i = 1; i < argc; ++i)
+  {
+    const std::string arg = argv[i];
+    const bool hasValue = i + 1 < argc;
+    if(arg == "-h" || arg == "--help")
+    {
+      usage(argv[0]);
+      return 0;
+    }
+    else if(arg == "--buffers" && hasValue) options.buffers = std::max(0, std::atoi(argv[++i]));
+    else if(arg == "--rate" && hasValue) options.rate = std::max(0.1, std::atof(argv[++i]));
+    else if(arg == "--capacity" && hasValue) options.capacity = std::max(2, std::atoi(argv[++i]));
+    else if(arg == "--mode" && hasValue) options.mode = QString::fromLocal8Bit(argv[++i]);
+    else if(arg == "--batch") options.batch = true;
+    else if(arg == "--no-map") options.map = false;
+    else if(arg == "--latency") options.latency = true;
+    else if(arg == "--columns" && hasValue) options.columns = std::max(1, std::atoi(argv[++i]));
+    else if(arg == "--size" && hasValue &&
+            std::sscanf(argv[i + 1], "%dx%d", &options.width, &options.height) == 2) ++i;
+    else if(arg == "--warmup" && hasValue) options.warmupS = std::max(0.0, std::atof(argv[++i]));
+    else if(arg == "--duration" && hasValue) options.durationS = std::max(0.1, std::atof(argv[++i]));
+    else if(arg == "--dds" && hasValue) options.domain = std::max(0, std::atoi(argv[++i]));
+    else if(arg == "--output" && hasValue) output = argv[++i];
+    else
+    {
+      std::cerr << "Invalid argument: " << arg << std::endl;
+      usage(argv[0]);
+      return 1;
+    }
+  }
+
+  if(options.mode != "series" && options.mode != "item")
+  {
+    std::cerr << "Invalid mode: " << options.mode.toStdString() << std::endl;
+    return 1;
+  }
+
+  // Render without a display, with the scene graph backend available everywhere
+  if(qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+  if(qgetenv("QT_QPA_PLATFORM") == "offscreen" && qEnvironmentVariableIsEmpty("QT_QUICK_BACKEND"))
+    QQuickWindow::setSceneGraphBackend(QSGRendererInterface::Software);
+
+  QApplication app(argc, argv);
+
+  qint32 fontId = QFontDatabase::addApplicationFont(":/fonts/PublicSans-VariableFont_wght.ttf");
+  QStringList fontList = QFontDatabase::applicationFontFamilies(fontId);
+  if(!fontList.isEmpty())
+    QApplication::setFont(QFont(fontList.at(0)));
+
+  sinspekto::LoadSinspektoQmlTypes();
+
+  QtToDds dds;
+  if(options.domain >= 0)
+    dds.init(options.domain);
+  else
+    dds.initLoopback(0);
+
+  QQmlEngine engine;
+  QQmlContext *context = engine.rootContext();
+  context->setContextProperty("benchDds", &dds);
+  context->setContextProperty("benchBuffers", options.buffers);
+  context->setContextProperty("benchCapacity", options.capacity);
+  context->setContextProperty("benchBatch", options.batch);
+  context->setContextProperty("benchMode", options.mode);
+  context->setContextProperty("benchMap", options.map);
+  context->setContextProperty("benchColumns", options.columns);
+  // Show the whole buffer
+  context->setContextProperty("benchWidthMS",
+                              std::max(2000, static_cast<int>(1000.0*options.capacity/options.rate)));
+
+  QQmlComponent component(&engine);
+  component.loadUrl(QUrl(QStringLiteral("qrc:/render_bench.qml")));
+  std::unique_ptr<QObject> root(component.isReady() ? component.create() : nullptr);
+  QQuickWindow *window = qobject_cast<QQuickWindow*>(root.get());
+  if(!window)
+  {
+    qWarning() << component.errorString();
+    return 1;
+  }
+  window->resize(options.width, options.height);
+
+  FrameStats frames(window);
+
+  double eventLoopLatencyMs = 0.0;
+  EventLoopMonitor& monitor = EventLoopMonitor::instance();
+  QObject::connect(&monitor, &EventLoopMonitor::statisticsChanged, &monitor,
+                   [&monitor, &eventLoopLatencyMs]()
+                   {
+                     eventLoopLatencyMs = std::max(eventLoopLatencyMs, monitor.latencyMs());
+                   });
+
+  Generator generator(&dds, options);
+  if(options.domain < 0)
+    generator.start();
+
+  // Measurement window
+  Clock::time_point startTime;
+  double startGuiCpu = 0.0;
+  double startProcessCpu = 0.0;
+  uint64_t startPoints = 0;
+  uint64_t startPublished = 0;
+
+  QJsonObject results;
+
+  QTimer::singleShot(static_cast<int>(1000.0*options.warmupS), &app, [&]()
+  {
+    if(options.latency)
+    {
+      DdsLatencyTrace::instance().setEnabled(true);
+      DdsLatencyTrace::instance().watchWindow(window);
+      DdsLatencyTrace::instance().reset();
+    }
+    monitor.setEnabled(true);
+    eventLoopLatencyMs = 0.0;
+
+    startPoints = pointsUploaded();
+    startPublished = generator.published();
+    startGuiCpu = threadCpuSeconds();
+    startProcessCpu = processCpuSeconds();
+    startTime = Clock::now();
+    frames.start();
+  });
+
+  QTimer::singleShot(static_cast<int>(1000.0*(options.warmupS + options.durationS)), &app, [&]()
+  {
+    frames.stop();
+    const double elapsedS = 1e-9*nanos(Clock::now() - startTime);
+    const double guiCpu = threadCpuSeconds();
+    const double processCpu = processCpuSeconds();
+    const uint64_t points = pointsUploaded() - startPoints;
+    const uint64_t published = generator.published() - startPublished;
+    monitor.setEnabled(false);
+
+    const std::vector<double> intervals = frames.intervals();
+    results = QJsonObject{
+      { "seconds", elapsedS },
+      { "frames", static_cast<qint64>(intervals.size()) },
+      { "frames_per_second", static_cast<double>(intervals.size())/elapsedS },
+      { "frame_interval_ms", percentiles(intervals) },
+      { "render_ms", percentiles(frames.renders()) },
+      { "gui_cpu_percent", startGuiCpu < 0.0 ? QJsonValue() : QJsonValue(100.0*(guiCpu - startGuiCpu)/elapsedS) },
+      { "process_cpu_percent", 100.0*(processCpu - startProcessCpu)/elapsedS },
+      { "points_uploaded", static_cast<qint64>(points) },
+      { "points_per_second", static_cast<double>(points)/elapsedS },
+      { "samples_published", static_cast<qint64>(published) },
+      { "samples_per_second", static_cast<double>(published)/elapsedS },
+      { "event_loop_latency_ms_max", eventLoopLatencyMs }
+    };
+
+    if(options.latency)
+    {
+      QJsonObject latency;
+      for(const QString& topic : DdsLatencyTrace::instance().topics())
+        latency[topic] = QJsonObject::fromVariantMap(DdsLatencyTrace::instance().summary(topic));
+      results["latency"] = latency;
+      DdsLatencyTrace::instance().setEnabled(false);
+    }
+
+    app.quit();
+  });
+
+  app.exec();
+  generator.stop();
+  // The window signals the frame statistics until it is gone
+  root.reset();
+
+  const QJsonObject config{
+    { "buffers", options.buffers },
+    { "rate", options.rate },
+    { "capacity", options.capacity },
+    { "mode", options.mode },
+    { "batch", options.batch },
+    { "map", options.map },
+    { "width", options.width },
+    { "height", options.height },
+    { "source", options.domain < 0 ? QString("loopback") : QString("dds:%1").arg(options.domain) }
+  };
+  const QJsonObject env{
+    { "date", QDateTime::currentDateTimeUtc().toString(Qt::ISODate) },
+    { "host", QSysInfo::machineHostName() },
+    { "cpu", QSysInfo::currentCpuArchitecture() },
+    { "qt", qVersion() },
+    { "platform", QGuiApplication::platformName() },
+    { "backend", QQuickWindow::sceneGraphBackend().isEmpty() ?
+                 QString("default") : QQuickWindow::sceneGraphBackend() }
+  };
+
+  const QJsonObject intervals = results["frame_interval_ms"].toObject();
+  std::cerr << options.buffers << " buffers at " << options.rate << " Hz, "
+            << results["frames_per_second"].toDouble() << " fps, frame p99 "
+            << intervals["p99"].toDouble() << " ms, "
+            << results["points_per_second"].toDouble() << " points/s" << std::endl;
+
+  const QByteArray json = QJsonDocument(QJsonObject{
+      { "context", env }, { "config", config }, { "results", results } }).toJson();
+  if(output.empty())
+    std::cout << json.toStdString();
+  else
+  {
+    QFile file(QString::fromStdString(output));
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+      std::cerr << "Cannot write " << output << std::endl;
+      return 1;
+    }
+    file.write(json);
+  }
+  return 0;
+}
@@ -1,59 +1,686 @@
+/**
+   @file publisher.cpp
+   @brief sinspekto-loadgen, publishes synthetic DDS traffic at configurable rates.
+
+   Each stream is given on the command line as
+
+     <type>:<topic>[,key=value...]
+
+   with the keys
+
+     rate=<Hz>       Samples per second for each id (default 10).
+     ids=<n>         Number of instances with ids <id>0 .. <id>n-1 (default 1).
+     id=<prefix>     Prefix of instance ids (default "id"), or the full id if ids=1.
+     batch=<n>       Samples per message for Batch* types (default 100).
+     shape=<name>    Payload: sine, ramp, square, random or const (default sine).
+     amplitude=<a>   Amplitude of the payload (default 1).
+     offset=<o>      Offset of the payload (default 0).
+     period=<s>      Period of the payload in seconds (default 10).
+     recipient=<r>   Recipient of command (default "you").
+
+   Types: command, bit, real, idvec1d, idvec2d, idvec3d, idvec4d, kinematics2d,
+   kinematics6d, batchidvec1d, batchkinematics2d, batchkinematics6d, doubleval,
+   double2, double3, double4.
+
+   The payload only depends on the time since start, the id and the seed, so that a run
+   can be repeated. Without streams it toggles a command on fkinReal every 500 ms.
+*/
+
 #ifdef _MSC_VER
 #pragma warning(push, 0)
 #endif
 #include "FKIN/fkin_types_DCPS.hpp"
+#include "Ratatosk/basic_types_DCPS.hpp"
 #include <dds/domain/DomainParticipant.hpp>
 #include <dds/pub/Publisher.hpp>
 #ifdef _MSC_VER
 #pragma warning(pop)
 #endif
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
 #include <thread>
+#include <type_traits>
+#include <vector>
 
 #include "sinspekto/sinspekto.hpp"
 
-int main(int argc, char *argv[])
+namespace
 {
-  auto domainParticipant = dds::domain::DomainParticipant(0);
-  auto publisher = dds::pub::Publisher(domainParticipant);
+  using Clock = std::chrono::steady_clock;
+
+  std::atomic<bool> g_running(true);
+
+  void stop(int) { g_running = false; }
+
+  /// Milliseconds since epoch.
+  int64_t unixMillis()
+  {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+  }
+
+  /// Configuration of one stream, from the command line.
+  struct StreamConfig
+  {
+    std::string type;
+    std::string topic;
+    double rate = 10.0;
+    size_t ids = 1;
+    std::string id = "id";
+    size_t batch = 100;
+    std::string shape = "sine";
+    double amplitude = 1.0;
+    double offset = 0.0;
+    double period = 10.0;
+    std::string recipient = "you";
+  };
+
+  /// Deterministic payload as function of time, instance and dimension.
+  class Payload
+  {
+  public:
+    Payload(const StreamConfig& config, unsigned seed) :
+      m_config(config),
+      m_rng(seed),
+      m_uniform(-1.0, 1.0)
+    {}
+
+    double operator()(double t, size_t id, size_t dim)
+    {
+      const double pi = 3.14159265358979323846;
+      const double phase = t/m_config.period + 0.1*static_cast<double>(id) + 0.25*static_cast<double>(dim);
+      double unit = 0.0;
+      if(m_config.shape == "sine")
+        unit = std::sin(2.0*pi*phase);
+      else if(m_config.shape == "ramp")
+        unit = 2.0*(phase - std::floor(phase)) - 1.0;
+      else if(m_config.shape == "square")
+        unit = (phase - std::floor(phase)) < 0.5 ? 1.0 : -1.0;
+      else if(m_config.shape == "random")
+        unit = m_uniform(m_rng);
+      return m_config.offset + m_config.amplitude*unit;
+    }
+
+  private:
+    const StreamConfig& m_config;
+    std::mt19937 m_rng;
+    std::uniform_real_distribution<double> m_uniform;
+  };
+
+  /**
+     @brief Fills a sample of a type, specialized per type.
+
+     dims is the number of payload values, keyed whether the type has an id.
+  */
+  template <typename T> struct Fill;
+
+  template <> struct Fill<fkin::Bit>
+  {
+    static constexpr size_t dims = 1;
+    static constexpr bool keyed = false;
+    static void values(fkin::Bit& s, const double *v) { s.value() = v[0] > 0.0; }
+  };
+
+  template <> struct Fill<fkin::Real>
+  {
+    static constexpr size_t dims = 1;
+    static constexpr bool keyed = false;
+    static void values(fkin::Real& s, const double *v) { s.value() = v[0]; }
+  };
+
+  template <> struct Fill<fkin::IdVec1d>
+  {
+    static constexpr size_t dims = 1;
+    static constexpr bool keyed = true;
+    static void values(fkin::IdVec1d& s, const double *v) { s.vec().x() = v[0]; }
+  };
+
+  template <> struct Fill<fkin::IdVec2d>
+  {
+    static constexpr size_t dims = 2;
+    static constexpr bool keyed = true;
+    static void values(fkin::IdVec2d& s, const double *v)
+    {
+      s.vec().x() = v[0];
+      s.vec().y() = v[1];
+    }
+  };
+
+  template <> struct Fill<fkin::IdVec3d>
+  {
+    static constexpr size_t dims = 3;
+    static constexpr bool keyed = true;
+    static void values(fkin::IdVec3d& s, const double *v)
+    {
+      s.vec().x() = v[0];
+      s.vec().y() = v[1];
+      s.vec().z() = v[2];
+    }
+  };
+
+  template <> struct Fill<fkin::IdVec4d>
+  {
+    static constexpr size_t dims = 4;
+    static constexpr bool keyed = true;
+    static void values(fkin::IdVec4d& s, const double *v)
+    {
+      s.vec().x() = v[0];
+      s.vec().y() = v[1];
+      s.vec().z() = v[2];
+      s.vec().w() = v[3];
+    }
+  };
+
+  template <> struct Fill<fkin::Kinematics2D>
+  {
+    static constexpr size_t dims = 4;
+    static constexpr bool keyed = true;
+    static void values(fkin::Kinematics2D& s, const double *v)
+    {
+      s.position().x() = v[0];
+      s.position().y() = v[1];
+      s.speed().x() = v[2];
+      s.course().x() = v[3];
+    }
+  };
+
+  template <> struct Fill<fkin::Kinematics6D>
+  {
+    static constexpr size_t dims = 9;
+    static constexpr bool keyed = true;
+    static void values(fkin::Kinematics6D& s, const double *v)
+    {
+      s.position().x() = v[0];
+      s.position().y() = v[1];
+      s.position().z() = v[2];
+      s.velocity().x() = v[3];
+      s.velocity().y() = v[4];
+      s.velocity().z() = v[5];
+      s.euler().x() = v[6];
+      s.euler().y() = v[7];
+      s.euler().z() = v[8];
+    }
+  };
+
+  template <> struct Fill<ratatosk::types::DoubleVal>
+  {
+    static constexpr size_t dims = 1;
+    static constexpr bool keyed = false;
+    static void values(ratatosk::types::DoubleVal& s, const double *v) { s.val() = v[0]; }
+  };
+
+  template <> struct Fill<ratatosk::types::Double2>
+  {
+    static constexpr size_t dims = 2;
+    static constexpr bool keyed = false;
+    static void values(ratatosk::types::Double2& s, const double *v)
+    {
+      s.x() = v[0];
+      s.y() = v[1];
+    }
+  };
+
+  template <> struct Fill<ratatosk::types::Double3>
+  {
+    static constexpr size_t dims = 3;
+    static constexpr bool keyed = false;
+    static void values(ratatosk::types::Double3& s, const double *v)
+    {
+      s.x() = v[0];
+      s.y() = v[1];
+      s.z() = v[2];
+    }
+  };
+
+  template <> struct Fill<ratatosk::types::Double4>
+  {
+    static constexpr size_t dims = 4;
+    static constexpr bool keyed = false;
+    static void values(ratatosk::types::Double4& s, const double *v)
+    {
+      s.x() = v[0];
+      s.y() = v[1];
+      s.z() = v[2];
+      s.w() = v[3];
+    }
+  };
+
+  /// Sets the key of a keyed sample.
+  template <typename T>
+  void setId(T& sample, const std::string& id, std::true_type) { sample.id() = id; }
+  template <typename T>
+  void setId(T&, const std::string&, std::false_type) {}
+
+  /// One topic with its instances, written at a fixed rate.
+  class Stream
+  {
+  public:
+    explicit Stream(const StreamConfig& config) :
+      config(config),
+      period(std::chrono::duration_cast<Clock::duration>(
+                 std::chrono::duration<double>(1.0/config.rate))),
+      samples(0),
+      messages(0)
+    {}
+    virtual ~Stream() = default;
+
+    /**
+       @brief Produce one sample for each instance.
+       @param[in] t Seconds since start.
+       @param[in] stamp Milliseconds since epoch.
+    */
+    virtual void tick(double t, int64_t stamp) = 0;
+    /// Write samples that are still collected, called once at the end.
+    virtual void flush() {}
+
+    const StreamConfig config; ///< Configuration.
+    const Clock::duration period; ///< Time between ticks.
+    Clock::time_point due; ///< Time of next tick.
+    uint64_t samples; ///< Samples produced.
+    uint64_t messages; ///< DDS writes.
+  };
+
+  /// Instance ids of a stream.
+  std::vector<std::string> instanceIds(const StreamConfig& config)
+  {
+    if(config.ids == 1) return {config.id};
 
-  std::string topic("fkinReal");
-  std::string recipient("you");
+    std::vector<std::string> ids;
+    for(size_t i = 0; i < config.ids; ++i)
+      ids.push_back(config.id + std::to_string(i));
+    return ids;
+  }
+
+  /// Stream that writes one sample per instance and tick.
+  template <typename T>
+  class ValueStream : public Stream
+  {
+  public:
+    ValueStream(dds::pub::Publisher& publisher, const StreamConfig& config, unsigned seed) :
+      Stream(config),
+      m_writer(publisher, dds::topic::Topic<T>(publisher.participant(), config.topic)),
+      m_payload(this->config, seed)
+    {
+      for(const auto& id : instanceIds(config))
+      {
+        T sample;
+        setId(sample, id, std::integral_constant<bool, Fill<T>::keyed>());
+        m_handles.push_back(
+            Fill<T>::keyed ? m_writer.register_instance(sample) : dds::core::InstanceHandle::nil());
+        m_samples.push_back(sample);
+      }
+    }
+
+    void tick(double t, int64_t) override
+    {
+      double v[Fill<T>::dims];
+      for(size_t i = 0; i < m_samples.size(); ++i)
+      {
+        for(size_t d = 0; d < Fill<T>::dims; ++d) v[d] = m_payload(t, i, d);
+        Fill<T>::values(m_samples[i], v);
+
+        if(m_handles[i].is_nil())
+          m_writer << m_samples[i];
+        else
+          m_writer.write(m_samples[i], m_handles[i]);
+      }
+      samples += m_samples.size();
+      messages += m_samples.size();
+    }
+
+  private:
+    dds::pub::DataWriter<T> m_writer;
+    Payload m_payload;
+    std::vector<T> m_samples;
+    std::vector<dds::core::InstanceHandle> m_handles;
+  };
+
+  /// Stream that appends one element per instance and tick, and writes full batches.
+  template <typename B, typename E>
+  class BatchStream : public Stream
+  {
+  public:
+    BatchStream(dds::pub::Publisher& publisher, const StreamConfig& config, unsigned seed) :
+      Stream(config),
+      m_writer(publisher, dds::topic::Topic<B>(publisher.participant(), config.topic)),
+      m_payload(this->config, seed)
+    {
+      for(const auto& id : instanceIds(config))
+      {
+        B sample;
+        sample.id() = id;
+        m_handles.push_back(m_writer.register_instance(sample));
+        m_samples.push_back(sample);
+      }
+    }
+
+    void tick(double t, int64_t stamp) override
+    {
+      using Stamp = typename std::decay<decltype(m_samples.front().timestamps())>::type::value_type;
 
-  if (argc > 1)
-    topic = argv[1];
+      double v[Fill<E>::dims];
+      for(size_t i = 0; i < m_samples.size(); ++i)
+      {
+        auto& sample = m_samples[i];
+        for(size_t d = 0; d < Fill<E>::dims; ++d) v[d] = m_payload(t, i, d);
 
-  if (argc > 2)
-    recipient = argv[2];
+        E element;
+        element.id() = sample.id();
+        Fill<E>::values(element, v);
+        Stamp ts;
+        ts.unixMillis() = stamp;
+        sample.batch().push_back(element);
+        sample.timestamps().push_back(ts);
 
-  auto sampleTopic = dds::topic::Topic<fkin::Command>(
-      domainParticipant,
-      topic);
-  auto sampleWriterQos = publisher.default_datawriter_qos();
-  sampleWriterQos << dds::core::policy::Durability::TransientLocal();
-  auto sampleWriter = dds::pub::DataWriter<fkin::Command>(
-      publisher,
-      sampleTopic,
-      sampleWriterQos);
+        if(sample.batch().size() >= config.batch) write(i);
+      }
+      samples += m_samples.size();
+    }
 
-  const auto requestID = fkin::MessageID(sinspekto::generate_hex(6), 0);
+    void flush() override
+    {
+      for(size_t i = 0; i < m_samples.size(); ++i)
+      {
+        if(!m_samples[i].batch().empty()) write(i);
+      }
+    }
 
-  std::unique_ptr<fkin::Command> sample(new fkin::Command);
-  sample->header() =  fkin::RequestHeader(requestID, recipient);
-  sample->command() = fkin::CommandType::BOGUS_COMMAND;
+  private:
+    /// Write the batch of an instance and start the next.
+    void write(size_t i)
+    {
+      auto& sample = m_samples[i];
+      m_writer.write(sample, m_handles[i]);
+      sample.batch().clear();
+      sample.timestamps().clear();
+      ++messages;
+    }
 
-  while(true)
+    dds::pub::DataWriter<B> m_writer;
+    Payload m_payload;
+    std::vector<B> m_samples;
+    std::vector<dds::core::InstanceHandle> m_handles;
+  };
+
+  /// The original behaviour of this program, toggles start and stop commands.
+  class CommandStream : public Stream
   {
+  public:
+    CommandStream(dds::pub::Publisher& publisher, const StreamConfig& config) :
+      Stream(config),
+      m_writer(dds::core::null)
+    {
+      auto qos = publisher.default_datawriter_qos();
+      qos << dds::core::policy::Durability::TransientLocal();
+      m_writer = dds::pub::DataWriter<fkin::Command>(
+          publisher,
+          dds::topic::Topic<fkin::Command>(publisher.participant(), config.topic),
+          qos);
+
+      const auto requestID = fkin::MessageID(sinspekto::generate_hex(6), 0);
+      m_sample.header() = fkin::RequestHeader(requestID, config.recipient);
+      m_sample.command() = fkin::CommandType::BOGUS_COMMAND;
+    }
+
+    void tick(double, int64_t) override
+    {
+      if(m_sample.command() == fkin::CommandType::STOP_PROCESS)
+        m_sample.command() = fkin::CommandType::START_PROCESS;
+      else
+        m_sample.command() = fkin::CommandType::STOP_PROCESS;
+
+      m_writer << m_sample;
+      ++samples;
+      ++messages;
+    }
+
+  private:
+    dds::pub::DataWriter<fkin::Command> m_writer;
+    fkin::Command m_sample;
+  };
 
-    if(sample->command() == fkin::CommandType::STOP_PROCESS)
-      sample->command() = fkin::CommandType::START_PROCESS;
+  std::unique_ptr<Stream> makeStream(
+      dds::pub::Publisher& publisher,
+      const StreamConfig& config,
+      unsigned seed)
+  {
+    const auto& t = config.type;
+    if(t == "command") return std::make_unique<CommandStream>(publisher, config);
+    if(t == "bit") return std::make_unique<ValueStream<fkin::Bit>>(publisher, config, seed);
+    if(t == "real") return std::make_unique<ValueStream<fkin::Real>>(publisher, config, seed);
+    if(t == "idvec1d") return std::make_unique<ValueStream<fkin::IdVec1d>>(publisher, config, seed);
+    if(t == "idvec2d") return std::make_unique<ValueStream<fkin::IdVec2d>>(publisher, config, seed);
+    if(t == "idvec3d") return std::make_unique<ValueStream<fkin::IdVec3d>>(publisher, config, seed);
+    if(t == "idvec4d") return std::make_unique<ValueStream<fkin::IdVec4d>>(publisher, config, seed);
+    if(t == "kinematics2d") return std::make_unique<ValueStream<fkin::Kinematics2D>>(publisher, config, seed);
+    if(t == "kinematics6d") return std::make_unique<ValueStream<fkin::Kinematics6D>>(publisher, config, seed);
+    if(t == "batchidvec1d")
+      return std::make_unique<BatchStream<fkin::BatchIdVec1d, fkin::IdVec1d>>(publisher, config, seed);
+    if(t == "batchkinematics2d")
+      return std::make_unique<BatchStream<fkin::BatchKinematics2D, fkin::Kinematics2D>>(publisher, config, seed);
+    if(t == "batchkinematics6d")
+      return std::make_unique<BatchStream<fkin::BatchKinematics6D, fkin::Kinematics6D>>(publisher, config, seed);
+    if(t == "doubleval")
+      return std::make_unique<ValueStream<ratatosk::types::DoubleVal>>(publisher, config, seed);
+    if(t == "double2")
+      return std::make_unique<ValueStream<ratatosk::types::Double2>>(publisher, config, seed);
+    if(t == "double3")
+      return std::make_unique<ValueStream<ratatosk::types::Double3>>(publisher, config, seed);
+    if(t == "double4")
+      return std::make_unique<ValueStream<ratatosk::types::Double4>>(publisher, config, seed);
+    return nullptr;
+  }
+
+  /// Types without key, where ids=n would only overwrite the same sample.
+  bool isKeyless(const std::string& type)
+  {
+    return type == "command" || type == "bit" || type == "real"
+     || type == "doubleval" || type == "double2" || type == "double3" || type == "double4";
+  }
+
+  bool parseStream(const std::string& arg, StreamConfig& config)
+  {
+    const auto colon = arg.find(':');
+    if(colon == std::string::npos || colon == 0) return false;
+    config.type = arg.substr(0, colon);
+
+    std::stringstream rest(arg.substr(colon + 1));
+    std::string item;
+    std::getline(rest, config.topic, ',');
+    if(config.topic.empty()) return false;
+
+    while(std::getline(rest, item, ','))
+    {
+      const auto eq = item.find('=');
+      if(eq == std::string::npos) return false;
+      const std::string key = item.substr(0, eq), value = item.substr(eq + 1);
+      try
+      {
+        if(key == "rate") config.rate = std::stod(value);
+        else if(key == "ids") config.ids = std::stoul(value);
+        else if(key == "id") config.id = value;
+        else if(key == "batch") config.batch = std::stoul(value);
+        else if(key == "shape")
+        {
+          if(value != "sine" && value != "ramp" && value != "square"
+             && value != "random" && value != "const")
+          {
+            std::cerr << "Unknown shape: " << value << std::endl;
+            return false;
+          }
+          config.shape = value;
+        }
+        else if(key == "amplitude") config.amplitude = std::stod(value);
+        else if(key == "offset") config.offset = std::stod(value);
+        else if(key == "period") config.period = std::stod(value);
+        else if(key == "recipient") config.recipient = value;
+        else
+        {
+          std::cerr << "Unknown key: " << key << std::endl;
+          return false;
+        }
+      }
+      catch(const std::exception&)
+      {
+        std::cerr << "Invalid value for " << key << ": " << value << std::endl;
+        return false;
+      }
+    }
+
+    if(config.rate <= 0.0 || config.ids == 0 || config.batch == 0 || config.period <= 0.0)
+    {
+      std::cerr << "rate, ids, batch and period must be positive" << std::endl;
+      return false;
+    }
+    if(config.ids > 1 && isKeyless(config.type))
+    {
+      std::cerr << config.type << " has no key, using ids=1" << std::endl;
+      config.ids = 1;
+    }
+    return true;
+  }
+
+  void usage(const char *program)
+  {
+    std::cout
+      << "Usage: " << program << " [options] <type>:<topic>[,key=value...] ...\n"
+      << "\n"
+      << "Options:\n"
+      << "  --domain <n>     DDS domain (default 0)\n"
+      << "  --duration <s>   Stop after s seconds, 0 runs until interrupted (default 0)\n"
+      << "  --seed <n>       Seed of random payloads (default 1)\n"
+      << "  --report <s>     Seconds between rate reports, 0 for none (default 1)\n"
+      << "\n"
+      << "Keys: rate, ids, id, batch, shape, amplitude, offset, period, recipient\n"
+      << "Types: command, bit, real, idvec1d..idvec4d, kinematics2d, kinematics6d,\n"
+      << "       batchidvec1d, batchkinematics2d, batchkinematics6d,\n"
+      << "       doubleval, double2, double3, double4\n"
+      << "\n"
+      << "Example: " << program << " idvec1d:signal,rate=1000,ids=10 batchkinematics2d:vessel,rate=200,batch=50\n";
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  int domain = 0;
+  double duration = 0.0;
+  unsigned seed = 1;
+  double report = 1.0;
+  std::vector<StreamConfig> configs;
+
+  for(int i = 1; i < argc; ++i)
+  {
+    const std::string arg = argv[i];
+    const bool hasValue = i + 1 < argc;
+    if(arg == "-h" || arg == "--help")
+    {
+      usage(argv[0]);
+      return 0;
+    }
+    else if(arg == "--domain" && hasValue) domain = std::atoi(argv[++i]);
+    else if(arg == "--duration" && hasValue) duration = std::atof(argv[++i]);
+    else if(arg == "--seed" && hasValue) seed = static_cast<unsigned>(std::atol(argv[++i]));
+    else if(arg == "--report" && hasValue) report = std::atof(argv[++i]);
     else
-      sample->command() = fkin::CommandType::STOP_PROCESS;
+    {
+      StreamConfig config;
+      if(!parseStream(arg, config))
+      {
+        std::cerr << "Invalid stream: " << arg << std::endl;
+        usage(argv[0]);
+        return 1;
+      }
+      configs.push_back(config);
+    }
+  }
+
+  if(configs.empty())
+  {
+    StreamConfig config;
+    config.type = "command";
+    config.topic = "fkinReal";
+    config.rate = 2.0;
+    configs.push_back(config);
+  }
+
+  auto domainParticipant = dds::domain::DomainParticipant(domain);
+  auto publisher = dds::pub::Publisher(domainParticipant);
 
-    std::this_thread::sleep_for(std::chrono::milliseconds(500));
-    sampleWriter << *sample;
-    std::cout << "Wrote sample with recipient " << sample->header().recipient() << std::endl;
+  std::vector<std::unique_ptr<Stream>> streams;
+  for(size_t i = 0; i < configs.size(); ++i)
+  {
+    auto stream = makeStream(publisher, configs[i], seed + static_cast<unsigned>(i));
+    if(!stream)
+    {
+      std::cerr << "Unknown type: " << configs[i].type << std::endl;
+      return 1;
+    }
+    streams.push_back(std::move(stream));
+  }
+
+  std::signal(SIGINT, stop);
+  std::signal(SIGTERM, stop);
+
+  const auto start = Clock::now();
+  const auto end = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(duration));
+  const auto reportPeriod = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(report));
+  auto nextReport = start + reportPeriod;
+  std::vector<uint64_t> reported(streams.size(), 0);
+
+  for(auto& stream : streams) stream->due = start;
+
+  while(g_running)
+  {
+    auto next = std::min_element(
+        streams.begin(), streams.end(),
+        [](const std::unique_ptr<Stream>& a, const std::unique_ptr<Stream>& b)
+        { return a->due < b->due; });
 
+    std::this_thread::sleep_until((*next)->due);
+    const auto now = Clock::now();
+    if(duration > 0.0 && now >= end) break;
+
+    // Tick on schedule, so that the mean rate holds even if a tick comes late
+    auto& stream = **next;
+    stream.tick(std::chrono::duration<double>(stream.due - start).count(), unixMillis());
+    stream.due += stream.period;
+
+    if(report > 0.0 && now >= nextReport)
+    {
+      for(size_t i = 0; i < streams.size(); ++i)
+      {
+        std::cout
+          << streams[i]->config.topic << ": "
+          << static_cast<double>(streams[i]->samples - reported[i])/report << " samples/s"
+          << std::endl;
+        reported[i] = streams[i]->samples;
+      }
+      nextReport += reportPeriod;
+    }
+  }
+
+  // Partial batches are counted in samples, so they must be published as well
+  for(auto& stream : streams) stream->flush();
+
+  const double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+  for(auto& stream : streams)
+  {
+    std::cout
+      << stream->config.type << ":" << stream->config.topic
+      << " samples: " << stream->samples
+      << " messages: " << stream->messages
+      << " (" << static_cast<double>(stream->samples)/elapsed << " samples/s)"
+      << std::endl;
   }
 
   return 0;
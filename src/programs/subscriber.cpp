@@ -1,7 +1,31 @@
+/**
+   @file subscriber.cpp
+   @brief sinspekto-probe, measures latency and throughput of DDS topics.
+
+   Each topic is given on the command line as <type>:<topic>, with the types of
+   sinspekto-loadgen. For every topic and dispatch mode it records
+
+     - latency from the source timestamp to reception, in microseconds,
+     - for Batch* types also the age of each element from its own timestamp,
+     - samples and batch elements per second,
+     - inter-arrival time between consecutive takes that return samples, with its standard
+       deviation as jitter. Samples returned by one take() arrived together, since the
+       reader has no reception timestamp per sample,
+     - the number of samples returned by each take().
+
+   The dispatch modes are a listener, which takes the samples on the middleware thread,
+   and a WaitSet, which takes them on the main thread. With --mode both each mode runs for
+   the given duration, one after the other. The results are written as JSON.
+
+   Latencies compare clocks of the writer and reader hosts, so they are only meaningful on
+   one host or with synchronized clocks. Negative latencies are counted and taken as 0.
+*/
+
 #ifdef _MSC_VER
 #pragma warning(push, 0)
 #endif
 #include "FKIN/fkin_types_DCPS.hpp"
+#include "Ratatosk/basic_types_DCPS.hpp"
 #include <dds/domain/DomainParticipant.hpp>
 #include <dds/sub/Subscriber.hpp>
 #ifdef _MSC_VER
@@ -9,181 +33,451 @@
 #endif
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <fstream>
 #include <functional>
 #include <iostream>
-#include <sstream>
+#include <memory>
+#include <mutex>
+#include <string>
 #include <thread>
+#include <vector>
+
+#include "sinspekto/LogHistogram.hpp"
 
-template <typename T>
-class MyReaderListener :
-  public dds::sub::NoOpDataReaderListener<T>
+namespace
 {
-public:
-  MyReaderListener(
-      std::function<void(dds::sub::DataReader<T>&)> DoWork)
+  std::atomic<bool> g_running(true);
+
+  void stop(int) { g_running = false; }
+
+  /// Microseconds since epoch.
+  int64_t unixMicros()
   {
-    m_workFcn = std::move(DoWork);
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
   }
-  virtual void on_data_available(dds::sub::DataReader<T>& dataReader)
+
+  using sinspekto::LogHistogram;
+
+  /// Write a histogram as JSON, with the upper bounds and counts of its non-empty buckets.
+  void writeJson(std::ostream& out, const LogHistogram& histogram)
   {
-    if(m_workFcn)
-      m_workFcn(dataReader);
+    out
+      << "{\"count\": " << histogram.count()
+      << ", \"min\": " << histogram.min()
+      << ", \"mean\": " << histogram.mean()
+      << ", \"stddev\": " << histogram.stddev()
+      << ", \"p50\": " << histogram.quantile(0.5)
+      << ", \"p90\": " << histogram.quantile(0.9)
+      << ", \"p99\": " << histogram.quantile(0.99)
+      << ", \"p999\": " << histogram.quantile(0.999)
+      << ", \"max\": " << histogram.max()
+      << ", \"buckets\": [";
+    bool first = true;
+    const auto& buckets = histogram.buckets();
+    for(size_t i = 0; i < buckets.size(); ++i)
+    {
+      if(buckets[i] == 0) continue;
+      out << (first ? "" : ", ") << "[" << LogHistogram::upper(i) << ", " << buckets[i] << "]";
+      first = false;
+    }
+    out << "]}";
   }
 
-private:
-  std::function<void(dds::sub::DataReader<T>&)> m_workFcn;
-};
+  /// Measurements of one topic in one dispatch mode.
+  struct Stats
+  {
+    uint64_t samples = 0; ///< Valid samples.
+    uint64_t elements = 0; ///< Batch elements, for Batch* types.
+    uint64_t negative = 0; ///< Latencies below 0, from unsynchronized clocks.
+    int64_t lastArrival = 0; ///< Previous take() with samples, microseconds since epoch, 0 if none.
+    LogHistogram latency; ///< Source timestamp to reception.
+    LogHistogram elementLatency; ///< Batch element timestamp to reception.
+    LogHistogram interArrival; ///< Time between consecutive takes with samples.
+    LogHistogram takeSize; ///< Samples per take().
 
-void HandleSample(const dds::sub::Sample<fkin::Command>& sample)
-{
-  if (sample.info().valid())
+    void addLatency(LogHistogram& histogram, int64_t latency)
+    {
+      if(latency < 0) ++negative;
+      histogram.add(static_cast<uint64_t>(std::max<int64_t>(0, latency)));
+    }
+  };
+
+  /// Element timestamps of batch types, other types have none.
+  template <typename T>
+  void addElements(const T&, int64_t, Stats&) {}
+
+  template <typename B>
+  void addBatchElements(const B& batch, int64_t now, Stats& stats)
   {
-    switch(sample.data().command())
+    for(const auto& stamp : batch.timestamps())
     {
-    case fkin::CommandType::START_PROCESS:
-      std::cout << "Start it " << std::endl;
-      break;
-    case fkin::CommandType::STOP_PROCESS:
-      std::cout << "Stop it " << std::endl;
-      break;
-    default:
-      break;
+      stats.addLatency(stats.elementLatency, now - static_cast<int64_t>(stamp.unixMillis())*1000);
+      ++stats.elements;
     }
-    std::cout << sample.data().header().recipient() << ": ";
   }
-  else
+
+  void addElements(const fkin::BatchIdVec1d& b, int64_t now, Stats& s) { addBatchElements(b, now, s); }
+  void addElements(const fkin::BatchKinematics2D& b, int64_t now, Stats& s) { addBatchElements(b, now, s); }
+  void addElements(const fkin::BatchKinematics6D& b, int64_t now, Stats& s) { addBatchElements(b, now, s); }
+
+  template <typename T>
+  class MyReaderListener :
+    public dds::sub::NoOpDataReaderListener<T>
   {
-    std::cout << "Sample invalid" << std::endl;
-  }
-}
+  public:
+    MyReaderListener(
+        std::function<void(dds::sub::DataReader<T>&)> DoWork)
+    {
+      m_workFcn = std::move(DoWork);
+    }
+    virtual void on_data_available(dds::sub::DataReader<T>& dataReader)
+    {
+      if(m_workFcn)
+        m_workFcn(dataReader);
+    }
 
-template <typename T>
-void MyWorkFcn(dds::sub::DataReader<T>& reader, const dds::sub::Query& query){
+  private:
+    std::function<void(dds::sub::DataReader<T>&)> m_workFcn;
+  };
 
-  const auto samples = reader.select()
-   .state(dds::sub::status::DataState::new_data())
-   .content(query)
-   .take();
+  /// Reader of one topic for one dispatch mode.
+  class Probe
+  {
+  public:
+    Probe(const std::string& type, const std::string& topic) : type(type), topic(topic) {}
+    virtual ~Probe() = default;
 
-  std::for_each(
-      samples.begin(),
-      samples.end(),
-      HandleSample);
-}
+    /// Take all available samples and record them.
+    virtual void takeAll() = 0;
+    /// Condition that triggers when samples are available, for the WaitSet.
+    virtual dds::sub::cond::ReadCondition condition() = 0;
+    /// Stop calling the listener.
+    virtual void detach() = 0;
 
+    /// Write the measurements over the given run time as JSON.
+    void json(std::ostream& out, double elapsed)
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      out
+        << "{\"type\": \"" << type << "\", \"topic\": \"" << topic << "\""
+        << ", \"samples\": " << stats.samples
+        << ", \"samples_per_s\": " << static_cast<double>(stats.samples)/elapsed
+        << ", \"elements\": " << stats.elements
+        << ", \"elements_per_s\": " << static_cast<double>(stats.elements)/elapsed
+        << ", \"negative_latencies\": " << stats.negative
+        << ",\n       \"latency_us\": ";
+      writeJson(out, stats.latency);
+      if(stats.elements > 0)
+      {
+        out << ",\n       \"element_latency_us\": ";
+        writeJson(out, stats.elementLatency);
+      }
+      out << ",\n       \"inter_arrival_us\": ";
+      writeJson(out, stats.interArrival);
+      out << ",\n       \"take_size\": ";
+      writeJson(out, stats.takeSize);
+      out << "}";
+    }
 
-int main(int argc, char *argv[])
-{
-  auto domainParticipant = dds::domain::DomainParticipant(0);
-  auto subscriber = dds::sub::Subscriber(domainParticipant);
+    const std::string type;
+    const std::string topic;
 
-  std::string topic("fkinReal");
-  std::string recipient("you");
-  bool use_listener = false;
+  protected:
+    std::mutex mutex; ///< Listener and main thread may both use the stats.
+    Stats stats;
+  };
 
-  // option to allow selection between waitset and listener.
-  if (argc > 1)
+  template <typename T>
+  class TypedProbe : public Probe
   {
-    std::stringstream ss(argv[1]);
-    ss >> use_listener;
-  }
-  std::cout << "Use listener: " << use_listener << std::endl;
+  public:
+    TypedProbe(
+        dds::sub::Subscriber& subscriber,
+        const std::string& type,
+        const std::string& topic,
+        bool reliable,
+        bool use_listener) :
+      Probe(type, topic),
+      m_reader(dds::core::null),
+      m_listener([this](dds::sub::DataReader<T>&){ takeAll(); })
+    {
+      auto qos = subscriber.default_datareader_qos();
+      if(reliable) qos << dds::core::policy::Reliability::Reliable();
+      m_reader = dds::sub::DataReader<T>(
+          subscriber,
+          dds::topic::Topic<T>(subscriber.participant(), topic),
+          qos);
 
-  if (argc > 2)
-    topic = argv[2];
+      if(use_listener)
+        m_reader.listener(&m_listener, dds::core::status::StatusMask::data_available());
+    }
 
-  if (argc > 3)
-    recipient = argv[3];
+    ~TypedProbe() { detach(); }
 
-  auto sampleTopic = dds::topic::Topic<fkin::Command>(
-        domainParticipant,
-        topic);
-  auto sampleReaderQos = subscriber.default_datareader_qos();
-  sampleReaderQos
-   << dds::core::policy::Durability::TransientLocal()
-   << dds::core::policy::Reliability::Reliable();
-  auto sampleReader = dds::sub::DataReader<fkin::Command>(
-      subscriber,
-      sampleTopic,
-      sampleReaderQos);
+    void takeAll() override
+    {
+      const auto samples = m_reader.take();
+      const int64_t now = unixMicros();
 
-  // clear reader queue of any old samples
-  sampleReader.wait_for_historical_data(dds::core::Duration::infinite());
-  sampleReader.take();
+      std::lock_guard<std::mutex> lock(mutex);
+      if(samples.length() > 0) stats.takeSize.add(static_cast<uint64_t>(samples.length()));
+      bool arrived = false;
+      for(const auto& sample : samples)
+      {
+        if(!sample.info().valid()) continue;
+        arrived = true;
 
-  std::cout << "Query for recipient: " << recipient << std::endl;
-  const auto query = dds::sub::Query(
-      sampleReader,
-      "header.recipient = %0",
-      {recipient});
+        const auto& stamp = sample.info().timestamp();
+        const int64_t source = static_cast<int64_t>(stamp.sec())*1000000 + stamp.nanosec()/1000;
+        stats.addLatency(stats.latency, now - source);
+        addElements(sample.data(), now, stats);
+        ++stats.samples;
+      }
 
-  using namespace std::placeholders;
+      // One interval per take, the samples of a take share the same reception time
+      if(arrived)
+      {
+        if(stats.lastArrival != 0)
+          stats.interArrival.add(static_cast<uint64_t>(std::max<int64_t>(0, now - stats.lastArrival)));
+        stats.lastArrival = now;
+      }
+    }
 
-  auto fcn = std::bind(MyWorkFcn<fkin::Command>, _1, query);
+    dds::sub::cond::ReadCondition condition() override
+    {
+      return dds::sub::cond::ReadCondition(m_reader, dds::sub::status::DataState::new_data());
+    }
 
-  MyReaderListener<fkin::Command> listener(fcn);
-  auto waitSet = dds::core::cond::WaitSet();
+    void detach() override
+    {
+      if(!m_reader.is_nil())
+        m_reader.listener(nullptr, dds::core::status::StatusMask::none());
+    }
 
-  if (use_listener)
+  private:
+    dds::sub::DataReader<T> m_reader;
+    MyReaderListener<T> m_listener;
+  };
+
+  /// Carries a type into a generic lambda.
+  template <typename T> struct Type { using type = T; };
+
+  std::unique_ptr<Probe> makeProbe(
+      dds::sub::Subscriber& subscriber,
+      const std::string& type,
+      const std::string& topic,
+      bool reliable,
+      bool use_listener)
   {
-    listener = MyReaderListener<fkin::Command>(fcn);
-    sampleReader.listener(&listener, dds::core::status::StatusMask::data_available());
+    const auto& t = type;
+    auto make = [&](auto tag) -> std::unique_ptr<Probe>
+     {
+       using T = typename decltype(tag)::type;
+       return std::make_unique<TypedProbe<T>>(subscriber, type, topic, reliable, use_listener);
+     };
+    if(t == "command") return make(Type<fkin::Command>());
+    if(t == "bit") return make(Type<fkin::Bit>());
+    if(t == "real") return make(Type<fkin::Real>());
+    if(t == "idvec1d") return make(Type<fkin::IdVec1d>());
+    if(t == "idvec2d") return make(Type<fkin::IdVec2d>());
+    if(t == "idvec3d") return make(Type<fkin::IdVec3d>());
+    if(t == "idvec4d") return make(Type<fkin::IdVec4d>());
+    if(t == "kinematics2d") return make(Type<fkin::Kinematics2D>());
+    if(t == "kinematics6d") return make(Type<fkin::Kinematics6D>());
+    if(t == "batchidvec1d") return make(Type<fkin::BatchIdVec1d>());
+    if(t == "batchkinematics2d") return make(Type<fkin::BatchKinematics2D>());
+    if(t == "batchkinematics6d") return make(Type<fkin::BatchKinematics6D>());
+    if(t == "doubleval") return make(Type<ratatosk::types::DoubleVal>());
+    if(t == "double2") return make(Type<ratatosk::types::Double2>());
+    if(t == "double3") return make(Type<ratatosk::types::Double3>());
+    if(t == "double4") return make(Type<ratatosk::types::Double4>());
+    return nullptr;
   }
-  else
+
+  /// Probes of all topics for one run in one dispatch mode.
+  struct Run
+  {
+    std::string mode;
+    double elapsed = 0.0;
+    std::vector<std::unique_ptr<Probe>> probes;
+  };
+
+  bool measure(
+      dds::domain::DomainParticipant& participant,
+      const std::vector<std::pair<std::string, std::string>>& topics,
+      bool use_listener,
+      bool reliable,
+      double duration,
+      Run& run)
   {
+    auto subscriber = dds::sub::Subscriber(participant);
+    run.mode = use_listener ? "listener" : "waitset";
+
+    for(const auto& topic : topics)
+    {
+      auto probe = makeProbe(subscriber, topic.first, topic.second, reliable, use_listener);
+      if(!probe)
+      {
+        std::cerr << "Unknown type: " << topic.first << std::endl;
+        return false;
+      }
+      run.probes.push_back(std::move(probe));
+    }
+
+    auto waitSet = dds::core::cond::WaitSet();
+    std::vector<dds::sub::cond::ReadCondition> conditions;
+    if(!use_listener)
+    {
+      for(auto& probe : run.probes)
+      {
+        conditions.push_back(probe->condition());
+        waitSet.attach_condition(conditions.back());
+      }
+    }
+
+    std::cerr << "Measuring with " << run.mode << " for " << duration << " s" << std::endl;
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto end = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(duration));
+
+    while(g_running && std::chrono::steady_clock::now() < end)
+    {
+      if(use_listener)
+      {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        continue;
+      }
 
-    auto readCondition = dds::sub::cond::ReadCondition(
-        sampleReader,
-        dds::sub::status::DataState::new_data());
-    auto condition = dds::sub::cond::QueryCondition(
-        query,
-        dds::sub::status::DataState::new_data());
+      try
+      {
+        waitSet.wait(dds::core::Duration::from_millisecs(100));
+      }
+      catch(const dds::core::TimeoutError&)
+      {
+        continue;
+      }
+      for(size_t i = 0; i < conditions.size(); ++i)
+      {
+        if(conditions[i].trigger_value()) run.probes[i]->takeAll();
+      }
+    }
 
-    waitSet.attach_condition(readCondition);
-    //  waitSet.attach_condition(condition);
+    run.elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    for(auto& probe : run.probes) probe->detach();
+    return true;
   }
 
-  while(true){
+  void usage(const char *program)
+  {
+    std::cout
+      << "Usage: " << program << " [options] <type>:<topic> ...\n"
+      << "\n"
+      << "Options:\n"
+      << "  --domain <n>     DDS domain (default 0)\n"
+      << "  --duration <s>   Seconds to measure in each mode (default 10)\n"
+      << "  --mode <m>       listener, waitset or both (default both)\n"
+      << "  --reliable       Use reliable readers\n"
+      << "  --output <file>  Write JSON to file instead of standard output\n"
+      << "\n"
+      << "Types: command, bit, real, idvec1d..idvec4d, kinematics2d, kinematics6d,\n"
+      << "       batchidvec1d, batchkinematics2d, batchkinematics6d,\n"
+      << "       doubleval, double2, double3, double4\n";
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  int domain = 0;
+  double duration = 10.0;
+  std::string mode("both");
+  bool reliable = false;
+  std::string output;
+  std::vector<std::pair<std::string, std::string>> topics;
 
-    if(use_listener)
+  for(int i = 1; i < argc; ++i)
+  {
+    const std::string arg = argv[i];
+    const bool hasValue = i + 1 < argc;
+    if(arg == "-h" || arg == "--help")
     {
-      std::this_thread::sleep_for(std::chrono::seconds(10));
-      std::cout << "Just being alive" << std::endl;
+      usage(argv[0]);
+      return 0;
     }
+    else if(arg == "--domain" && hasValue) domain = std::atoi(argv[++i]);
+    else if(arg == "--duration" && hasValue) duration = std::atof(argv[++i]);
+    else if(arg == "--mode" && hasValue) mode = argv[++i];
+    else if(arg == "--reliable") reliable = true;
+    else if(arg == "--output" && hasValue) output = argv[++i];
     else
     {
-      waitSet.wait();
-      const auto samples = sampleReader.select().content(query).take();
-      std::for_each(
-          samples.begin(),
-          samples.end(),
-          HandleSample);/*
-          [](const dds::sub::Sample<fkin::Command>& sample)
-          {
-            if (sample.info().valid())
-            {
-              switch(sample.data().command())
-              {
-              case fkin::CommandType::START_PROCESS:
-                std::cout << "Start it " << std::endl;
-                break;
-              case fkin::CommandType::STOP_PROCESS:
-                std::cout << "Stop it " << std::endl;
-                break;
-              }
-              std::cout << sample.data().header().recipient() << ": ";
-            }
-            else
-            {
-              std::cout << "Sample invalid" << std::endl;
-            }
-          });*/
+      const auto colon = arg.find(':');
+      if(colon == std::string::npos || colon == 0 || colon + 1 == arg.size())
+      {
+        std::cerr << "Invalid topic: " << arg << std::endl;
+        usage(argv[0]);
+        return 1;
+      }
+      topics.emplace_back(arg.substr(0, colon), arg.substr(colon + 1));
     }
+  }
+
+  if(mode != "listener" && mode != "waitset" && mode != "both")
+  {
+    std::cerr << "Invalid mode: " << mode << std::endl;
+    return 1;
+  }
+  if(topics.empty()) topics.emplace_back("command", "fkinReal");
 
+  std::signal(SIGINT, stop);
+  std::signal(SIGTERM, stop);
 
+  auto domainParticipant = dds::domain::DomainParticipant(domain);
 
+  std::vector<Run> runs;
+  for(bool use_listener : {true, false})
+  {
+    if(mode == "listener" && !use_listener) continue;
+    if(mode == "waitset" && use_listener) continue;
+    if(!g_running) break;
+
+    runs.emplace_back();
+    if(!measure(domainParticipant, topics, use_listener, reliable, duration, runs.back()))
+      return 1;
   }
 
-  return 0;
+  std::ofstream file;
+  if(!output.empty())
+  {
+    file.open(output);
+    if(!file)
+    {
+      std::cerr << "Cannot write " << output << std::endl;
+      return 1;
+    }
+  }
+  std::ostream& out = output.empty() ? std::cout : file;
+
+  out << "{\"runs\": [";
+  for(size_t r = 0; r < runs.size(); ++r)
+  {
+    out
+      << (r ? "," : "") << "\n  {\"mode\": \"" << runs[r].mode << "\""
+      << ", \"duration_s\": " << runs[r].elapsed
+      << ", \"topics\": [";
+    for(size_t p = 0; p < runs[r].probes.size(); ++p)
+    {
+      out << (p ? "," : "") << "\n      ";
+      runs[r].probes[p]->json(out, runs[r].elapsed);
+    }
+    out << "]}";
+  }
+  out << "\n]}" << std::endl;
 
+  return 0;
 }
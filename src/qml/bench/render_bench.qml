@@ -0,0 +1,140 @@
+import QtQuick 2.11
+import QtQuick.Window 2.11
+import QtQuick.Layouts 1.11
+import QtQuick.Controls 2.4
+import QtQuick.Controls.Material 2.4
+import QtCharts 2.2
+
+import fkin.Dds 1.0
+
+// Dashboard of sinspekto-render-bench. The context properties are set by render.cpp:
+//   benchDds       QtToDds, initialized with init() or initLoopback()
+//   benchBuffers   Number of TimeChart panels, each with its own DdsIdVec1dBuffer
+//   benchCapacity  Buffer size of every buffer
+//   benchBatch     Buffers subscribe to the Batch* types
+//   benchMode      "series" for LineSeries and updateSeries(), "item" for DdsLineSeries
+//   benchMap       Show a NorthEast map of a DdsKinematics2DBuffer
+//   benchColumns   Columns of the grid of panels
+//   benchWidthMS   Time range of the time axes
+ApplicationWindow {
+  id: window;
+  title: "sinspekto-render-bench";
+  visible: true;
+  font: Qt.font({ family: "Public Sans", pixelSize: 14 });
+
+  readonly property bool itemMode: benchMode === "item";
+
+  GridLayout {
+    id: grid;
+    anchors.fill: parent;
+    anchors.margins: 4;
+    columns: benchColumns;
+    rowSpacing: 2;
+    columnSpacing: 2;
+
+    NorthEast {
+      id: map;
+      visible: benchMap;
+      Layout.minimumWidth: 0;
+      Layout.minimumHeight: 0;
+      Layout.preferredHeight: 200;
+      Layout.rowSpan: 2;
+
+      property var track: null;
+
+      DdsKinematics2DBuffer { id: vessel; }
+
+      DdsLineSeries {
+        id: trackItem;
+        visible: window.itemMode;
+        anchors.fill: map.plotArea;
+        xDim: FKIN.PosY;
+        yDim: FKIN.PosX;
+        minX: map.axisX.min;
+        maxX: map.axisX.max;
+        minY: map.axisY.min;
+        maxY: map.axisY.max;
+        color: map.style.defaultLineColor;
+      }
+
+      Connections {
+        target: vessel;
+        onNewData:
+        {
+          if(map.track)
+            vessel.updateSeries(map.track, FKIN.PosY, FKIN.PosX);
+        }
+        onRangeChanged: map.equalizer.registerBox("Vessel", vessel.rangePosY, vessel.rangePosX);
+      }
+
+      Component.onCompleted:
+      {
+        if(!benchMap)
+          return;
+        vessel.init(benchDds, "benchKinematics2D", "Vessel", benchCapacity, benchBatch);
+        if(window.itemMode)
+          trackItem.source = vessel;
+        else
+        {
+          map.track = map.createSeries(ChartView.SeriesTypeLine, "Vessel", map.axisX, map.axisY);
+          map.track.color = map.style.defaultLineColor;
+        }
+      }
+    }
+
+    Repeater {
+      model: benchBuffers;
+
+      TimeChart {
+        id: chart;
+        Layout.fillHeight: true;
+        Layout.minimumHeight: 0;
+        Layout.preferredHeight: 100;
+        widthMS: benchWidthMS;
+        labelY: "signal" + index;
+
+        property var line: null;
+
+        DdsIdVec1dBuffer { id: buffer; }
+
+        DdsLineSeries {
+          id: lineItem;
+          visible: window.itemMode;
+          anchors.fill: chart.plotArea;
+          xDim: FKIN.T;
+          yDim: FKIN.X;
+          minX: chart.axisT.min.getTime();
+          maxX: chart.axisT.max.getTime();
+          minY: chart.axisY.min;
+          maxY: chart.axisY.max;
+          color: chart.style.defaultLineColor;
+        }
+
+        Connections {
+          target: buffer;
+          onNewData:
+          {
+            if(chart.line)
+              buffer.updateSeries(chart.line, FKIN.T, FKIN.X);
+          }
+        }
+
+        Component.onCompleted:
+        {
+          buffer.init(benchDds, "benchSignal", "signal" + index, benchCapacity, benchBatch);
+          chart.timeSource = buffer;
+          chart.axisY.min = -1.5;
+          chart.axisY.max = 1.5;
+          if(window.itemMode)
+            lineItem.source = buffer;
+          else
+          {
+            chart.line = chart.createSeries(ChartView.SeriesTypeLine, "signal" + index,
+                                            chart.axisT, chart.axisY);
+            chart.line.color = chart.style.defaultLineColor;
+          }
+        }
+      }
+    }
+  }
+}
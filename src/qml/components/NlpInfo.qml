@@ -44,6 +44,14 @@ ColumnLayout {
     ddsOptiBuffer.init(participant, "fkinNlpInfoSelection", id, 40, true);
   }
 
+  // Skip series updates while the charts are not shown
+  Component.onCompleted:
+  {
+    ddsOptiBuffer.trackVisibility(iterationsLine, iterationsChart);
+    ddsOptiBuffer.trackVisibility(objectiveLine, objectiveChart);
+    ddsOptiBuffer.trackVisibility(solveTimeLine, solveTimeChart);
+  }
+
 
   // ===================
   // Visual elements
@@ -123,6 +131,13 @@ ColumnLayout {
       TimeChart {
         id: iterationsChart;
         title: qsTr("NLP solver iterations");
+        timeSource: ddsOptiBuffer;
+        // One clock for the time axes of all charts
+        Component.onCompleted:
+        {
+          iterationsChart.timeController.attachAxis(objectiveChart.axisT);
+          iterationsChart.timeController.attachAxis(solveTimeChart.axisT);
+        }
         height: root.plotHeight;
         labelY: "[#]";
         fovY: Qt.point(0, 5);
@@ -250,11 +265,5 @@ ColumnLayout {
         Fkin.zoomToFrame(range, solveTimeChart.fovY, solveTimeLine.axisY, 0.05);
       }
     }
-    onRangeTChanged:
-    {
-      iterationsChart.updateRangeT(ddsOptiBuffer.rangeTmin, ddsOptiBuffer.rangeTmax);
-      objectiveChart.updateRangeT(ddsOptiBuffer.rangeTmin, ddsOptiBuffer.rangeTmax);
-      solveTimeChart.updateRangeT(ddsOptiBuffer.rangeTmin, ddsOptiBuffer.rangeTmax);
-    }
   }
 }
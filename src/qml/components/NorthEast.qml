@@ -43,17 +43,13 @@ ChartView {
   property alias axisX: mapX;
   property alias axisY: mapY;
 
-  // Updating axis may cause a subtle bind loop that changes plotArea.
-  // The changed is not revealed in the plotArea on its previous value, but two or three ago.
-  // This timer is a temporary solution to avoid event loop congestion in those cases.
-  Timer {
-    id: axisAdjuster;
-    interval: 100;
-    running: false;
-    repeat: false;
-    onTriggered:
+  // AxisEqualizer emits at most once per frame, which breaks the bind loop through plotArea.
+  AxisEqualizer {
+    id: mapEqualizer;
+    plotArea: map.plotArea;
+    Component.onCompleted: mapEqualizer.registerBox("FOV", map.fovX, map.fovY);
+    onEqualAxisChanged:
     {
-      // When an axis update causes change of plot area
       mapX.min = mapEqualizer.equalAxisX.x;
       mapX.max = mapEqualizer.equalAxisX.y;
       mapY.min = mapEqualizer.equalAxisY.x;
@@ -61,13 +57,6 @@ ChartView {
     }
   }
 
-  AxisEqualizer {
-    id: mapEqualizer;
-    plotArea: map.plotArea;
-    Component.onCompleted: mapEqualizer.registerBox("FOV", map.fovX, map.fovY);
-    onEqualAxisChanged: axisAdjuster.start();
-  }
-
   ValueAxis {
     id: mapY;
     titleText: qsTr("North")+" [m]";
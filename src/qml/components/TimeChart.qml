@@ -5,7 +5,6 @@ import QtQuick.Layouts 1.11
 import QtCharts 2.2
 
 import fkin.Dds 1.0
-import "fkinHelpers.js" as Fkin
 
 ChartView {
   id: timeChart;
@@ -28,6 +27,8 @@ ChartView {
   property alias axisT: timeAxis;
   property alias axisY: yAxis;
   property alias labelY: yAxis.titleText;
+  property alias timeSource: timeController.source;
+  property alias timeController: timeController;
 
   property alias style: fkinStyle;
   FkinStyle { id: fkinStyle; }
@@ -73,12 +74,17 @@ ChartView {
 
   }
 
-  function updateRangeT(minT, maxT){
-
-    timeChart.axisT.min = minT;
-    timeChart.axisT.max = maxT;
-    Fkin.ensureTimeHorizon(timeChart, timeChart.horizonMS, timeChart.futureMS, minT, maxT);
+  // Scrolls the time axis with timeSource, and can drive the time axes of other charts.
+  TimeAxisController {
+    id: timeController;
+    horizonMS: timeChart.horizonMS;
+    futureMS: timeChart.futureMS;
+    Component.onCompleted: timeController.attachAxis(timeAxis);
+  }
 
+  // For charts without a timeSource.
+  function updateRangeT(minT, maxT){
+    timeController.setLatest(maxT);
   }
 
 
@@ -1,20 +1,56 @@
 #include "sinspekto/AxisEqualizer.hpp"
 #include <iostream>
 
+namespace
+{
+  /// Extend a range to include a candidate range, an unset (null) target is replaced.
+  void expandRange(QPointF& target, const QPointF& candidate)
+  {
+    if(target.isNull())
+      target = candidate;
+    else
+    {
+      if(target.x() > candidate.x())
+        target.setX(candidate.x());
+      if(target.y() < candidate.y())
+        target.setY(candidate.y());
+    }
+  }
+
+  /// True if replacing the old range with the candidate may shrink the target range.
+  bool shrinksRange(const QPointF& target, const QPointF& old, const QPointF& candidate)
+  {
+    if(target.isNull() || old.isNull()) return true;
+    return
+     (old.x() <= target.x() && candidate.x() > old.x()) ||
+     (old.y() >= target.y() && candidate.y() < old.y());
+  }
+}
+
 AxisEqualizer::AxisEqualizer(QObject *parent) :
   QObject(parent),
   m_bbox(std::make_pair(QPointF(), QPointF())),
+  m_emittedBox(std::make_pair(QPointF(), QPointF())),
+  m_bboxStale(false),
   m_equalAxes(std::make_pair(QPointF(), QPointF())),
   m_plotArea(QRectF())
   //m_marginPercent(0.)
 {
+  // One evaluation per frame at most
+  m_frameTimer.setSingleShot(true);
+  m_frameTimer.setInterval(16);
+
+  QObject::connect(
+      &m_frameTimer, &QTimer::timeout,
+      this, &AxisEqualizer::flush);
+
   QObject::connect(
       this, &AxisEqualizer::boundingBoxChanged,
       this, &AxisEqualizer::calculateEqualAxes);
 
   QObject::connect(
       this, &AxisEqualizer::plotAreaChanged,
-      this, &AxisEqualizer::calculateEqualAxes);
+      &m_frameTimer, [this](){ if(!m_frameTimer.isActive()) m_frameTimer.start(); });
 }
 
 AxisEqualizer::~AxisEqualizer() = default;
@@ -31,8 +67,51 @@ void AxisEqualizer::registerBox(
     const QPointF& xR,
     const QPointF& yR)
 {
-  m_ranges[seriesName] = std::make_pair(xR, yR);
-  evaluateBoundingBox();
+  const auto box = std::make_pair(xR, yR);
+  auto it = m_rangeIndex.find(seriesName);
+
+  if(it == m_rangeIndex.end())
+  {
+    m_rangeIndex.insert(seriesName, m_ranges.size());
+    m_ranges.push_back(box);
+    if(!m_bboxStale)
+    {
+      expandRange(m_bbox.first, xR);
+      expandRange(m_bbox.second, yR);
+    }
+  }
+  else
+  {
+    auto& old = m_ranges[it.value()];
+    if(old == box) return;
+
+    if(!m_bboxStale)
+    {
+      // A series on the edge of the bounding box that shrinks requires a full pass
+      if(shrinksRange(m_bbox.first, old.first, xR) ||
+       shrinksRange(m_bbox.second, old.second, yR))
+        m_bboxStale = true;
+      else
+      {
+        expandRange(m_bbox.first, xR);
+        expandRange(m_bbox.second, yR);
+      }
+    }
+    old = box;
+  }
+
+  if(!m_frameTimer.isActive()) m_frameTimer.start();
+}
+
+void AxisEqualizer::flush()
+{
+  if(m_bboxStale)
+    evaluateBoundingBox();
+  else
+    emitBoundingBox();
+
+  // Handles plot area changes, and is a no-op if already done for a new bounding box
+  calculateEqualAxes();
 }
 
 void AxisEqualizer::calculateEqualAxes()
@@ -82,35 +161,29 @@ void AxisEqualizer::calculateEqualAxes()
 
 void AxisEqualizer::evaluateBoundingBox()
 {
-  auto oldBox = m_bbox;
   m_bbox = std::make_pair(QPointF(), QPointF());
 
-  auto expandRange =
-   [](QPointF& target, QPointF& candidate)
-   {
-     if(target.isNull())
-       target = candidate;
-     else
-     {
-       if(target.x() > candidate.x())
-         target.setX(candidate.x());
-       if(target.y() < candidate.y())
-         target.setY(candidate.y());
-     }
-   };
-
   for (auto& range : m_ranges)
   {
-    expandRange(m_bbox.first, range.second.first);
-    expandRange(m_bbox.second, range.second.second);
+    expandRange(m_bbox.first, range.first);
+    expandRange(m_bbox.second, range.second);
   }
+  m_bboxStale = false;
+
+  emitBoundingBox();
+}
 
+void AxisEqualizer::emitBoundingBox()
+{
   if(
-      oldBox.first.isNull() || oldBox.second.isNull() ||
-      oldBox.first != m_bbox.first ||
-      oldBox.second != m_bbox.second
+      m_emittedBox.first.isNull() || m_emittedBox.second.isNull() ||
+      m_emittedBox.first != m_bbox.first ||
+      m_emittedBox.second != m_bbox.second
      )
+  {
+    m_emittedBox = m_bbox;
     emit boundingBoxChanged(m_bbox.first, m_bbox.second);
+  }
 }
 
 void AxisEqualizer::setPlotArea(QRectF plotArea)
@@ -17,8 +17,9 @@ void DdsBitSubscriber::init(QtToDds* dds, const QString& topic, bool with_listen
   {
     m_reader->listener = sinspekto::DdsReaderListener<fkin::Bit>(
         std::bind(&DdsBitSubscriber::eventHeard, this));
-    m_reader->reader.listener(&m_reader->listener, dds::core::status::StatusMask::data_available());
-    QObject::connect(this, &DdsBitSubscriber::eventHeard, this, &DdsBitSubscriber::updateSignal);
+    m_reader->listen();
+    sinspekto::connect_event(
+        this, &DdsBitSubscriber::eventHeard, &DdsBitSubscriber::updateSignal, topic);
   }
 }
 
@@ -31,20 +32,13 @@ bool DdsBitSubscriber::signal() const
 void DdsBitSubscriber::updateSignal()
 {
   if(!m_reader) return;
-  dds::sub::LoanedSamples<fkin::Bit> samples =
-    m_reader->reader.select().state(dds::sub::status::DataState::new_data()).take();
-  uint32_t num = samples.length();
-
-  if(num > 0)
-  {
-    m_reader->sample = (--samples.end())->data(); // picks the last sample
+  if(m_reader->takeLast())
     emit signalChanged(m_reader->sample.value());
-  }
 }
 
 
 DdsBitPublisher::DdsBitPublisher(QObject *parent) :
-  QObject(parent),
+  DdsPublisher(parent),
   m_writer(nullptr)
 { }
 
@@ -58,7 +52,7 @@ void DdsBitPublisher::init(QtToDds* dds, const QString& topic, bool start_value,
   setSignal(start_value);
 
   if (send_first)
-    m_writer->writer << m_writer->sample;
+    writeNow();
 
 }
 
@@ -76,12 +70,18 @@ void DdsBitPublisher::setSignal(bool value)
   else
   {
     m_writer->sample.value() = value;
-    m_writer->writer << m_writer->sample;
+    requestWrite();
     emit signalChanged(value);
   }
 }
 
 void DdsBitPublisher::publish()
 {
-  m_writer->writer << m_writer->sample;
+  requestWrite();
+}
+
+void DdsBitPublisher::writeSample()
+{
+  if(!m_writer) return;
+  write(*m_writer);
 }
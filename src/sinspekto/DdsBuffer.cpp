@@ -1,25 +1,162 @@
+#include <algorithm>
 #include <iostream>
+#include <limits>
+#include <QPointer>
+#include <QQmlEngine>
 #include <QXYSeries>
 #include "sinspekto/DdsBuffer.hpp"
 #include "sinspekto/QtToDds.hpp"
 
+namespace
+{
+  /**
+     @brief Pair values of one buffer with time-aligned values of another buffer.
+
+     Single merge pass over both time buffers, see DdsBuffer::joinSeries().
+
+     @return Ranges of the x-values and y-values that were set.
+  */
+  template <typename XBuffer>
+  sinspekto::RangeXY replace_joined_points(
+      const boost::circular_buffer<int64_t>& tx,
+      const XBuffer& x,
+      const boost::circular_buffer<int64_t>& ty,
+      const boost::circular_buffer<double>& y,
+      qml_enums::JoinMode mode,
+      int64_t toleranceMs,
+      QXYSeries *xySeries,
+      sinspekto::SeriesStaging& staging)
+  {
+    assert(tx.size() == x.size());
+    assert(ty.size() == y.size());
+
+    QVector<QPointF>& bufferData = staging.next(static_cast<int>(tx.size()));
+    QPointF *point = bufferData.data();
+
+    double
+     min_x = std::numeric_limits<double>::infinity(),
+     min_y = min_x,
+     max_x = -std::numeric_limits<double>::infinity(),
+     max_y = max_x;
+
+    const size_t ny = ty.size();
+    size_t j = 0; // first sample in other buffer strictly after current time point
+
+    for(size_t i = 0; i < tx.size(); ++i)
+    {
+      const int64_t t = tx[i];
+      while(j < ny && ty[j] <= t) ++j;
+      if(j == 0) continue; // nothing at or before t
+
+      const size_t k = j - 1;
+      double val_y;
+
+      if(mode == qml_enums::JoinMode::AsOf || ty[k] == t)
+      {
+        if(toleranceMs > 0 && t - ty[k] > toleranceMs) continue;
+        val_y = y[k];
+      }
+      else
+      {
+        if(j == ny) continue; // nothing after t to interpolate towards
+        const int64_t gap = ty[j] - ty[k];
+        if(toleranceMs > 0 && gap > toleranceMs) continue;
+        const double w = static_cast<double>(t - ty[k])/static_cast<double>(gap);
+        val_y = y[k] + w*(y[j] - y[k]);
+      }
+
+      const double val_x = static_cast<double>(x[i]);
+      if(val_x < min_x) min_x = val_x;
+      if(val_x > max_x) max_x = val_x;
+      if(val_y < min_y) min_y = val_y;
+      if(val_y > max_y) max_y = val_y;
+      *point++ = QPointF(val_x, val_y);
+    }
+
+    bufferData.resize(static_cast<int>(point - bufferData.data()));
+    xySeries->replace(bufferData);
+
+    return std::make_pair(std::make_pair(min_x, max_x), std::make_pair(min_y, max_y));
+  }
+}
 
 DdsBuffer::DdsBuffer(QObject *parent) :
   QObject(parent),
-  m_time(new DdsTimepointBuffer(parent))
+  m_time(new DdsTimepointBuffer(parent)),
+  m_traceReceived(0),
+  m_traceDraining(false),
+  m_traceDrainAppended(0),
+  m_traceDrainUpload(0)
 {
   qRegisterMetaType<QAbstractSeries*>();
   qRegisterMetaType<QAbstractAxis*>(); // needed?
 }
 
-DdsBuffer::~DdsBuffer() = default;
+DdsBuffer::~DdsBuffer()
+{
+  SinspektoMetrics::instance().detach(this);
+}
 
 QDateTime DdsBuffer::rangeTmin() const { return m_time->rangeTmin(); }
 QDateTime DdsBuffer::rangeTmax() const { return m_time->rangeTmax(); }
 
+DdsDoubleBuffer* DdsBuffer::dimension(qml_enums::DimId dim) const
+{
+  auto it = m_buffers.find(dim);
+  if(it == m_buffers.end())
+  {
+    std::cerr
+     << "DdsBuffer does not have dimension with DimId underlying type value: "
+     << static_cast<std::underlying_type<qml_enums::DimId>::type>(dim)
+     << std::endl;
+    return nullptr;
+  }
+  // Owned by C++, must not be garbage collected by the QML engine
+  QQmlEngine::setObjectOwnership(it->second, QQmlEngine::CppOwnership);
+  return it->second;
+}
+
+bool DdsBuffer::snapshot(
+    qml_enums::DimId dim,
+    std::vector<int64_t>& time,
+    std::vector<double>& values) const
+{
+  // m_buffers is not modified after construction, so lookup needs no protection
+  auto it = m_buffers.find(dim);
+  if(it == m_buffers.end()) return false;
+
+  const auto& timeRing = m_time->Buffer();
+  const auto& valueRing = it->second->Buffer();
+
+  uint64_t seq;
+  bool consistent;
+  do
+  {
+    seq = m_seqlock.beginRead();
+    consistent =
+     sinspekto::copy_ring(timeRing, time) &&
+     sinspekto::copy_ring(valueRing, values) &&
+     time.size() == values.size();
+  } while(m_seqlock.retryRead(seq) || !consistent);
+
+  return true;
+}
+
 void DdsBuffer::init(int buffer_size)
 {
-  m_time->setCapacity(buffer_size);
+  {
+    sinspekto::SeqLock::WriteGuard write(m_seqlock);
+    m_time->setCapacity(buffer_size);
+  }
+
+  SinspektoMetrics::instance().attach(this, m_topic, &m_metrics,
+   [this]()
+   {
+     uint64_t bytes = m_time->Buffer().size()*sizeof(int64_t);
+     for(const auto& buf : m_buffers)
+       bytes += buf.second->Buffer().size()*sizeof(double);
+     return bytes;
+   });
 
   QObject::connect(this->m_time, &DdsTimepointBuffer::rangeChanged,
   this, &DdsBuffer::rangeTChanged);
@@ -34,6 +171,13 @@ void DdsBuffer::updateSeries(
 {
   if(!series) return;
 
+  auto vis = m_visibility.find(series);
+  if(vis != m_visibility.end() && !vis->second.visible)
+  {
+    vis->second.pending = [this, series, xDim, yDim]() { updateSeries(series, xDim, yDim); };
+    return;
+  }
+
   QXYSeries *xySeries = static_cast<QXYSeries *>(series);
 
   if(yDim == qml_enums::DimId::T)
@@ -47,7 +191,8 @@ void DdsBuffer::updateSeries(
     {
       auto rangeTX = sinspekto::replace_data_points(
           m_time->Buffer(),
-          m_buffers.at(yDim)->Buffer(), xySeries);
+          m_buffers.at(yDim)->Buffer(), xySeries,
+          staging(series, xDim, yDim));
       m_time->updateRange(rangeTX.first.first, rangeTX.first.second);
       m_buffers.at(yDim)->updateRange(rangeTX.second.first, rangeTX.second.second);
     }
@@ -55,10 +200,14 @@ void DdsBuffer::updateSeries(
     {
       auto rangeXY = sinspekto::replace_double_points(
           m_buffers.at(xDim)->Buffer(),
-          m_buffers.at(yDim)->Buffer(), xySeries);
+          m_buffers.at(yDim)->Buffer(), xySeries,
+          staging(series, xDim, yDim));
       m_buffers.at(xDim)->updateRange(rangeXY.first.first, rangeXY.first.second);
       m_buffers.at(yDim)->updateRange(rangeXY.second.first, rangeXY.second.second);
     }
+    m_metrics.rebuilds.fetch_add(1, std::memory_order_relaxed);
+    m_metrics.points.fetch_add(static_cast<uint64_t>(xySeries->count()), std::memory_order_relaxed);
+    traceUploaded();
   }
   catch(std::out_of_range &)
   {
@@ -74,12 +223,245 @@ void DdsBuffer::updateSeries(
 
 }
 
+void DdsBuffer::joinSeries(
+    QAbstractSeries *series,
+    qml_enums::DimId xDim,
+    DdsBuffer *other,
+    qml_enums::DimId yDim,
+    qml_enums::JoinMode mode,
+    int toleranceMs)
+{
+  if(!series || !other) return;
+
+  auto vis = m_visibility.find(series);
+  if(vis != m_visibility.end() && !vis->second.visible)
+  {
+    QPointer<DdsBuffer> otherPtr(other);
+    vis->second.pending =
+     [this, series, xDim, otherPtr, yDim, mode, toleranceMs]()
+     {
+       if(otherPtr) joinSeries(series, xDim, otherPtr, yDim, mode, toleranceMs);
+     };
+    return;
+  }
+
+  QXYSeries *xySeries = static_cast<QXYSeries *>(series);
+
+  if(yDim == qml_enums::DimId::T)
+  {
+    std::cerr << "Other buffer's yDim "
+              << __FUNCTION__
+              << " cannot be a time axis" << std::endl;
+    return;
+  }
+
+  auto otherY = other->m_buffers.find(yDim);
+  auto thisX = m_buffers.find(xDim);
+  if(otherY == other->m_buffers.end() ||
+   (xDim != qml_enums::DimId::T && thisX == m_buffers.end()))
+  {
+    std::cerr
+     << "You tried to join a dimension that a DdsBuffer does not have."
+     << " You supplied DimId with underlying type values: "
+     << static_cast<std::underlying_type<qml_enums::DimId>::type>(xDim)
+     << ", "
+     << static_cast<std::underlying_type<qml_enums::DimId>::type>(yDim)
+     << ". Think about which dimensions you want and inspect DimId enum"
+     << std::endl;
+    return;
+  }
+
+  auto& stage = staging(series, xDim, yDim);
+  DdsDoubleBuffer *yBuffer = otherY->second;
+
+  if(xDim == qml_enums::DimId::T)
+  {
+    auto rangeTY = replace_joined_points(
+        m_time->Buffer(), m_time->Buffer(),
+        other->m_time->Buffer(), yBuffer->Buffer(),
+        mode, toleranceMs, xySeries, stage);
+    if(xySeries->count() > 0)
+    {
+      m_time->updateRange(
+          QDateTime::fromMSecsSinceEpoch(static_cast<qint64>(rangeTY.first.first)),
+          QDateTime::fromMSecsSinceEpoch(static_cast<qint64>(rangeTY.first.second)));
+      yBuffer->updateRange(rangeTY.second.first, rangeTY.second.second);
+    }
+  }
+  else
+  {
+    auto rangeXY = replace_joined_points(
+        m_time->Buffer(), thisX->second->Buffer(),
+        other->m_time->Buffer(), yBuffer->Buffer(),
+        mode, toleranceMs, xySeries, stage);
+    if(xySeries->count() > 0)
+    {
+      thisX->second->updateRange(rangeXY.first.first, rangeXY.first.second);
+      yBuffer->updateRange(rangeXY.second.first, rangeXY.second.second);
+    }
+  }
+  m_metrics.rebuilds.fetch_add(1, std::memory_order_relaxed);
+  m_metrics.points.fetch_add(static_cast<uint64_t>(xySeries->count()), std::memory_order_relaxed);
+  traceUploaded();
+}
+
+sinspekto::SeriesStaging& DdsBuffer::staging(
+    QAbstractSeries *series, qml_enums::DimId xDim, qml_enums::DimId yDim)
+{
+  auto key = std::make_tuple(series, xDim, yDim);
+  auto it = m_staging.find(key);
+  if(it != m_staging.end())
+    return it->second;
+
+  // First binding of this series, forget its storage when the series goes away
+  bool seriesKnown = std::any_of(
+      m_staging.begin(), m_staging.end(),
+      [series](const auto& entry) { return std::get<0>(entry.first) == series; });
+
+  if(!seriesKnown)
+  {
+    QObject::connect(series, &QObject::destroyed, this,
+     [this, series]()
+     {
+       for(auto it = m_staging.begin(); it != m_staging.end();)
+       {
+         if(std::get<0>(it->first) == series) it = m_staging.erase(it);
+         else ++it;
+       }
+     });
+  }
+
+  return m_staging[key];
+}
+
+void DdsBuffer::setSeriesVisible(QAbstractSeries *series, bool visible)
+{
+  if(!series) return;
+
+  auto it = m_visibility.find(series);
+  if(it == m_visibility.end())
+  {
+    it = m_visibility.emplace(series, SeriesVisibility()).first;
+    QObject::connect(series, &QObject::destroyed, this,
+     [this, series]()
+     {
+       auto vis = m_visibility.find(series);
+       if(vis == m_visibility.end()) return;
+       QObject::disconnect(vis->second.tracked);
+       m_visibility.erase(vis);
+     });
+  }
+
+  it->second.visible = visible;
+  if(visible && it->second.pending)
+  {
+    auto update = std::move(it->second.pending);
+    it->second.pending = nullptr;
+    update();
+  }
+}
+
+void DdsBuffer::trackVisibility(QAbstractSeries *series, QQuickItem *item)
+{
+  if(!series || !item) return;
+
+  setSeriesVisible(series, item->isVisible());
+
+  // Replace the connection of an earlier call, e.g. from a re-created delegate
+  SeriesVisibility& vis = m_visibility[series];
+  QObject::disconnect(vis.tracked);
+  QPointer<QAbstractSeries> seriesPtr(series);
+  vis.tracked = QObject::connect(item, &QQuickItem::visibleChanged, this,
+   [this, seriesPtr, item]() { if(seriesPtr) setSeriesVisible(seriesPtr, item->isVisible()); });
+}
+
+void DdsBuffer::drain()
+{
+  const bool tracing = DdsLatencyTrace::active();
+
+  DdsLatencyTrace::Group group;
+  if(tracing)
+  {
+    group.received = m_traceReceived.exchange(0);
+    group.dispatched = DdsLatencyTrace::nowMicros();
+  }
+
+  const uint64_t before = m_time->appended();
+  m_traceDraining = tracing;
+  m_traceDrainAppended = 0;
+  m_traceDrainUpload = 0;
+  updateBuffers();
+  m_traceDraining = false;
+  const uint64_t after = m_time->appended();
+
+  m_metrics.drains.fetch_add(1, std::memory_order_relaxed);
+  if(after <= before)
+  {
+    // Queued events outnumber takes, the samples of this one were taken by an earlier drain
+    m_metrics.coalesced.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  m_metrics.samples.fetch_add(after - before, std::memory_order_relaxed);
+
+  if(!tracing || m_time->Buffer().empty()) return;
+
+  // A series updated on newData() is updated within updateBuffers(), after the append
+  group.appended = m_traceDrainAppended ? m_traceDrainAppended : DdsLatencyTrace::nowMicros();
+  group.source = m_time->Buffer().back()*1000;
+  DdsLatencyTrace::instance().drained(m_topic, group);
+
+  // Keep the oldest group, its wait for the screen is the longest
+  if(m_traceAwaiting.appended == 0)
+    m_traceAwaiting = group;
+  if(m_traceDrainUpload)
+    completeUpload(m_traceDrainUpload);
+}
+
+void DdsBuffer::traceAppended()
+{
+  if(m_traceDraining && !m_traceDrainAppended)
+    m_traceDrainAppended = DdsLatencyTrace::nowMicros();
+}
+
+void DdsBuffer::traceUploaded()
+{
+  if(m_traceDraining)
+  {
+    if(!m_traceDrainUpload) m_traceDrainUpload = DdsLatencyTrace::nowMicros();
+    return;
+  }
+  completeUpload(DdsLatencyTrace::nowMicros());
+}
+
+void DdsBuffer::completeUpload(int64_t uploaded)
+{
+  if(m_traceAwaiting.appended == 0) return;
+
+  m_traceAwaiting.uploaded = uploaded;
+  DdsLatencyTrace::instance().uploaded(m_topic, m_traceAwaiting);
+  m_traceAwaiting = DdsLatencyTrace::Group();
+}
+
+std::function<void()> DdsBuffer::traceReception(std::function<void()> signal)
+{
+  return [this, signal]()
+  {
+    if(DdsLatencyTrace::active())
+    {
+      int64_t none = 0;
+      m_traceReceived.compare_exchange_strong(none, DdsLatencyTrace::nowMicros());
+    }
+    signal();
+  };
+}
+
 void DdsBuffer::clearBuffers()
 {
-  m_time->Buffer().clear();
+  sinspekto::SeqLock::WriteGuard write(m_seqlock);
+  m_time->clear();
 
   for (auto& buf : m_buffers)
   {
-    buf.second->Buffer().clear();
+    buf.second->clear();
   }
 }
@@ -2,7 +2,9 @@
 #include "sinspekto/DdsCommand.hpp"
 #include "sinspekto/QtToDdsPriv.hpp"
 
+#include <algorithm>
 #include <iostream>
+#include <vector>
 typedef std::map<fkin::CommandType, QString> CommandTypeName;
 
 CommandTypeName commandName_t =
@@ -27,13 +29,21 @@ void DdsCommandSubscriber::init(
     const QString& recipient,
     const QString& replyTopic)
 {
+  if(dds->loopback())
+  {
+    std::cerr << "DdsCommandSubscriber: topic " << topic.toStdString()
+              << " is not supported by the loopback transport" << std::endl;
+    return;
+  }
+
   m_recipient = recipient;
   m_reader = std::make_unique<sinspekto::Reader<fkin::Command>>(dds, topic, true);
 
   m_reader->listener = sinspekto::DdsReaderListener<fkin::Command>(
         std::bind(&DdsCommandSubscriber::eventHeard, this));
-  m_reader->reader.listener(&m_reader->listener, dds::core::status::StatusMask::data_available());
-  QObject::connect(this, &DdsCommandSubscriber::eventHeard, this, &DdsCommandSubscriber::updateCommand);
+  m_reader->listen();
+  sinspekto::connect_event(
+      this, &DdsCommandSubscriber::eventHeard, &DdsCommandSubscriber::updateCommand, topic);
 
   if ( replyTopic.length() > 0)
   {
@@ -64,27 +74,51 @@ void DdsCommandSubscriber::updateCommand()
     m_reader->reader.select()
     .content(query)
     .state(dds::sub::status::DataState::new_data()).take();
-  uint32_t num = samples.length();
 
-  if(num > 0)
+  // Samples are grouped by instance, order them as they were sent
+  std::vector<const dds::sub::Sample<fkin::Command>*> ordered;
+  ordered.reserve(samples.length());
+  for(const auto& sample : samples)
+    if(sample.info().valid()) ordered.push_back(&sample);
+  if(ordered.empty()) return;
+
+  std::stable_sort(
+      ordered.begin(), ordered.end(),
+      [](const dds::sub::Sample<fkin::Command> *a, const dds::sub::Sample<fkin::Command> *b)
+      {
+        return a->info().timestamp() < b->info().timestamp();
+      });
+
+  std::vector<fkin::CommandResponse> replies;
+  if(m_writer) replies.reserve(ordered.size());
+
+  for(auto sample : ordered)
   {
-    m_reader->sample = (--samples.end())->data(); // picks the last sample
+    m_reader->sample = sample->data();
     emit commandChanged(m_reader->sample.command());
     emit commandNameChanged(commandName_t[m_reader->sample.command()]);
-    emit sendReply();
+    if(m_writer) replies.push_back(reply(m_reader->sample));
   }
+
+  // One burst of replies after all commands are handled
+  if(!replies.empty())
+    m_writer->write(replies.begin(), replies.end());
 }
 
-void DdsCommandSubscriber::sendReply()
+fkin::CommandResponse DdsCommandSubscriber::reply(const fkin::Command& command) const
 {
-  if(!m_writer || !m_reader) return;
-
-  m_writer->sample = fkin::CommandResponse(
-      fkin::ReplyHeader(m_reader->sample.header().requestID()),
+  return fkin::CommandResponse(
+      fkin::ReplyHeader(command.header().requestID()),
       true,
       QObject::tr("Command acknowledged").toStdString());
+}
+
+void DdsCommandSubscriber::sendReply()
+{
+  if(!m_writer || !m_reader) return;
 
-  m_writer->writer << m_writer->sample;
+  m_writer->sample = reply(m_reader->sample);
+  m_writer->write();
 }
 
 
@@ -93,11 +127,15 @@ DdsCommandPublisher::DdsCommandPublisher(QObject *parent) :
   m_writer(nullptr),
   m_reader(nullptr),
   m_responseStatus(false),
-  m_awaitingSeqNr(-0),
-  m_timer(this)
+  m_responseTimeoutMs(1000)
 { }
 
-DdsCommandPublisher::~DdsCommandPublisher() = default;
+DdsCommandPublisher::~DdsCommandPublisher()
+{
+  auto& wheel = sinspekto::TimerWheel::instance();
+  for(const auto& pending : m_pending)
+    wheel.cancel(pending.second.deadline);
+}
 
 void DdsCommandPublisher::init(
     QtToDds* dds,
@@ -106,6 +144,13 @@ void DdsCommandPublisher::init(
     const QString& responseTopic,
     int responseTimeout_ms)
 {
+  if(dds->loopback())
+  {
+    std::cerr << "DdsCommandPublisher: topic " << topic.toStdString()
+              << " is not supported by the loopback transport" << std::endl;
+    return;
+  }
+
   m_recipient = recipient;
 
   m_writer = std::make_unique<sinspekto::Writer<fkin::Command>>(dds, topic, true);
@@ -123,18 +168,14 @@ void DdsCommandPublisher::init(
 
     m_reader->listener = sinspekto::DdsReaderListener<fkin::CommandResponse>(
         std::bind(&DdsCommandPublisher::gotResponse, this));
-    m_reader->reader.listener(&m_reader->listener, dds::core::status::StatusMask::data_available());
+    m_reader->listen();
     QObject::connect(this, &DdsCommandPublisher::gotResponse, this, &DdsCommandPublisher::updateResponse);
 
     // clear reader queue of any old samples
     m_reader->reader.wait_for_historical_data(dds::core::Duration::infinite());
     m_reader->reader.take();
 
-    m_timer.setSingleShot(true);
-    m_timer.setInterval(responseTimeout_ms);
-
-    QObject::connect(&m_timer, &QTimer::timeout, this, &DdsCommandPublisher::handleNoResponse);
-    QObject::connect(this, &DdsCommandPublisher::confirmedResponseSeqNr, &m_timer, &QTimer::stop);
+    m_responseTimeoutMs = responseTimeout_ms;
 
   }
 
@@ -164,24 +205,42 @@ bool DdsCommandPublisher::responseStatus() const
   return m_responseStatus;
 }
 
+int DdsCommandPublisher::pendingRequests() const
+{
+  return static_cast<int>(m_pending.size());
+}
+
+bool DdsCommandPublisher::isPending(int sequenceNr) const
+{
+  return m_pending.count(sequenceNr) > 0;
+}
+
 void DdsCommandPublisher::setCommand(fkin::CommandType command)
 {
-  if(!m_writer) return;
-  else
+  sendCommand(command);
+}
+
+int DdsCommandPublisher::sendCommand(fkin::CommandType command)
+{
+  if(!m_writer) return -1;
+
+  const std::int32_t seqNr = m_writer->sample.header().requestID().sequenceNumber() + 1;
+  m_writer->sample.header().requestID().sequenceNumber() = seqNr;
+  m_writer->sample.command() = command;
+  m_writer->write();
+  emit commandChanged(command);
+  emit commandNameChanged(commandName_t[command]);
+  if(m_reader) setResponseMessage(QString());
+
+  if (command != fkin::CommandType::BOGUS_COMMAND && m_reader)
   {
-    // should not be possible to change command until success response (if enabled)?
-    auto seqNr = m_writer->sample.header().requestID().sequenceNumber();
-    m_writer->sample.header().requestID().sequenceNumber() = seqNr + 1;
-    m_writer->sample.command() = command;
-    m_writer->writer << m_writer->sample;
-    m_awaitingSeqNr = seqNr + 1;
-    emit commandChanged(command);
-    emit commandNameChanged(commandName_t[command]);
-    if(m_reader) setResponseMessage(QString());
-
-    if (command != fkin::CommandType::BOGUS_COMMAND && m_reader)
-      m_timer.start();
+    const auto deadline = sinspekto::TimerWheel::instance().schedule(
+        m_responseTimeoutMs,
+        [this, seqNr](){ expireRequest(seqNr); });
+    m_pending[seqNr] = PendingRequest{command, deadline};
+    emit pendingRequestsChanged(pendingRequests());
   }
+  return seqNr;
 }
 
 void DdsCommandPublisher::updateResponse()
@@ -190,27 +249,43 @@ void DdsCommandPublisher::updateResponse()
 
   const auto query = dds::sub::Query(
       m_reader->reader,
-      "header.relatedRequestID.senderUUID = %0 "
-      "AND header.relatedRequestID.sequenceNumber = %1",
-      {m_writer->sample.header().requestID().senderUUID(),
-       std::to_string(m_awaitingSeqNr)});
+      "header.relatedRequestID.senderUUID = %0",
+      {m_writer->sample.header().requestID().senderUUID()});
   dds::sub::LoanedSamples<fkin::CommandResponse> samples =
    m_reader->reader.select()
    .state(dds::sub::status::DataState::new_data())
    .content(query).take();
 
-  // Query should contain all awaiting sequence numbers, really.
-  // setCommand new commands disabled awaiting response or timeout?
-
-  if(samples.length() > 0)
+  bool completed = false;
+  for(const auto& sample : samples)
   {
-    // cannot skip samples here need consecutive sequence numbers.
-    m_reader->sample = (--samples.end())->data(); // picks the last sample
-    setResponseMessage(QString::fromStdString(m_reader->sample.message()));
+    if(!sample.info().valid()) continue;
+
+    const std::int32_t seqNr = sample.data().header().relatedRequestID().sequenceNumber();
+    auto it = m_pending.find(seqNr);
+    if(it == m_pending.end()) continue; // timed out, or a duplicate
+    sinspekto::TimerWheel::instance().cancel(it->second.deadline);
+    m_pending.erase(it);
+    completed = true;
+
+    m_reader->sample = sample.data();
+    const QString message = QString::fromStdString(m_reader->sample.message());
+    setResponseMessage(message);
     setResponseStatus(m_reader->sample.success());
-    emit confirmedResponseSeqNr(m_reader->sample.header().relatedRequestID().sequenceNumber());
+    emit requestCompleted(seqNr, m_reader->sample.success(), message);
+    emit confirmedResponseSeqNr(seqNr);
   }
 
+  if(completed) emit pendingRequestsChanged(pendingRequests());
+}
+
+void DdsCommandPublisher::expireRequest(std::int32_t sequenceNr)
+{
+  if(m_pending.erase(sequenceNr) == 0) return;
+
+  emit pendingRequestsChanged(pendingRequests());
+  emit requestTimedOut(sequenceNr);
+  handleNoResponse();
 }
 
 void DdsCommandPublisher::handleNoResponse()
@@ -23,9 +23,10 @@ void DdsDoubleSubscriber::init(QtToDds* dds, const QString& topic, bool with_lis
   {
     m_reader->listener = sinspekto::DdsReaderListener<fkin::Real>(
         std::bind(&DdsDoubleSubscriber::eventHeard, this));
-    m_reader->reader.listener(&m_reader->listener, dds::core::status::StatusMask::data_available());
+    m_reader->listen();
 
-    QObject::connect(this, &DdsDoubleSubscriber::eventHeard, this, &DdsDoubleSubscriber::updateValue);
+    sinspekto::connect_event(
+        this, &DdsDoubleSubscriber::eventHeard, &DdsDoubleSubscriber::updateValue, topic);
   }
 }
 
@@ -52,17 +53,8 @@ void DdsDoubleSubscriber::updateValue()
 {
   if(!m_reader) return;
 
-  dds::sub::LoanedSamples<fkin::Real> samples =
-    m_reader->reader.select().state(dds::sub::status::DataState::new_data()).take();
-  uint32_t num = samples.length();
-
-  if(num > 0)
+  if(m_reader->takeLast())
     {
-      auto sample = (--samples.end()); // picks the last sample
-      m_reader->sample = sample->data();
-      m_reader->timepoint = sample->info().timestamp();
-      auto datetime = QDateTime();
-
       emit valueChanged(m_reader->sample.value());
       emit timestampChanged(
           [inTime = m_reader->timepoint.to_millisecs()]()
@@ -76,7 +68,7 @@ void DdsDoubleSubscriber::updateValue()
 
 
 DdsDoublePublisher::DdsDoublePublisher(QObject *parent) :
-  QObject(parent),
+  DdsPublisher(parent),
   m_writer(nullptr)
 { }
 
@@ -90,7 +82,7 @@ void DdsDoublePublisher::init(QtToDds* dds, const QString& topic, double start_v
   setValue(start_value);
 
   if (send_first)
-    m_writer->writer << m_writer->sample;
+    writeNow();
 
 }
 
@@ -108,12 +100,18 @@ void DdsDoublePublisher::setValue(double value)
   else
   {
     m_writer->sample.value() = value;
-    m_writer->writer << m_writer->sample;
+    requestWrite();
     emit valueChanged(value);
   }
 }
 
 void DdsDoublePublisher::publish()
 {
-  m_writer->writer << m_writer->sample;
+  requestWrite();
+}
+
+void DdsDoublePublisher::writeSample()
+{
+  if(!m_writer) return;
+  write(*m_writer);
 }
@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <cmath>
 #include <limits>
 
 #include "sinspekto/DdsDoubleBuffer.hpp"
@@ -5,15 +7,32 @@
 namespace sinspekto
 {
 
+  QVector<QPointF>& SeriesStaging::next(int size)
+  {
+    m_current = 1 - m_current;
+    m_points[m_current].resize(size);
+    return m_points[m_current];
+  }
+
   RangeXY replace_double_points(
       boost::circular_buffer<double>& b1,
       boost::circular_buffer<double>& b2,
       QXYSeries *xySeries)
+  {
+    SeriesStaging staging;
+    return replace_double_points(b1, b2, xySeries, staging);
+  }
+
+  RangeXY replace_double_points(
+      boost::circular_buffer<double>& b1,
+      boost::circular_buffer<double>& b2,
+      QXYSeries *xySeries,
+      SeriesStaging& staging)
   {
     assert(b1.size() == b2.size());
 
-    QVector<QPointF> bufferData;
-    bufferData.reserve(static_cast<int>(b1.size()));
+    QVector<QPointF>& bufferData = staging.next(static_cast<int>(b1.size()));
+    QPointF *point = bufferData.data();
 
     auto itX = b1.begin();
     auto itY = b2.begin();
@@ -33,19 +52,231 @@ namespace sinspekto
       if(val_x > max_x) max_x = val_x;
       if(val_y < min_y) min_y = val_y;
       if(val_y > max_y) max_y = val_y;
-      bufferData.push_back(QPointF(val_x, val_y));
+      *point++ = QPointF(val_x, val_y);
     }
     xySeries->replace(bufferData);
 
     return std::make_pair(std::make_pair(min_x, max_x), std::make_pair(min_y, max_y));
   }
+
+  namespace
+  {
+    /// Values with smaller magnitude are counted as zero by QuantileSketch.
+    constexpr double sketchMinValue = 1e-9;
+  }
+
+  void QuantileSketch::Store::add(int index)
+  {
+    if(counts.empty())
+    {
+      counts.assign(1, 0);
+      offset = index;
+    }
+    else if(index < offset)
+    {
+      counts.insert(counts.begin(), static_cast<size_t>(offset - index), 0);
+      offset = index;
+    }
+    else if(index - offset >= static_cast<int>(counts.size()))
+    {
+      counts.resize(static_cast<size_t>(index - offset + 1), 0);
+    }
+    ++counts[static_cast<size_t>(index - offset)];
+    ++total;
+  }
+
+  void QuantileSketch::Store::remove(int index)
+  {
+    const int pos = index - offset;
+    if(pos < 0 || pos >= static_cast<int>(counts.size()) || counts[pos] == 0)
+      return;
+    --counts[pos];
+    --total;
+  }
+
+  QuantileSketch::QuantileSketch(double relativeAccuracy) :
+    m_gamma((1 + relativeAccuracy)/(1 - relativeAccuracy)),
+    m_logGamma(std::log(m_gamma)),
+    m_zeros(0),
+    m_count(0)
+  {}
+
+  int QuantileSketch::index(double absValue) const
+  {
+    return static_cast<int>(std::ceil(std::log(absValue)/m_logGamma));
+  }
+
+  double QuantileSketch::value(int index) const
+  {
+    return 2*std::pow(m_gamma, index)/(m_gamma + 1);
+  }
+
+  void QuantileSketch::add(double value)
+  {
+    if(std::isnan(value)) return;
+    if(value > sketchMinValue)
+      m_positive.add(index(value));
+    else if(value < -sketchMinValue)
+      m_negative.add(index(-value));
+    else
+      ++m_zeros;
+    ++m_count;
+  }
+
+  void QuantileSketch::remove(double value)
+  {
+    if(std::isnan(value) || m_count == 0) return;
+    if(value > sketchMinValue)
+      m_positive.remove(index(value));
+    else if(value < -sketchMinValue)
+      m_negative.remove(index(-value));
+    else if(m_zeros > 0)
+      --m_zeros;
+    m_count = m_positive.total + m_negative.total + m_zeros;
+  }
+
+  void QuantileSketch::clear()
+  {
+    std::fill(m_positive.counts.begin(), m_positive.counts.end(), 0);
+    std::fill(m_negative.counts.begin(), m_negative.counts.end(), 0);
+    m_positive.total = 0;
+    m_negative.total = 0;
+    m_zeros = 0;
+    m_count = 0;
+  }
+
+  double QuantileSketch::quantile(double q) const
+  {
+    if(m_count == 0) return std::numeric_limits<double>::quiet_NaN();
+
+    q = std::min(std::max(q, 0.), 1.);
+    const auto rank = static_cast<uint64_t>(q*static_cast<double>(m_count - 1));
+    uint64_t seen = 0;
+
+    // Most negative values are in the highest negative buckets
+    for(int i = static_cast<int>(m_negative.counts.size()) - 1; i >= 0; --i)
+    {
+      seen += m_negative.counts[i];
+      if(seen > rank) return -value(i + m_negative.offset);
+    }
+    seen += m_zeros;
+    if(seen > rank) return 0.;
+    for(size_t i = 0; i < m_positive.counts.size(); ++i)
+    {
+      seen += m_positive.counts[i];
+      if(seen > rank) return value(static_cast<int>(i) + m_positive.offset);
+    }
+    return value(static_cast<int>(m_positive.counts.size()) - 1 + m_positive.offset);
+  }
+
+  RollingStatistics::RollingStatistics(int capacity) :
+    m_count(0),
+    m_mean(0),
+    m_m2(0),
+    m_minQueue(static_cast<size_t>(capacity)),
+    m_maxQueue(static_cast<size_t>(capacity))
+  {}
+
+  void RollingStatistics::setCapacity(int capacity)
+  {
+    m_minQueue.set_capacity(static_cast<size_t>(capacity));
+    m_maxQueue.set_capacity(static_cast<size_t>(capacity));
+    clear();
+  }
+
+  void RollingStatistics::add(double value)
+  {
+    // Would stay in the monotonic queues and in the running sums for good
+    if(!std::isfinite(value)) return;
+
+    // Welford
+    ++m_count;
+    const double delta = value - m_mean;
+    m_mean += delta/static_cast<double>(m_count);
+    m_m2 += delta*(value - m_mean);
+
+    // Monotonic queues keep equal values, so that removeOldest() can match them
+    while(!m_minQueue.empty() && m_minQueue.back() > value) m_minQueue.pop_back();
+    m_minQueue.push_back(value);
+    while(!m_maxQueue.empty() && m_maxQueue.back() < value) m_maxQueue.pop_back();
+    m_maxQueue.push_back(value);
+
+    m_sketch.add(value);
+  }
+
+  void RollingStatistics::removeOldest(double value)
+  {
+    if(!std::isfinite(value) || m_count == 0) return;
+    if(m_count == 1)
+    {
+      clear();
+      return;
+    }
+
+    // Inverse Welford update
+    const double delta = value - m_mean;
+    m_mean -= delta/static_cast<double>(m_count - 1);
+    m_m2 -= delta*(value - m_mean);
+    if(m_m2 < 0) m_m2 = 0;
+    --m_count;
+
+    if(!m_minQueue.empty() && m_minQueue.front() == value) m_minQueue.pop_front();
+    if(!m_maxQueue.empty() && m_maxQueue.front() == value) m_maxQueue.pop_front();
+
+    m_sketch.remove(value);
+  }
+
+  void RollingStatistics::clear()
+  {
+    m_count = 0;
+    m_mean = 0;
+    m_m2 = 0;
+    m_minQueue.clear();
+    m_maxQueue.clear();
+    m_sketch.clear();
+  }
+
+  double RollingStatistics::mean() const
+  {
+    if(m_count == 0) return std::numeric_limits<double>::quiet_NaN();
+    return m_mean;
+  }
+
+  double RollingStatistics::stddev() const
+  {
+    if(m_count < 2) return std::numeric_limits<double>::quiet_NaN();
+    return std::sqrt(m_m2/static_cast<double>(m_count - 1));
+  }
+
+  double RollingStatistics::minimum() const
+  {
+    if(m_minQueue.empty()) return std::numeric_limits<double>::quiet_NaN();
+    return m_minQueue.front();
+  }
+
+  double RollingStatistics::maximum() const
+  {
+    if(m_maxQueue.empty()) return std::numeric_limits<double>::quiet_NaN();
+    return m_maxQueue.front();
+  }
+
+  double RollingStatistics::quantile(double q) const
+  {
+    if(m_count == 0) return std::numeric_limits<double>::quiet_NaN();
+    // The sketch is approximate, but the extremes are known exactly
+    return std::min(std::max(m_sketch.quantile(q), minimum()), maximum());
+  }
 }
 
 
 DdsDoubleBuffer::DdsDoubleBuffer(QObject *parent) :
   QObject(parent),
   m_buffer(0),
-  m_range(0,1)
+  m_range(0,1),
+  m_statisticsEnabled(false),
+  m_statisticsPending(false),
+  m_statistics(0),
+  m_quantileLevels({0.05, 0.5, 0.95})
 {}
 
 DdsDoubleBuffer::~DdsDoubleBuffer() = default;
@@ -53,10 +284,88 @@ DdsDoubleBuffer::~DdsDoubleBuffer() = default;
 void DdsDoubleBuffer::setCapacity(int buffer_size)
 {
   m_buffer.set_capacity(buffer_size);
+  m_statistics.setCapacity(buffer_size);
+  if(m_statisticsEnabled)
+    for(double value : m_buffer) m_statistics.add(value);
+}
+
+void DdsDoubleBuffer::append(double value)
+{
+  if(m_statisticsEnabled && m_buffer.capacity() > 0)
+  {
+    if(m_buffer.full())
+      m_statistics.removeOldest(m_buffer.front());
+    m_statistics.add(value);
+    notifyStatistics();
+  }
+  m_buffer.push_back(value);
+}
+
+void DdsDoubleBuffer::clear()
+{
+  m_buffer.clear();
+  if(m_statisticsEnabled)
+  {
+    m_statistics.clear();
+    notifyStatistics();
+  }
 }
 
 QPointF DdsDoubleBuffer::range() const { return m_range; }
 
+bool DdsDoubleBuffer::statistics() const { return m_statisticsEnabled; }
+double DdsDoubleBuffer::mean() const { return m_statistics.mean(); }
+double DdsDoubleBuffer::stddev() const { return m_statistics.stddev(); }
+double DdsDoubleBuffer::minimum() const { return m_statistics.minimum(); }
+double DdsDoubleBuffer::maximum() const { return m_statistics.maximum(); }
+double DdsDoubleBuffer::median() const { return m_statistics.quantile(0.5); }
+double DdsDoubleBuffer::quantile(double q) const { return m_statistics.quantile(q); }
+QList<qreal> DdsDoubleBuffer::quantileLevels() const { return m_quantileLevels; }
+
+QList<qreal> DdsDoubleBuffer::quantiles() const
+{
+  QList<qreal> ret;
+  ret.reserve(m_quantileLevels.size());
+  for(qreal q : m_quantileLevels)
+    ret.append(m_statistics.quantile(q));
+  return ret;
+}
+
+void DdsDoubleBuffer::setStatistics(bool enabled)
+{
+  if(enabled == m_statisticsEnabled) return;
+
+  m_statisticsEnabled = enabled;
+  m_statistics.clear();
+  if(m_statisticsEnabled)
+    for(double value : m_buffer) m_statistics.add(value);
+
+  emit statisticsEnabledChanged(m_statisticsEnabled);
+  notifyStatistics();
+}
+
+void DdsDoubleBuffer::setQuantileLevels(const QList<qreal>& levels)
+{
+  if(levels == m_quantileLevels) return;
+  m_quantileLevels = levels;
+  emit quantileLevelsChanged();
+  notifyStatistics();
+}
+
+void DdsDoubleBuffer::notifyStatistics()
+{
+  if(m_statisticsPending) return;
+  m_statisticsPending = true;
+  QMetaObject::invokeMethod(
+      this,
+      [this]()
+      {
+        m_statisticsPending = false;
+        emit statisticsChanged();
+      },
+      Qt::QueuedConnection);
+}
+
 void DdsDoubleBuffer::updateRange(double min, double max)
 {
   if (
@@ -28,9 +28,10 @@ void DdsIdVec1dSubscriber::init(
   {
     m_reader->listener = sinspekto::DdsReaderListener<fkin::IdVec1d>(
         std::bind(&DdsIdVec1dSubscriber::eventHeard, this));
-    m_reader->reader.listener(&m_reader->listener, dds::core::status::StatusMask::data_available());
+    m_reader->listen();
 
-    QObject::connect(this, &DdsIdVec1dSubscriber::eventHeard, this, &DdsIdVec1dSubscriber::updateValue);
+    sinspekto::connect_event(
+        this, &DdsIdVec1dSubscriber::eventHeard, &DdsIdVec1dSubscriber::updateValue, topic);
   }
 }
 
@@ -56,22 +57,8 @@ QDateTime DdsIdVec1dSubscriber::timestamp() const
 void DdsIdVec1dSubscriber::updateValue()
 {
   if(!m_reader) return;
-  const auto query = dds::sub::Query(
-      m_reader->reader,
-      "id = %0", {m_id.toStdString()});
-  dds::sub::LoanedSamples<fkin::IdVec1d> samples =
-    m_reader->reader.select()
-    .content(query)
-    .state(dds::sub::status::DataState::new_data()).take();
-  uint32_t num = samples.length();
-
-  if(num > 0)
+  if(m_reader->takeLast(m_id.toStdString()))
     {
-      auto sample = (--samples.end()); // picks the last sample
-      m_reader->sample = sample->data();
-      m_reader->timepoint = sample->info().timestamp();
-      auto datetime = QDateTime();
-
       emit valueChanged(m_reader->sample.vec().x());
       emit timestampChanged(
           [inTime = m_reader->timepoint.to_millisecs()]()
@@ -85,7 +72,7 @@ void DdsIdVec1dSubscriber::updateValue()
 
 
 DdsIdVec1dPublisher::DdsIdVec1dPublisher(QObject *parent) :
-  QObject(parent),
+  DdsPublisher(parent),
   m_writer(nullptr)
 { }
 
@@ -101,10 +88,11 @@ void DdsIdVec1dPublisher::init(
 
   m_writer->sample.vec().x() = start_value;
   m_writer->sample.id() = id.toStdString();
+  m_writer->registerInstance();
   setValue(start_value);
 
   if (send_first)
-    m_writer->writer << m_writer->sample;
+    writeNow();
 
 }
 
@@ -122,12 +110,74 @@ void DdsIdVec1dPublisher::setValue(double value)
   else
   {
     m_writer->sample.vec().x() = value;
-    m_writer->writer << m_writer->sample;
+    requestWrite();
     emit valueChanged(value);
   }
 }
 
 void DdsIdVec1dPublisher::publish()
 {
-  m_writer->writer << m_writer->sample;
+  requestWrite();
+}
+
+void DdsIdVec1dPublisher::writeSample()
+{
+  if(!m_writer) return;
+  write(*m_writer);
+}
+
+DdsBatchIdVec1dPublisher::DdsBatchIdVec1dPublisher(QObject *parent) :
+  DdsBatchPublisher(parent),
+  m_writer(nullptr)
+{ }
+
+DdsBatchIdVec1dPublisher::~DdsBatchIdVec1dPublisher() = default;
+
+void DdsBatchIdVec1dPublisher::init(
+    QtToDds* dds,
+    const QString& topic,
+    const QString& id)
+{
+  m_writer = std::make_unique<sinspekto::Writer<fkin::BatchIdVec1d>>(dds, topic);
+
+  m_writer->sample.id() = id.toStdString();
+  m_writer->registerInstance();
+}
+
+void DdsBatchIdVec1dPublisher::append(double value)
+{
+  appendAt(value, nowMillis());
+}
+
+void DdsBatchIdVec1dPublisher::append(double value, const QDateTime& timestamp)
+{
+  appendAt(value, timestamp.toMSecsSinceEpoch());
+}
+
+void DdsBatchIdVec1dPublisher::appendAt(double value, int64_t unix_millis)
+{
+  if(!m_writer) return;
+
+  fkin::IdVec1d element;
+  element.id() = m_writer->sample.id();
+  element.vec().x() = value;
+  sinspekto::append_to_batch(m_writer->sample, element, unix_millis);
+  sampleAppended();
+}
+
+int DdsBatchIdVec1dPublisher::batchSize() const
+{
+  if(!m_writer) return 0;
+  return static_cast<int>(m_writer->sample.batch().size());
+}
+
+void DdsBatchIdVec1dPublisher::writeSample()
+{
+  if(!m_writer || m_writer->sample.batch().empty()) return;
+  write(*m_writer);
+  if(!batchWritten()) return;
+
+  m_writer->sample.batch().clear();
+  m_writer->sample.timestamps().clear();
+  batchCleared();
 }
@@ -31,6 +31,7 @@ void DdsIdVec1dBuffer::init(
     bool use_batch,
     bool with_listener)
 {
+  m_topic = topic;
   DdsBuffer::init(buffer_size);
 
   m_id = id;
@@ -51,22 +52,16 @@ void DdsIdVec1dBuffer::init(
     if(use_batch)
     {
       m_batchReader->listener = sinspekto::DdsReaderListener<fkin::BatchIdVec1d>(
-          std::bind(&DdsIdVec1dBuffer::eventHeard, this));
-      m_batchReader->reader.listener(
-          &m_batchReader->listener,
-          dds::core::status::StatusMask::data_available());
+          traceReception(std::bind(&DdsIdVec1dBuffer::eventHeard, this)));
+      m_batchReader->listen();
     }
     else
     {
       m_reader->listener = sinspekto::DdsReaderListener<fkin::IdVec1d>(
-          std::bind(&DdsIdVec1dBuffer::eventHeard, this));
-      m_reader->reader.listener(
-          &m_reader->listener,
-          dds::core::status::StatusMask::data_available());
+          traceReception(std::bind(&DdsIdVec1dBuffer::eventHeard, this)));
+      m_reader->listen();
     }
-    QObject::connect(
-        this, &DdsIdVec1dBuffer::eventHeard,
-        this, &DdsIdVec1dBuffer::updateBuffers);
+    sinspekto::connect_event(this, &DdsIdVec1dBuffer::eventHeard, &DdsIdVec1dBuffer::drain, topic);
   }
 }
 
@@ -77,57 +72,42 @@ void DdsIdVec1dBuffer::updateBuffers()
   auto addSampleToBuffers =
   [=](fkin::IdVec1d& sample)
   {
-    m_buffers.at(qml_enums::DimId::X)->Buffer().push_back(sample.vec().x());
+    m_buffers.at(qml_enums::DimId::X)->append(sample.vec().x());
   };
 
   if(m_reader)
   {
-    const auto query = dds::sub::Query(
-        m_reader->reader,
-        "id = %0", {m_id.toStdString()});
-    dds::sub::LoanedSamples<fkin::IdVec1d> samples =
-     m_reader->reader.select()
-     .content(query)
-     .state(dds::sub::status::DataState::new_data()).take();
-
-    if(samples.length() > 0)
+    if(m_reader->takeLast(m_id.toStdString()))
     {
-      auto sample = (--samples.end()); // picks the last sample
-      m_reader->sample = sample->data();
-      m_reader->timepoint = sample->info().timestamp();
-      addSampleToBuffers(m_reader->sample);
-      m_time->Buffer().push_back(m_reader->timepoint.to_millisecs());
+      {
+        sinspekto::SeqLock::WriteGuard write(m_seqlock);
+        addSampleToBuffers(m_reader->sample);
+        m_time->append(m_reader->timepoint.to_millisecs());
+      }
+      traceAppended();
       emit newData();
     }
   }
 
   if(m_batchReader)
   {
-    const auto query = dds::sub::Query(
-        m_batchReader->reader,
-        "id = %0", {m_id.toStdString()});
-    dds::sub::LoanedSamples<fkin::BatchIdVec1d> samples =
-     m_batchReader->reader.select()
-     .content(query)
-     .state(dds::sub::status::DataState::new_data()).take();
-
-    if(samples.length() > 0)
+    if(m_batchReader->takeLast(m_id.toStdString()))
     {
-      auto batchSample = (--samples.end()); // picks the last sample
-      m_batchReader->sample = batchSample->data();
-      m_batchReader->timepoint = batchSample->info().timestamp();
-
       if(m_batchReader->sample.batch().size() != m_batchReader->sample.timestamps().size())
         std::cerr
          << "Inconsistent length of batch sequence and timestamps"
          << " for BatchKinematics6D with id: " << m_id.toStdString()
          << std::endl;
 
-      for(size_t i = 0; i < m_batchReader->sample.batch().size(); ++i)
       {
-        addSampleToBuffers(m_batchReader->sample.batch()[i]);
-        m_time->Buffer().push_back(m_batchReader->sample.timestamps()[i].unixMillis());
+        sinspekto::SeqLock::WriteGuard write(m_seqlock);
+        for(size_t i = 0; i < m_batchReader->sample.batch().size(); ++i)
+        {
+          addSampleToBuffers(m_batchReader->sample.batch()[i]);
+          m_time->append(m_batchReader->sample.timestamps()[i].unixMillis());
+        }
       }
+      traceAppended();
       emit newData();
     }
   }
@@ -28,9 +28,10 @@ void DdsIdVec2dSubscriber::init(
   {
     m_reader->listener = sinspekto::DdsReaderListener<fkin::IdVec2d>(
         std::bind(&DdsIdVec2dSubscriber::eventHeard, this));
-    m_reader->reader.listener(&m_reader->listener, dds::core::status::StatusMask::data_available());
+    m_reader->listen();
 
-    QObject::connect(this, &DdsIdVec2dSubscriber::eventHeard, this, &DdsIdVec2dSubscriber::updateValue);
+    sinspekto::connect_event(
+        this, &DdsIdVec2dSubscriber::eventHeard, &DdsIdVec2dSubscriber::updateValue, topic);
   }
 }
 
@@ -62,22 +63,8 @@ QDateTime DdsIdVec2dSubscriber::timestamp() const
 void DdsIdVec2dSubscriber::updateValue()
 {
   if(!m_reader) return;
-  const auto query = dds::sub::Query(
-      m_reader->reader,
-      "id = %0", {m_id.toStdString()});
-  dds::sub::LoanedSamples<fkin::IdVec2d> samples =
-    m_reader->reader.select()
-    .content(query)
-    .state(dds::sub::status::DataState::new_data()).take();
-  uint32_t num = samples.length();
-
-  if(num > 0)
+  if(m_reader->takeLast(m_id.toStdString()))
     {
-      auto sample = (--samples.end()); // picks the last sample
-      m_reader->sample = sample->data();
-      m_reader->timepoint = sample->info().timestamp();
-      auto datetime = QDateTime();
-
       emit valueChanged(QVector2D(
            m_reader->sample.vec().x(),
            m_reader->sample.vec().y()));
@@ -93,7 +80,7 @@ void DdsIdVec2dSubscriber::updateValue()
 
 
 DdsIdVec2dPublisher::DdsIdVec2dPublisher(QObject *parent) :
-  QObject(parent),
+  DdsPublisher(parent),
   m_writer(nullptr)
 { }
 
@@ -110,10 +97,11 @@ void DdsIdVec2dPublisher::init(
   m_writer->sample.vec().x() = start_value.x();
   m_writer->sample.vec().y() = start_value.y();
   m_writer->sample.id() = id.toStdString();
+  m_writer->registerInstance();
   setValue(start_value);
 
   if (send_first)
-    m_writer->writer << m_writer->sample;
+    writeNow();
 
 }
 
@@ -140,12 +128,18 @@ void DdsIdVec2dPublisher::setValue(QVector2D value)
   {
     m_writer->sample.vec().x() = value.x();
     m_writer->sample.vec().y() = value.y();
-    m_writer->writer << m_writer->sample;
+    requestWrite();
     emit valueChanged(value);
   }
 }
 
 void DdsIdVec2dPublisher::publish()
 {
-  m_writer->writer << m_writer->sample;
+  requestWrite();
+}
+
+void DdsIdVec2dPublisher::writeSample()
+{
+  if(!m_writer) return;
+  write(*m_writer);
 }
@@ -31,6 +31,7 @@ void DdsIdVec2dBuffer::init(
     int buffer_size,
     bool with_listener)
 {
+  m_topic = topic;
   DdsBuffer::init(buffer_size);
 
   m_reader = std::make_unique<sinspekto::Reader<fkin::IdVec2d>>(dds, topic);
@@ -42,12 +43,10 @@ void DdsIdVec2dBuffer::init(
   if (with_listener)
   {
     m_reader->listener = sinspekto::DdsReaderListener<fkin::IdVec2d>(
-        std::bind(&DdsIdVec2dBuffer::eventHeard, this));
-    m_reader->reader.listener(&m_reader->listener, dds::core::status::StatusMask::data_available());
+        traceReception(std::bind(&DdsIdVec2dBuffer::eventHeard, this)));
+    m_reader->listen();
 
-    QObject::connect(
-        this, &DdsIdVec2dBuffer::eventHeard,
-        this, &DdsIdVec2dBuffer::updateBuffers);
+    sinspekto::connect_event(this, &DdsIdVec2dBuffer::eventHeard, &DdsIdVec2dBuffer::drain, topic);
   }
 
   QObject::connect(
@@ -63,22 +62,15 @@ void DdsIdVec2dBuffer::updateBuffers()
 {
   if(!m_reader) return;
 
-  const auto query = dds::sub::Query(
-      m_reader->reader,
-      "id = %0", {m_id.toStdString()});
-  dds::sub::LoanedSamples<fkin::IdVec2d> samples =
-   m_reader->reader.select()
-   .content(query)
-   .state(dds::sub::status::DataState::new_data()).take();
-
-  if(samples.length() > 0)
+  if(m_reader->takeLast(m_id.toStdString()))
   {
-    auto sample = (--samples.end()); // picks the last sample
-    m_reader->sample = sample->data();
-    m_reader->timepoint = sample->info().timestamp();
-    m_buffers.at(qml_enums::DimId::X)->Buffer().push_back(m_reader->sample.vec().x());
-    m_buffers.at(qml_enums::DimId::Y)->Buffer().push_back(m_reader->sample.vec().y());
-    m_time->Buffer().push_back(m_reader->timepoint.to_millisecs());
+    {
+      sinspekto::SeqLock::WriteGuard write(m_seqlock);
+      m_buffers.at(qml_enums::DimId::X)->append(m_reader->sample.vec().x());
+      m_buffers.at(qml_enums::DimId::Y)->append(m_reader->sample.vec().y());
+      m_time->append(m_reader->timepoint.to_millisecs());
+    }
+    traceAppended();
     emit newData();
   }
 }
@@ -28,9 +28,10 @@ void DdsIdVec3dSubscriber::init(
   {
     m_reader->listener = sinspekto::DdsReaderListener<fkin::IdVec3d>(
         std::bind(&DdsIdVec3dSubscriber::eventHeard, this));
-    m_reader->reader.listener(&m_reader->listener, dds::core::status::StatusMask::data_available());
+    m_reader->listen();
 
-    QObject::connect(this, &DdsIdVec3dSubscriber::eventHeard, this, &DdsIdVec3dSubscriber::updateValue);
+    sinspekto::connect_event(
+        this, &DdsIdVec3dSubscriber::eventHeard, &DdsIdVec3dSubscriber::updateValue, topic);
   }
 }
 
@@ -63,22 +64,8 @@ QDateTime DdsIdVec3dSubscriber::timestamp() const
 void DdsIdVec3dSubscriber::updateValue()
 {
   if(!m_reader) return;
-  const auto query = dds::sub::Query(
-      m_reader->reader,
-      "id = %0", {m_id.toStdString()});
-  dds::sub::LoanedSamples<fkin::IdVec3d> samples =
-    m_reader->reader.select()
-    .content(query)
-    .state(dds::sub::status::DataState::new_data()).take();
-  uint32_t num = samples.length();
-
-  if(num > 0)
+  if(m_reader->takeLast(m_id.toStdString()))
     {
-      auto sample = (--samples.end()); // picks the last sample
-      m_reader->sample = sample->data();
-      m_reader->timepoint = sample->info().timestamp();
-      auto datetime = QDateTime();
-
       emit valueChanged(QVector3D(
            m_reader->sample.vec().x(),
            m_reader->sample.vec().y(),
@@ -95,7 +82,7 @@ void DdsIdVec3dSubscriber::updateValue()
 
 
 DdsIdVec3dPublisher::DdsIdVec3dPublisher(QObject *parent) :
-  QObject(parent),
+  DdsPublisher(parent),
   m_writer(nullptr)
 { }
 
@@ -113,10 +100,11 @@ void DdsIdVec3dPublisher::init(
   m_writer->sample.vec().y() = start_value.y();
   m_writer->sample.vec().z() = start_value.z();
   m_writer->sample.id() = id.toStdString();
+  m_writer->registerInstance();
   setValue(start_value);
 
   if (send_first)
-    m_writer->writer << m_writer->sample;
+    writeNow();
 
 }
 
@@ -146,12 +134,18 @@ void DdsIdVec3dPublisher::setValue(QVector3D value)
     m_writer->sample.vec().x() = value.x();
     m_writer->sample.vec().y() = value.y();
     m_writer->sample.vec().z() = value.z();
-    m_writer->writer << m_writer->sample;
+    requestWrite();
     emit valueChanged(value);
   }
 }
 
 void DdsIdVec3dPublisher::publish()
 {
-  m_writer->writer << m_writer->sample;
+  requestWrite();
+}
+
+void DdsIdVec3dPublisher::writeSample()
+{
+  if(!m_writer) return;
+  write(*m_writer);
 }
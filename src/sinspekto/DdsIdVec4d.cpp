@@ -28,9 +28,10 @@ void DdsIdVec4dSubscriber::init(
   {
     m_reader->listener = sinspekto::DdsReaderListener<fkin::IdVec4d>(
         std::bind(&DdsIdVec4dSubscriber::eventHeard, this));
-    m_reader->reader.listener(&m_reader->listener, dds::core::status::StatusMask::data_available());
+    m_reader->listen();
 
-    QObject::connect(this, &DdsIdVec4dSubscriber::eventHeard, this, &DdsIdVec4dSubscriber::updateValue);
+    sinspekto::connect_event(
+        this, &DdsIdVec4dSubscriber::eventHeard, &DdsIdVec4dSubscriber::updateValue, topic);
   }
 }
 
@@ -64,22 +65,8 @@ QDateTime DdsIdVec4dSubscriber::timestamp() const
 void DdsIdVec4dSubscriber::updateValue()
 {
   if(!m_reader) return;
-  const auto query = dds::sub::Query(
-      m_reader->reader,
-      "id = %0", {m_id.toStdString()});
-  dds::sub::LoanedSamples<fkin::IdVec4d> samples =
-    m_reader->reader.select()
-    .content(query)
-    .state(dds::sub::status::DataState::new_data()).take();
-  uint32_t num = samples.length();
-
-  if(num > 0)
+  if(m_reader->takeLast(m_id.toStdString()))
     {
-      auto sample = (--samples.end()); // picks the last sample
-      m_reader->sample = sample->data();
-      m_reader->timepoint = sample->info().timestamp();
-      auto datetime = QDateTime();
-
       emit valueChanged(QVector4D(
            m_reader->sample.vec().x(),
            m_reader->sample.vec().y(),
@@ -97,7 +84,7 @@ void DdsIdVec4dSubscriber::updateValue()
 
 
 DdsIdVec4dPublisher::DdsIdVec4dPublisher(QObject *parent) :
-  QObject(parent),
+  DdsPublisher(parent),
   m_writer(nullptr)
 { }
 
@@ -116,10 +103,11 @@ void DdsIdVec4dPublisher::init(
   m_writer->sample.vec().z() = start_value.z();
   m_writer->sample.vec().w() = start_value.w();
   m_writer->sample.id() = id.toStdString();
+  m_writer->registerInstance();
   setValue(start_value);
 
   if (send_first)
-    m_writer->writer << m_writer->sample;
+    writeNow();
 
 }
 
@@ -152,12 +140,18 @@ void DdsIdVec4dPublisher::setValue(QVector4D value)
     m_writer->sample.vec().y() = value.y();
     m_writer->sample.vec().z() = value.z();
     m_writer->sample.vec().w() = value.w();
-    m_writer->writer << m_writer->sample;
+    requestWrite();
     emit valueChanged(value);
   }
 }
 
 void DdsIdVec4dPublisher::publish()
 {
-  m_writer->writer << m_writer->sample;
+  requestWrite();
+}
+
+void DdsIdVec4dPublisher::writeSample()
+{
+  if(!m_writer) return;
+  write(*m_writer);
 }
@@ -35,6 +35,7 @@ void DdsIdVec4dBuffer::init(
     int buffer_size,
     bool with_listener)
 {
+  m_topic = topic;
   DdsBuffer::init(buffer_size);
 
   m_reader = std::make_unique<sinspekto::Reader<fkin::IdVec4d>>(dds, topic);
@@ -48,12 +49,10 @@ void DdsIdVec4dBuffer::init(
   if (with_listener)
   {
     m_reader->listener = sinspekto::DdsReaderListener<fkin::IdVec4d>(
-        std::bind(&DdsIdVec4dBuffer::eventHeard, this));
-    m_reader->reader.listener(&m_reader->listener, dds::core::status::StatusMask::data_available());
+        traceReception(std::bind(&DdsIdVec4dBuffer::eventHeard, this)));
+    m_reader->listen();
 
-    QObject::connect(
-        this, &DdsIdVec4dBuffer::eventHeard,
-        this, &DdsIdVec4dBuffer::updateBuffers);
+    sinspekto::connect_event(this, &DdsIdVec4dBuffer::eventHeard, &DdsIdVec4dBuffer::drain, topic);
   }
 
   QObject::connect(
@@ -74,24 +73,17 @@ void DdsIdVec4dBuffer::updateBuffers()
 {
   if(!m_reader) return;
 
-  const auto query = dds::sub::Query(
-      m_reader->reader,
-      "id = %0", {m_id.toStdString()});
-  dds::sub::LoanedSamples<fkin::IdVec4d> samples =
-   m_reader->reader.select()
-   .content(query)
-   .state(dds::sub::status::DataState::new_data()).take();
-
-  if(samples.length() > 0)
+  if(m_reader->takeLast(m_id.toStdString()))
   {
-    auto sample = (--samples.end()); // picks the last sample
-    m_reader->sample = sample->data();
-    m_reader->timepoint = sample->info().timestamp();
-    m_buffers.at(qml_enums::DimId::X)->Buffer().push_back(m_reader->sample.vec().x());
-    m_buffers.at(qml_enums::DimId::Y)->Buffer().push_back(m_reader->sample.vec().y());
-    m_buffers.at(qml_enums::DimId::Z)->Buffer().push_back(m_reader->sample.vec().z());
-    m_buffers.at(qml_enums::DimId::W)->Buffer().push_back(m_reader->sample.vec().w());
-    m_time->Buffer().push_back(m_reader->timepoint.to_millisecs());
+    {
+      sinspekto::SeqLock::WriteGuard write(m_seqlock);
+      m_buffers.at(qml_enums::DimId::X)->append(m_reader->sample.vec().x());
+      m_buffers.at(qml_enums::DimId::Y)->append(m_reader->sample.vec().y());
+      m_buffers.at(qml_enums::DimId::Z)->append(m_reader->sample.vec().z());
+      m_buffers.at(qml_enums::DimId::W)->append(m_reader->sample.vec().w());
+      m_time->append(m_reader->timepoint.to_millisecs());
+    }
+    traceAppended();
     emit newData();
   }
 }
@@ -28,9 +28,10 @@ void DdsKinematics2DSubscriber::init(
   {
     m_reader->listener = sinspekto::DdsReaderListener<fkin::Kinematics2D>(
         std::bind(&DdsKinematics2DSubscriber::eventHeard, this));
-    m_reader->reader.listener(&m_reader->listener, dds::core::status::StatusMask::data_available());
+    m_reader->listen();
 
-    QObject::connect(this, &DdsKinematics2DSubscriber::eventHeard, this, &DdsKinematics2DSubscriber::updateValues);
+    sinspekto::connect_event(
+        this, &DdsKinematics2DSubscriber::eventHeard, &DdsKinematics2DSubscriber::updateValues, topic);
   }
 }
 
@@ -76,22 +77,8 @@ QDateTime DdsKinematics2DSubscriber::timestamp() const
 void DdsKinematics2DSubscriber::updateValues()
 {
   if(!m_reader) return;
-  const auto query = dds::sub::Query(
-      m_reader->reader,
-      "id = %0", {m_id.toStdString()});
-  dds::sub::LoanedSamples<fkin::Kinematics2D> samples =
-    m_reader->reader.select()
-    .content(query)
-    .state(dds::sub::status::DataState::new_data()).take();
-  uint32_t num = samples.length();
-
-  if(num > 0)
+  if(m_reader->takeLast(m_id.toStdString()))
     {
-      auto sample = (--samples.end()); // picks the last sample
-      m_reader->sample = sample->data();
-      m_reader->timepoint = sample->info().timestamp();
-      auto datetime = QDateTime();
-
       emit positionChanged(QVector2D(
            m_reader->sample.position().x(),
            m_reader->sample.position().y()));
@@ -109,7 +96,7 @@ void DdsKinematics2DSubscriber::updateValues()
 
 
 DdsKinematics2DPublisher::DdsKinematics2DPublisher(QObject *parent) :
-  QObject(parent),
+  DdsPublisher(parent),
   m_writer(nullptr)
 { }
 
@@ -127,6 +114,7 @@ void DdsKinematics2DPublisher::init(
   m_writer->sample.course().x() = 0;
   m_writer->sample.speed().x() = 0;
   m_writer->sample.id() = id.toStdString();
+  m_writer->registerInstance();
 
 }
 
@@ -172,6 +160,7 @@ void DdsKinematics2DPublisher::setPosition(QVector2D position)
   {
     m_writer->sample.position().x() = position.x();
     m_writer->sample.position().y() = position.y();
+    markChanged();
     emit positionChanged(position);
   }
 }
@@ -184,6 +173,7 @@ void DdsKinematics2DPublisher::setSpeed(double speed)
   else
   {
     m_writer->sample.speed().x() = speed;
+    markChanged();
     emit speedChanged(speed);
   }
 }
@@ -196,11 +186,77 @@ void DdsKinematics2DPublisher::setCourse(double course)
   else
   {
     m_writer->sample.course().x() = course;
+    markChanged();
     emit courseChanged(course);
   }
 }
 
 void DdsKinematics2DPublisher::publish()
 {
-  m_writer->writer << m_writer->sample;
+  requestWrite();
+}
+
+void DdsKinematics2DPublisher::writeSample()
+{
+  if(!m_writer) return;
+  write(*m_writer);
+}
+
+DdsBatchKinematics2DPublisher::DdsBatchKinematics2DPublisher(QObject *parent) :
+  DdsBatchPublisher(parent),
+  m_writer(nullptr)
+{ }
+
+DdsBatchKinematics2DPublisher::~DdsBatchKinematics2DPublisher() = default;
+
+void DdsBatchKinematics2DPublisher::init(
+    QtToDds* dds,
+    const QString& topic,
+    const QString& id)
+{
+  m_writer = std::make_unique<sinspekto::Writer<fkin::BatchKinematics2D>>(dds, topic);
+
+  m_writer->sample.id() = id.toStdString();
+  m_writer->registerInstance();
+}
+
+void DdsBatchKinematics2DPublisher::append(QVector2D position, double speed, double course)
+{
+  appendAt(position, speed, course, nowMillis());
+}
+
+void DdsBatchKinematics2DPublisher::append(QVector2D position, double speed, double course, const QDateTime& timestamp)
+{
+  appendAt(position, speed, course, timestamp.toMSecsSinceEpoch());
+}
+
+void DdsBatchKinematics2DPublisher::appendAt(QVector2D position, double speed, double course, int64_t unix_millis)
+{
+  if(!m_writer) return;
+
+  fkin::Kinematics2D element;
+  element.id() = m_writer->sample.id();
+  element.position().x() = position.x();
+  element.position().y() = position.y();
+  element.speed().x() = speed;
+  element.course().x() = course;
+  sinspekto::append_to_batch(m_writer->sample, element, unix_millis);
+  sampleAppended();
+}
+
+int DdsBatchKinematics2DPublisher::batchSize() const
+{
+  if(!m_writer) return 0;
+  return static_cast<int>(m_writer->sample.batch().size());
+}
+
+void DdsBatchKinematics2DPublisher::writeSample()
+{
+  if(!m_writer || m_writer->sample.batch().empty()) return;
+  write(*m_writer);
+  if(!batchWritten()) return;
+
+  m_writer->sample.batch().clear();
+  m_writer->sample.timestamps().clear();
+  batchCleared();
 }
@@ -37,6 +37,7 @@ void DdsKinematics2DBuffer::init(
     bool use_batch,
     bool with_listener)
 {
+  m_topic = topic;
   DdsBuffer::init(buffer_size);
 
   m_id = id;
@@ -69,23 +70,18 @@ void DdsKinematics2DBuffer::init(
     if(use_batch)
     {
       m_batchReader->listener = sinspekto::DdsReaderListener<fkin::BatchKinematics2D>(
-          std::bind(&DdsKinematics2DBuffer::eventHeard, this));
-      m_batchReader->reader.listener(
-          &m_batchReader->listener,
-          dds::core::status::StatusMask::data_available());
+          traceReception(std::bind(&DdsKinematics2DBuffer::eventHeard, this)));
+      m_batchReader->listen();
     }
     else
     {
       m_reader->listener = sinspekto::DdsReaderListener<fkin::Kinematics2D>(
-          std::bind(&DdsKinematics2DBuffer::eventHeard, this));
-      m_reader->reader.listener(
-          &m_reader->listener,
-          dds::core::status::StatusMask::data_available());
+          traceReception(std::bind(&DdsKinematics2DBuffer::eventHeard, this)));
+      m_reader->listen();
     }
 
-    QObject::connect(
-        this, &DdsKinematics2DBuffer::eventHeard,
-        this, &DdsKinematics2DBuffer::updateBuffers);
+    sinspekto::connect_event(
+        this, &DdsKinematics2DBuffer::eventHeard, &DdsKinematics2DBuffer::drain, topic);
   }
 }
 
@@ -96,64 +92,46 @@ void DdsKinematics2DBuffer::updateBuffers()
   auto addSampleToBuffers =
    [=](fkin::Kinematics2D& sample)
    {
-     m_buffers.at(qml_enums::DimId::PosX)->Buffer().push_back(sample.position().x());
-     m_buffers.at(qml_enums::DimId::PosY)->Buffer().push_back(sample.position().y());
-     m_buffers.at(qml_enums::DimId::Speed)->Buffer().push_back(sample.speed().x());
-     m_buffers.at(qml_enums::DimId::Course)->Buffer().push_back(sample.course().x());
+     m_buffers.at(qml_enums::DimId::PosX)->append(sample.position().x());
+     m_buffers.at(qml_enums::DimId::PosY)->append(sample.position().y());
+     m_buffers.at(qml_enums::DimId::Speed)->append(sample.speed().x());
+     m_buffers.at(qml_enums::DimId::Course)->append(sample.course().x());
    };
 
   if(m_reader)
   {
-    const auto query = dds::sub::Query(
-        m_reader->reader,
-        "id = %0", {m_id.toStdString()});
-
-
-    dds::sub::LoanedSamples<fkin::Kinematics2D> samples =
-     m_reader->reader.select()
-     .content(query)
-     .state(dds::sub::status::DataState::new_data()).take();
-
-    if(samples.length() > 0)
+    if(m_reader->takeLast(m_id.toStdString()))
     {
-      auto sample = (--samples.end()); // picks the last sample
-      m_reader->sample = sample->data();
-      m_reader->timepoint = sample->info().timestamp();
-      addSampleToBuffers(m_reader->sample);
-      m_time->Buffer().push_back(m_reader->timepoint.to_millisecs());
+      {
+        sinspekto::SeqLock::WriteGuard write(m_seqlock);
+        addSampleToBuffers(m_reader->sample);
+        m_time->append(m_reader->timepoint.to_millisecs());
+      }
+      traceAppended();
       emit newData();
     }
   }
 
   if(m_batchReader)
   {
-    const auto query = dds::sub::Query(
-        m_batchReader->reader,
-        "id = %0", {m_id.toStdString()});
-
-    dds::sub::LoanedSamples<fkin::BatchKinematics2D> samples =
-     m_batchReader->reader.select()
-     .content(query)
-     .state(dds::sub::status::DataState::new_data()).take();
-
-    if(samples.length() > 0)
+    if(m_batchReader->takeLast(m_id.toStdString()))
     {
-      auto batchSample = (--samples.end()); // picks the last sample
-      m_batchReader->sample = batchSample->data();
-      m_batchReader->timepoint = batchSample->info().timestamp();
-
       if(m_batchReader->sample.batch().size() != m_batchReader->sample.timestamps().size())
         std::cerr
          << "Inconsistent length of batch sequence and timestamps"
          << " for BatchKinematics2D with id: " << m_id.toStdString()
          << std::endl;
 
-      for(size_t i = 0; i < m_batchReader->sample.batch().size(); ++i)
       {
-        //auto& sample = m_batchReader->sample.batch()[i];
-        addSampleToBuffers(m_batchReader->sample.batch()[i]);
-        m_time->Buffer().push_back(m_batchReader->sample.timestamps()[i].unixMillis());
+        sinspekto::SeqLock::WriteGuard write(m_seqlock);
+        for(size_t i = 0; i < m_batchReader->sample.batch().size(); ++i)
+        {
+          //auto& sample = m_batchReader->sample.batch()[i];
+          addSampleToBuffers(m_batchReader->sample.batch()[i]);
+          m_time->append(m_batchReader->sample.timestamps()[i].unixMillis());
+        }
       }
+      traceAppended();
       emit newData();
     }
   }
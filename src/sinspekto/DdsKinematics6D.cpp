@@ -28,9 +28,10 @@ void DdsKinematics6DSubscriber::init(
   {
     m_reader->listener = sinspekto::DdsReaderListener<fkin::Kinematics6D>(
         std::bind(&DdsKinematics6DSubscriber::eventHeard, this));
-    m_reader->reader.listener(&m_reader->listener, dds::core::status::StatusMask::data_available());
+    m_reader->listen();
 
-    QObject::connect(this, &DdsKinematics6DSubscriber::eventHeard, this, &DdsKinematics6DSubscriber::updateValues);
+    sinspekto::connect_event(
+        this, &DdsKinematics6DSubscriber::eventHeard, &DdsKinematics6DSubscriber::updateValues, topic);
   }
 }
 
@@ -88,22 +89,8 @@ QDateTime DdsKinematics6DSubscriber::timestamp() const
 void DdsKinematics6DSubscriber::updateValues()
 {
   if(!m_reader) return;
-  const auto query = dds::sub::Query(
-      m_reader->reader,
-      "id = %0", {m_id.toStdString()});
-  dds::sub::LoanedSamples<fkin::Kinematics6D> samples =
-    m_reader->reader.select()
-    .content(query)
-    .state(dds::sub::status::DataState::new_data()).take();
-  uint32_t num = samples.length();
-
-  if(num > 0)
+  if(m_reader->takeLast(m_id.toStdString()))
     {
-      auto sample = (--samples.end()); // picks the last sample
-      m_reader->sample = sample->data();
-      m_reader->timepoint = sample->info().timestamp();
-      auto datetime = QDateTime();
-
       emit positionChanged(QVector3D(
            m_reader->sample.position().x(),
            m_reader->sample.position().y(),
@@ -128,7 +115,7 @@ void DdsKinematics6DSubscriber::updateValues()
 
 
 DdsKinematics6DPublisher::DdsKinematics6DPublisher(QObject *parent) :
-  QObject(parent),
+  DdsPublisher(parent),
   m_writer(nullptr)
 { }
 
@@ -151,6 +138,7 @@ void DdsKinematics6DPublisher::init(
   m_writer->sample.euler().y() = 0;
   m_writer->sample.euler().z() = 0;
   m_writer->sample.id() = id.toStdString();
+  m_writer->registerInstance();
 
 }
 
@@ -207,6 +195,7 @@ void DdsKinematics6DPublisher::setPosition(QVector3D position)
     m_writer->sample.position().x() = position.x();
     m_writer->sample.position().y() = position.y();
     m_writer->sample.position().z() = position.z();
+    markChanged();
     emit positionChanged(position);
   }
 }
@@ -225,6 +214,7 @@ void DdsKinematics6DPublisher::setVelocity(QVector3D velocity)
     m_writer->sample.velocity().x() = velocity.x();
     m_writer->sample.velocity().y() = velocity.y();
     m_writer->sample.velocity().z() = velocity.z();
+    markChanged();
     emit velocityChanged(velocity);
   }
 }
@@ -243,11 +233,82 @@ void DdsKinematics6DPublisher::setEuler(QVector3D euler)
     m_writer->sample.euler().x() = euler.x();
     m_writer->sample.euler().y() = euler.y();
     m_writer->sample.euler().z() = euler.z();
+    markChanged();
     emit eulerChanged(euler);
   }
 }
 
 void DdsKinematics6DPublisher::publish()
 {
-  m_writer->writer << m_writer->sample;
+  requestWrite();
+}
+
+void DdsKinematics6DPublisher::writeSample()
+{
+  if(!m_writer) return;
+  write(*m_writer);
+}
+
+DdsBatchKinematics6DPublisher::DdsBatchKinematics6DPublisher(QObject *parent) :
+  DdsBatchPublisher(parent),
+  m_writer(nullptr)
+{ }
+
+DdsBatchKinematics6DPublisher::~DdsBatchKinematics6DPublisher() = default;
+
+void DdsBatchKinematics6DPublisher::init(
+    QtToDds* dds,
+    const QString& topic,
+    const QString& id)
+{
+  m_writer = std::make_unique<sinspekto::Writer<fkin::BatchKinematics6D>>(dds, topic);
+
+  m_writer->sample.id() = id.toStdString();
+  m_writer->registerInstance();
+}
+
+void DdsBatchKinematics6DPublisher::append(QVector3D position, QVector3D velocity, QVector3D euler)
+{
+  appendAt(position, velocity, euler, nowMillis());
+}
+
+void DdsBatchKinematics6DPublisher::append(QVector3D position, QVector3D velocity, QVector3D euler, const QDateTime& timestamp)
+{
+  appendAt(position, velocity, euler, timestamp.toMSecsSinceEpoch());
+}
+
+void DdsBatchKinematics6DPublisher::appendAt(QVector3D position, QVector3D velocity, QVector3D euler, int64_t unix_millis)
+{
+  if(!m_writer) return;
+
+  fkin::Kinematics6D element;
+  element.id() = m_writer->sample.id();
+  element.position().x() = position.x();
+  element.position().y() = position.y();
+  element.position().z() = position.z();
+  element.velocity().x() = velocity.x();
+  element.velocity().y() = velocity.y();
+  element.velocity().z() = velocity.z();
+  element.euler().x() = euler.x();
+  element.euler().y() = euler.y();
+  element.euler().z() = euler.z();
+  sinspekto::append_to_batch(m_writer->sample, element, unix_millis);
+  sampleAppended();
+}
+
+int DdsBatchKinematics6DPublisher::batchSize() const
+{
+  if(!m_writer) return 0;
+  return static_cast<int>(m_writer->sample.batch().size());
+}
+
+void DdsBatchKinematics6DPublisher::writeSample()
+{
+  if(!m_writer || m_writer->sample.batch().empty()) return;
+  write(*m_writer);
+  if(!batchWritten()) return;
+
+  m_writer->sample.batch().clear();
+  m_writer->sample.timestamps().clear();
+  batchCleared();
 }
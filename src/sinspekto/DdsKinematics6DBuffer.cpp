@@ -47,6 +47,7 @@ void DdsKinematics6DBuffer::init(
     bool use_batch,
     bool with_listener)
 {
+  m_topic = topic;
   DdsBuffer::init(buffer_size);
   m_id = id;
   using namespace qml_enums;
@@ -77,23 +78,18 @@ void DdsKinematics6DBuffer::init(
     if (use_batch)
     {
       m_batchReader->listener = sinspekto::DdsReaderListener<fkin::BatchKinematics6D>(
-          std::bind(&DdsKinematics6DBuffer::eventHeard, this));
-      m_batchReader->reader.listener(
-          &m_batchReader->listener,
-          dds::core::status::StatusMask::data_available());
+          traceReception(std::bind(&DdsKinematics6DBuffer::eventHeard, this)));
+      m_batchReader->listen();
     }
     else
     {
       m_reader->listener = sinspekto::DdsReaderListener<fkin::Kinematics6D>(
-          std::bind(&DdsKinematics6DBuffer::eventHeard, this));
-      m_reader->reader.listener(
-          &m_reader->listener,
-          dds::core::status::StatusMask::data_available());
+          traceReception(std::bind(&DdsKinematics6DBuffer::eventHeard, this)));
+      m_reader->listen();
     }
 
-    QObject::connect(
-        this, &DdsKinematics6DBuffer::eventHeard,
-        this, &DdsKinematics6DBuffer::updateBuffers);
+    sinspekto::connect_event(
+        this, &DdsKinematics6DBuffer::eventHeard, &DdsKinematics6DBuffer::drain, topic);
   }
 }
 
@@ -104,67 +100,50 @@ void DdsKinematics6DBuffer::updateBuffers()
   auto addSampleToBuffers =
   [=](fkin::Kinematics6D& sample)
   {
-    m_buffers.at(qml_enums::DimId::PosX)->Buffer().push_back(sample.position().x());
-    m_buffers.at(qml_enums::DimId::PosY)->Buffer().push_back(sample.position().y());
-    m_buffers.at(qml_enums::DimId::PosZ)->Buffer().push_back(sample.position().z());
-    m_buffers.at(qml_enums::DimId::VelX)->Buffer().push_back(sample.velocity().x());
-    m_buffers.at(qml_enums::DimId::VelY)->Buffer().push_back(sample.velocity().y());
-    m_buffers.at(qml_enums::DimId::VelZ)->Buffer().push_back(sample.velocity().z());
-    m_buffers.at(qml_enums::DimId::EulerX)->Buffer().push_back(sample.euler().x());
-    m_buffers.at(qml_enums::DimId::EulerY)->Buffer().push_back(sample.euler().y());
-    m_buffers.at(qml_enums::DimId::EulerZ)->Buffer().push_back(sample.euler().z());
+    m_buffers.at(qml_enums::DimId::PosX)->append(sample.position().x());
+    m_buffers.at(qml_enums::DimId::PosY)->append(sample.position().y());
+    m_buffers.at(qml_enums::DimId::PosZ)->append(sample.position().z());
+    m_buffers.at(qml_enums::DimId::VelX)->append(sample.velocity().x());
+    m_buffers.at(qml_enums::DimId::VelY)->append(sample.velocity().y());
+    m_buffers.at(qml_enums::DimId::VelZ)->append(sample.velocity().z());
+    m_buffers.at(qml_enums::DimId::EulerX)->append(sample.euler().x());
+    m_buffers.at(qml_enums::DimId::EulerY)->append(sample.euler().y());
+    m_buffers.at(qml_enums::DimId::EulerZ)->append(sample.euler().z());
   };
 
   if(m_reader)
   {
-    const auto query = dds::sub::Query(
-        m_reader->reader,
-        "id = %0", {m_id.toStdString()});
-
-    dds::sub::LoanedSamples<fkin::Kinematics6D> samples =
-     m_reader->reader.select()
-     .content(query)
-     .state(dds::sub::status::DataState::new_data()).take();
-
-    if(samples.length() > 0)
+    if(m_reader->takeLast(m_id.toStdString()))
     {
-      auto sample = (--samples.end()); // picks the last sample
-      m_reader->sample = sample->data();
-      m_reader->timepoint = sample->info().timestamp();
-      addSampleToBuffers(m_reader->sample);
-      m_time->Buffer().push_back(m_reader->timepoint.to_millisecs());
+      {
+        sinspekto::SeqLock::WriteGuard write(m_seqlock);
+        addSampleToBuffers(m_reader->sample);
+        m_time->append(m_reader->timepoint.to_millisecs());
+      }
+      traceAppended();
       emit newData();
     }
   }
 
   if(m_batchReader)
   {
-    const auto query = dds::sub::Query(
-        m_batchReader->reader,
-        "id = %0", {m_id.toStdString()});
-
-    dds::sub::LoanedSamples<fkin::BatchKinematics6D> samples =
-     m_batchReader->reader.select()
-     .content(query)
-     .state(dds::sub::status::DataState::new_data()).take();
-
-    if(samples.length() > 0)
+    if(m_batchReader->takeLast(m_id.toStdString()))
     {
-      auto batchSample = (--samples.end()); // picks the last sample
-      m_batchReader->sample = batchSample->data();
-      m_batchReader->timepoint = batchSample->info().timestamp();
-
       if(m_batchReader->sample.batch().size() != m_batchReader->sample.timestamps().size())
         std::cerr
          << "Inconsistent length of batch sequence and timestamps"
          << " for BatchKinematics6D with id: " << m_id.toStdString()
          << std::endl;
 
-      for(size_t i = 0; i < m_batchReader->sample.batch().size(); ++i)
       {
-        addSampleToBuffers(m_batchReader->sample.batch()[i]);
-        m_time->Buffer().push_back(m_batchReader->sample.timestamps()[i].unixMillis());
+        sinspekto::SeqLock::WriteGuard write(m_seqlock);
+        for(size_t i = 0; i < m_batchReader->sample.batch().size(); ++i)
+        {
+          addSampleToBuffers(m_batchReader->sample.batch()[i]);
+          m_time->append(m_batchReader->sample.timestamps()[i].unixMillis());
+        }
       }
+      traceAppended();
       emit newData();
     }
   }
@@ -0,0 +1,211 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <QEvent>
+#include <QFile>
+#include <QGuiApplication>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QQuickWindow>
+#include "sinspekto/DdsLatencyTrace.hpp"
+
+namespace
+{
+  const char *stageNames[] = {"delivery", "queue", "append", "upload", "render", "total"};
+
+  /// Count, mean, percentiles and max of microseconds, in milliseconds except count.
+  QVariantMap histogramSummary(const sinspekto::LogHistogram& histogram)
+  {
+    QVariantMap map;
+    map["count"] = static_cast<qulonglong>(histogram.count());
+    map["mean"] = histogram.mean()/1000.0;
+    map["p50"] = static_cast<double>(histogram.quantile(0.5))/1000.0;
+    map["p90"] = static_cast<double>(histogram.quantile(0.9))/1000.0;
+    map["p99"] = static_cast<double>(histogram.quantile(0.99))/1000.0;
+    map["max"] = static_cast<double>(histogram.max())/1000.0;
+    return map;
+  }
+}
+
+std::atomic<bool> DdsLatencyTrace::s_active(false);
+
+DdsLatencyTrace::DdsLatencyTrace(QObject *parent) :
+  QObject(parent)
+{}
+
+DdsLatencyTrace& DdsLatencyTrace::instance()
+{
+  static DdsLatencyTrace trace;
+  return trace;
+}
+
+int64_t DdsLatencyTrace::nowMicros()
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+bool DdsLatencyTrace::enabled() const { return s_active.load(); }
+
+void DdsLatencyTrace::setEnabled(bool enabled)
+{
+  if(enabled == s_active.load()) return;
+
+  if(enabled)
+  {
+    for(QWindow *window : QGuiApplication::topLevelWindows())
+    {
+      if(auto *quickWindow = qobject_cast<QQuickWindow *>(window))
+        watchWindow(quickWindow);
+    }
+    if(QCoreApplication::instance())
+      QCoreApplication::instance()->installEventFilter(this);
+  }
+  else
+  {
+    if(QCoreApplication::instance())
+      QCoreApplication::instance()->removeEventFilter(this);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_uploaded.clear();
+  }
+
+  s_active.store(enabled);
+  emit enabledChanged(enabled);
+}
+
+QStringList DdsLatencyTrace::topics() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  QStringList names;
+  for(const auto& topic : m_topics)
+    names.append(topic.first);
+  return names;
+}
+
+void DdsLatencyTrace::watchWindow(QQuickWindow *window)
+{
+  if(!window) return;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if(m_windows.contains(window)) return;
+    m_windows.insert(window);
+  }
+
+  QObject::connect(window, &QObject::destroyed, this, [this](QObject *destroyed)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_windows.remove(destroyed);
+  });
+
+  // Emitted on the render thread with threaded rendering, stamp it there
+  QObject::connect(window, &QQuickWindow::frameSwapped, this, &DdsLatencyTrace::frameSwapped,
+   static_cast<Qt::ConnectionType>(Qt::DirectConnection | Qt::UniqueConnection));
+}
+
+bool DdsLatencyTrace::eventFilter(QObject *watched, QEvent *event)
+{
+  if(event->type() == QEvent::Show)
+  {
+    if(auto *quickWindow = qobject_cast<QQuickWindow *>(watched))
+      watchWindow(quickWindow);
+  }
+  return QObject::eventFilter(watched, event);
+}
+
+QVariantMap DdsLatencyTrace::summary(const QString& topic) const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  QVariantMap map;
+  auto it = m_topics.find(topic);
+  if(it == m_topics.end()) return map;
+
+  for(int stage = 0; stage < StageCount; ++stage)
+    map[stageNames[stage]] = histogramSummary(it->second[stage]);
+  return map;
+}
+
+bool DdsLatencyTrace::dump(const QString& fileName) const
+{
+  QJsonObject root;
+  for(const QString& topic : topics())
+    root[topic] = QJsonObject::fromVariantMap(summary(topic));
+
+  QFile file(fileName);
+  if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+  {
+    std::cerr << "DdsLatencyTrace: cannot write " << fileName.toStdString() << std::endl;
+    return false;
+  }
+  file.write(QJsonDocument(root).toJson());
+  return true;
+}
+
+void DdsLatencyTrace::reset()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_topics.clear();
+    m_uploaded.clear();
+  }
+  emit topicsChanged();
+}
+
+void DdsLatencyTrace::record(Stages& stages, Stage stage, int64_t from, int64_t to)
+{
+  if(from != 0 && to != 0)
+    stages[stage].add(static_cast<uint64_t>(std::max<int64_t>(0, to - from)));
+}
+
+DdsLatencyTrace::Stages& DdsLatencyTrace::stages(const QString& topic, bool& created)
+{
+  auto it = m_topics.find(topic);
+  created = it == m_topics.end();
+  if(created)
+    it = m_topics.emplace(topic, Stages()).first;
+  return it->second;
+}
+
+void DdsLatencyTrace::drained(const QString& topic, const Group& group)
+{
+  bool created;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Stages& s = stages(topic, created);
+    record(s, Delivery, group.source, group.received);
+    record(s, Queue, group.received, group.dispatched);
+    record(s, Append, group.dispatched, group.appended);
+  }
+  if(created) emit topicsChanged();
+}
+
+void DdsLatencyTrace::uploaded(const QString& topic, const Group& group)
+{
+  bool created;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Stages& s = stages(topic, created);
+    record(s, Upload, group.appended, group.uploaded);
+    // Without a watched window no frame completes the group
+    if(!m_windows.isEmpty())
+    {
+      if(m_uploaded.size() >= max_waiting)
+        m_uploaded.pop_front();
+      m_uploaded.emplace_back(topic, group);
+    }
+  }
+  if(created) emit topicsChanged();
+}
+
+void DdsLatencyTrace::frameSwapped()
+{
+  const int64_t now = nowMicros();
+  std::lock_guard<std::mutex> lock(m_mutex);
+  for(const auto& entry : m_uploaded)
+  {
+    // Topics are only removed by reset(), which also drops the waiting groups
+    Stages& s = m_topics[entry.first];
+    record(s, Render, entry.second.uploaded, now);
+    record(s, Total, entry.second.source, now);
+  }
+  m_uploaded.clear();
+}
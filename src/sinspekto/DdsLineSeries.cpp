@@ -0,0 +1,434 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <QPainter>
+#include <QPen>
+#include <QQuickWindow>
+#include <QSGFlatColorMaterial>
+#include <QSGGeometryNode>
+#include <QSGRenderNode>
+#include <QSGRendererInterface>
+#include <QSGTransformNode>
+#include "sinspekto/DdsLineSeries.hpp"
+
+namespace
+{
+  /// Largest vertex offset from the origin before the vertices are rebased, keeps a
+  /// resolution of about 0.06 in single precision.
+  constexpr double rebase_limit = 1e6;
+
+  /**
+     @brief Line segments drawn with OpenGL.
+
+     Segment n, from sample n-1 to sample n, has its two vertices in slot n % capacity.
+     A new sample therefore only changes its own slot, and the slot of the oldest sample,
+     which is collapsed to a point since its predecessor is gone.
+  */
+  class LineGeometryNode : public QSGGeometryNode
+  {
+  public:
+    explicit LineGeometryNode(size_t capacity) :
+      m_geometry(QSGGeometry::defaultAttributes_Point2D(), static_cast<int>(2*capacity))
+    {
+      m_geometry.setDrawingMode(QSGGeometry::DrawLines);
+      m_geometry.setVertexDataPattern(QSGGeometry::StreamPattern);
+      clear();
+      setGeometry(&m_geometry);
+      setMaterial(&m_material);
+    }
+
+    /// Collapse all segments.
+    void clear()
+    {
+      QSGGeometry::Point2D *v = m_geometry.vertexDataAsPoint2D();
+      std::fill(v, v + m_geometry.vertexCount(), QSGGeometry::Point2D{0.0f, 0.0f});
+    }
+
+    /// Set the segment in a slot.
+    void setSegment(size_t slot, const QPointF& from, const QPointF& to)
+    {
+      QSGGeometry::Point2D *v = m_geometry.vertexDataAsPoint2D() + 2*slot;
+      v[0].set(static_cast<float>(from.x()), static_cast<float>(from.y()));
+      v[1].set(static_cast<float>(to.x()), static_cast<float>(to.y()));
+    }
+
+    QSGGeometry m_geometry; ///< Two vertices per slot.
+    QSGFlatColorMaterial m_material; ///< Line color.
+  };
+
+  /**
+     @brief Polyline drawn with QPainter for the software backend.
+
+     Keeps a copy of the sample ring, and draws it as two polylines joined across the
+     wrap-around of the ring.
+  */
+  class LinePainterNode : public QSGRenderNode
+  {
+  public:
+    LinePainterNode(QQuickWindow *window, size_t capacity) :
+      m_window(window),
+      m_points(static_cast<int>(capacity)),
+      m_start(0),
+      m_count(0),
+      m_lineWidth(1.0)
+    {}
+
+    void render(const RenderState *state) override
+    {
+      auto painter = static_cast<QPainter *>(
+       m_window->rendererInterface()->getResource(m_window, QSGRendererInterface::PainterResource));
+      if(!painter || m_count < 2) return;
+
+      const QRegion *clip = state->clipRegion();
+      if(clip && !clip->isEmpty())
+        painter->setClipRegion(*clip, Qt::ReplaceClip);
+      painter->setTransform(matrix()->toTransform());
+      painter->setOpacity(inheritedOpacity());
+
+      QPen pen(m_color, m_lineWidth);
+      pen.setCosmetic(true);
+      painter->setPen(pen);
+
+      const int capacity = m_points.size();
+      const int first = std::min(m_count, capacity - m_start);
+      painter->drawPolyline(m_points.constData() + m_start, first);
+      if(first < m_count)
+      {
+        painter->drawLine(m_points[capacity - 1], m_points[0]);
+        painter->drawPolyline(m_points.constData(), m_count - first);
+      }
+    }
+
+    StateFlags changedStates() const override { return StateFlags(); }
+
+    QQuickWindow *m_window; ///< Window providing the painter.
+    QVector<QPointF> m_points; ///< Copy of the sample ring.
+    int m_start; ///< Slot of the oldest sample.
+    int m_count; ///< Number of samples.
+    QColor m_color; ///< Line color.
+    qreal m_lineWidth; ///< Line width.
+  };
+
+  /// Transform from data to item coordinates, with the node drawing the lines as child.
+  class LineRootNode : public QSGTransformNode
+  {
+  public:
+    explicit LineRootNode(size_t capacity) :
+      m_capacity(capacity),
+      m_lines(nullptr),
+      m_painter(nullptr)
+    {}
+
+    size_t m_capacity; ///< Capacity of the sample ring.
+    LineGeometryNode *m_lines; ///< OpenGL lines, owned by the node tree.
+    LinePainterNode *m_painter; ///< Software lines, owned by the node tree.
+  };
+}
+
+DdsLineSeries::DdsLineSeries(QQuickItem *parent) :
+  QQuickItem(parent),
+  m_source(nullptr),
+  m_xDim(qml_enums::DimId::T),
+  m_yDim(qml_enums::DimId::X),
+  m_xBuffer(nullptr),
+  m_yBuffer(nullptr),
+  m_validDims(false),
+  m_minX(0.0),
+  m_maxX(1.0),
+  m_minY(0.0),
+  m_maxY(1.0),
+  m_color(Qt::black),
+  m_lineWidth(1.0),
+  m_appended(0),
+  m_first(0),
+  m_dirtyFrom(0),
+  m_rebuildNodes(true)
+{
+  setFlag(ItemHasContents, true);
+  setClip(true);
+}
+
+DdsLineSeries::~DdsLineSeries()
+{}
+
+void DdsLineSeries::setSource(DdsBuffer *source)
+{
+  if(source == m_source) return;
+
+  if(m_source)
+    QObject::disconnect(m_source, nullptr, this, nullptr);
+
+  m_source = source;
+
+  if(m_source)
+  {
+    // newData() is declared by each buffer type, not by DdsBuffer
+    if(!QObject::connect(m_source, SIGNAL(newData()), this, SLOT(sourceUpdated())))
+      std::cerr << "DdsLineSeries: source has no newData() signal" << std::endl;
+    QObject::connect(m_source, &QObject::destroyed, this, &DdsLineSeries::sourceDestroyed);
+  }
+
+  resolveDims();
+  rebuild();
+  emit sourceChanged();
+}
+
+void DdsLineSeries::setXDim(qml_enums::DimId dim)
+{
+  if(dim == m_xDim) return;
+  m_xDim = dim;
+  resolveDims();
+  rebuild();
+  emit xDimChanged();
+}
+
+void DdsLineSeries::setYDim(qml_enums::DimId dim)
+{
+  if(dim == m_yDim) return;
+  m_yDim = dim;
+  resolveDims();
+  rebuild();
+  emit yDimChanged();
+}
+
+void DdsLineSeries::setMinX(double value)
+{
+  if(value == m_minX) return;
+  m_minX = value;
+  update();
+  emit rangeChanged();
+}
+
+void DdsLineSeries::setMaxX(double value)
+{
+  if(value == m_maxX) return;
+  m_maxX = value;
+  update();
+  emit rangeChanged();
+}
+
+void DdsLineSeries::setMinY(double value)
+{
+  if(value == m_minY) return;
+  m_minY = value;
+  update();
+  emit rangeChanged();
+}
+
+void DdsLineSeries::setMaxY(double value)
+{
+  if(value == m_maxY) return;
+  m_maxY = value;
+  update();
+  emit rangeChanged();
+}
+
+void DdsLineSeries::setColor(const QColor& color)
+{
+  if(color == m_color) return;
+  m_color = color;
+  update();
+  emit colorChanged();
+}
+
+void DdsLineSeries::setLineWidth(qreal width)
+{
+  if(width == m_lineWidth) return;
+  m_lineWidth = width;
+  update();
+  emit lineWidthChanged();
+}
+
+void DdsLineSeries::sourceDestroyed()
+{
+  m_source = nullptr;
+  resolveDims();
+  rebuild();
+  emit sourceChanged();
+}
+
+void DdsLineSeries::resolveDims()
+{
+  m_xBuffer = nullptr;
+  m_yBuffer = nullptr;
+  m_validDims = false;
+  if(!m_source) return;
+
+  // The dimensions of a buffer are fixed at construction, so the pointers stay valid
+  if(m_xDim != qml_enums::DimId::T) m_xBuffer = m_source->dimension(m_xDim);
+  if(m_yDim != qml_enums::DimId::T) m_yBuffer = m_source->dimension(m_yDim);
+  m_validDims =
+   (m_xDim == qml_enums::DimId::T || m_xBuffer) &&
+   (m_yDim == qml_enums::DimId::T || m_yBuffer);
+}
+
+double DdsLineSeries::sample(const DdsDoubleBuffer *dim, size_t index) const
+{
+  if(!dim)
+    return static_cast<double>(m_source->timepoints()->Buffer()[index]);
+  return dim->Buffer()[index];
+}
+
+void DdsLineSeries::rebuild()
+{
+  m_points.clear();
+  m_appended = 0;
+  m_first = 0;
+  m_dirtyFrom = 0;
+  m_rebuildNodes = true;
+
+  if(m_source && m_source->timepoints() && m_validDims)
+  {
+    const DdsTimepointBuffer *time = m_source->timepoints();
+    const size_t capacity = time->Buffer().capacity();
+    const size_t size = time->Buffer().size();
+
+    m_source->metrics().rebuilds.fetch_add(1, std::memory_order_relaxed);
+    m_points.resize(capacity);
+    m_appended = time->appended();
+    m_first = m_appended - size;
+    m_dirtyFrom = m_first;
+
+    // Newest sample as origin, since the data continues from there
+    if(size > 0)
+      m_origin = QPointF(sample(m_xBuffer, size - 1), sample(m_yBuffer, size - 1));
+
+    for(size_t i = 0; i < size; ++i)
+    {
+      m_points[(m_first + i) % capacity] = QPointF(
+       sample(m_xBuffer, i) - m_origin.x(),
+       sample(m_yBuffer, i) - m_origin.y());
+    }
+  }
+
+  update();
+}
+
+void DdsLineSeries::sourceUpdated()
+{
+  if(!m_source || !m_source->timepoints() || !m_validDims) return;
+
+  const DdsTimepointBuffer *time = m_source->timepoints();
+  const size_t capacity = time->Buffer().capacity();
+  const size_t size = time->Buffer().size();
+  const uint64_t appended = time->appended();
+
+  if(capacity == 0) return;
+
+  // Cleared, resized, or more new samples than fit in the ring
+  if(capacity != m_points.size() || appended < m_appended || appended - m_appended > capacity)
+  {
+    rebuild();
+    return;
+  }
+
+  for(uint64_t n = m_appended; n < appended; ++n)
+  {
+    const size_t index = size - static_cast<size_t>(appended - n);
+    const QPointF point(
+     sample(m_xBuffer, index) - m_origin.x(),
+     sample(m_yBuffer, index) - m_origin.y());
+
+    if(std::abs(point.x()) > rebase_limit || std::abs(point.y()) > rebase_limit)
+    {
+      rebuild();
+      return;
+    }
+    m_points[n % capacity] = point;
+  }
+
+  m_appended = appended;
+  m_first = appended - size;
+  update();
+}
+
+QSGNode *DdsLineSeries::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *)
+{
+  auto root = static_cast<LineRootNode *>(oldNode);
+  const size_t capacity = m_points.size();
+
+  if(capacity == 0 || width() <= 0.0 || height() <= 0.0 || m_maxX <= m_minX || m_maxY <= m_minY)
+  {
+    delete root;
+    m_rebuildNodes = true;
+    return nullptr;
+  }
+
+  if(!root || root->m_capacity != capacity)
+  {
+    delete root;
+    root = new LineRootNode(capacity);
+
+    if(window()->rendererInterface()->graphicsApi() == QSGRendererInterface::Software)
+    {
+      root->m_painter = new LinePainterNode(window(), capacity);
+      root->appendChildNode(root->m_painter);
+    }
+    else
+    {
+      root->m_lines = new LineGeometryNode(capacity);
+      root->appendChildNode(root->m_lines);
+    }
+    m_rebuildNodes = true;
+  }
+
+  const uint64_t from = m_rebuildNodes ? m_first : std::max(m_dirtyFrom, m_first);
+
+  // The GUI thread is blocked while the scene graph synchronizes
+  if(m_source && from < m_appended)
+  {
+    m_source->metrics().points.fetch_add(m_appended - from, std::memory_order_relaxed);
+    m_source->traceUploaded();
+  }
+
+  if(root->m_lines)
+  {
+    LineGeometryNode *lines = root->m_lines;
+    if(m_rebuildNodes) lines->clear();
+
+    for(uint64_t n = from; n < m_appended; ++n)
+    {
+      const QPointF& to = m_points[n % capacity];
+      lines->setSegment(n % capacity, n > m_first ? m_points[(n - 1) % capacity] : to, to);
+    }
+    if(m_appended > m_first)
+    {
+      const QPointF& oldest = m_points[m_first % capacity];
+      lines->setSegment(m_first % capacity, oldest, oldest);
+    }
+
+    if(lines->m_material.color() != m_color)
+    {
+      lines->m_material.setColor(m_color);
+      lines->markDirty(QSGNode::DirtyMaterial);
+    }
+    lines->m_geometry.setLineWidth(static_cast<float>(m_lineWidth));
+    lines->markDirty(QSGNode::DirtyGeometry);
+  }
+  else
+  {
+    LinePainterNode *painter = root->m_painter;
+    for(uint64_t n = from; n < m_appended; ++n)
+      painter->m_points[static_cast<int>(n % capacity)] = m_points[n % capacity];
+
+    painter->m_start = static_cast<int>(m_first % capacity);
+    painter->m_count = static_cast<int>(m_appended - m_first);
+    painter->m_color = m_color;
+    painter->m_lineWidth = m_lineWidth;
+    painter->markDirty(QSGNode::DirtyMaterial);
+  }
+
+  // Map vertices relative to origin onto the item, with y pointing up
+  const double sx = width()/(m_maxX - m_minX);
+  const double sy = height()/(m_maxY - m_minY);
+  QMatrix4x4 matrix;
+  matrix.translate(
+   static_cast<float>((m_origin.x() - m_minX)*sx),
+   static_cast<float>(height() - (m_origin.y() - m_minY)*sy));
+  matrix.scale(static_cast<float>(sx), static_cast<float>(-sy));
+  root->setMatrix(matrix);
+
+  m_dirtyFrom = m_appended;
+  m_rebuildNodes = false;
+  return root;
+}
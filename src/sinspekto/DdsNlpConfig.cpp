@@ -28,9 +28,10 @@ void DdsNlpConfigSubscriber::init(
   {
     m_reader->listener = sinspekto::DdsReaderListener<fkin::NlpConfig>(
         std::bind(&DdsNlpConfigSubscriber::eventHeard, this));
-    m_reader->reader.listener(&m_reader->listener, dds::core::status::StatusMask::data_available());
+    m_reader->listen();
 
-    QObject::connect(this, &DdsNlpConfigSubscriber::eventHeard, this, &DdsNlpConfigSubscriber::updateValues);
+    sinspekto::connect_event(
+        this, &DdsNlpConfigSubscriber::eventHeard, &DdsNlpConfigSubscriber::updateValues, topic);
   }
 }
 
@@ -98,22 +99,8 @@ QDateTime DdsNlpConfigSubscriber::timestamp() const
 void DdsNlpConfigSubscriber::updateValues()
 {
   if(!m_reader) return;
-  const auto query = dds::sub::Query(
-      m_reader->reader,
-      "id = %0", {m_id.toStdString()});
-  dds::sub::LoanedSamples<fkin::NlpConfig> samples =
-    m_reader->reader.select()
-    .content(query)
-    .state(dds::sub::status::DataState::new_data()).take();
-  uint32_t num = samples.length();
-
-  if(num > 0)
+  if(m_reader->takeLast(m_id.toStdString()))
     {
-      auto sample = (--samples.end()); // picks the last sample
-      m_reader->sample = sample->data();
-      m_reader->timepoint = sample->info().timestamp();
-      auto datetime = QDateTime();
-
       emit techniqueChanged(QString::fromStdString(m_reader->sample.technique()));
       emit solverChanged(QString::fromStdString(m_reader->sample.solver()));
       emit degreeChanged(m_reader->sample.degree());
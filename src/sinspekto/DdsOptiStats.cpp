@@ -28,9 +28,10 @@ void DdsOptiStatsSubscriber::init(
   {
     m_reader->listener = sinspekto::DdsReaderListener<fkin::OptiStats>(
         std::bind(&DdsOptiStatsSubscriber::eventHeard, this));
-    m_reader->reader.listener(&m_reader->listener, dds::core::status::StatusMask::data_available());
+    m_reader->listen();
 
-    QObject::connect(this, &DdsOptiStatsSubscriber::eventHeard, this, &DdsOptiStatsSubscriber::updateValues);
+    sinspekto::connect_event(
+        this, &DdsOptiStatsSubscriber::eventHeard, &DdsOptiStatsSubscriber::updateValues, topic);
   }
 }
 
@@ -92,22 +93,8 @@ QDateTime DdsOptiStatsSubscriber::timestamp() const
 void DdsOptiStatsSubscriber::updateValues()
 {
   if(!m_reader) return;
-  const auto query = dds::sub::Query(
-      m_reader->reader,
-      "id = %0", {m_id.toStdString()});
-  dds::sub::LoanedSamples<fkin::OptiStats> samples =
-    m_reader->reader.select()
-    .content(query)
-    .state(dds::sub::status::DataState::new_data()).take();
-  uint32_t num = samples.length();
-
-  if(num > 0)
+  if(m_reader->takeLast(m_id.toStdString()))
     {
-      auto sample = (--samples.end()); // picks the last sample
-      m_reader->sample = sample->data();
-      m_reader->timepoint = sample->info().timestamp();
-      auto datetime = QDateTime();
-
       emit iterationsChanged(m_reader->sample.iterations());
       emit statusChanged(m_reader->sample.status());
       emit status_textChanged(QString::fromStdString(m_reader->sample.status_text()));
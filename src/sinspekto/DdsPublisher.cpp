@@ -0,0 +1,365 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <exception>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QTimer>
+#include "sinspekto/DdsPublisher.hpp"
+#include "sinspekto/MpscQueue.hpp"
+#include "sinspekto/TimerWheel.hpp"
+
+namespace
+{
+  /// Milliseconds of a monotonic clock.
+  int64_t steadyMs()
+  {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  /// Delay before retrying a write that could not be queued, milliseconds.
+  constexpr int64_t congestion_retry_ms = 5;
+
+  /**
+     @brief Thread that carries out asynchronous writes of all publishers in order.
+
+     The thread sleeps on a condition variable when the queue is empty. Producers only
+     take the mutex to wake it, when it has announced that it is idle. The fences order
+     the push before the load of m_idle, and the store of m_idle before the check of the
+     queue, so at least one side sees the other and no write is left behind.
+  */
+  class WriteWorker
+  {
+  public:
+    WriteWorker() :
+      m_queue(1024),
+      m_running(true),
+      m_idle(false),
+      m_thread([this](){ run(); })
+    {}
+
+    ~WriteWorker() { stop(); }
+
+    /// Queue a write, false if the queue is full.
+    bool push(std::function<void()>&& task)
+    {
+      if(!m_queue.push(std::move(task))) return false;
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if(m_idle.load())
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_wake.notify_one();
+      }
+      return true;
+    }
+
+    /// Carry out the queued writes, and end the thread.
+    void stop()
+    {
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if(!m_running) return;
+        m_running = false;
+      }
+      m_wake.notify_one();
+      if(m_thread.joinable()) m_thread.join();
+    }
+
+  private:
+    void run()
+    {
+      std::function<void()> task;
+      for(;;)
+      {
+        while(m_queue.pop(task))
+        {
+          try { task(); }
+          catch(const std::exception& e)
+          {
+            std::cerr << "DdsPublisher: asynchronous write failed: " << e.what() << std::endl;
+          }
+          catch(...)
+          {
+            std::cerr << "DdsPublisher: asynchronous write failed" << std::endl;
+          }
+          task = nullptr;
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_idle.store(true);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        m_wake.wait(lock, [this](){ return !m_running || !m_queue.empty(); });
+        m_idle.store(false);
+        if(!m_running && m_queue.empty()) return;
+      }
+    }
+
+    sinspekto::MpscQueue<std::function<void()>> m_queue; ///< Writes to carry out.
+    std::mutex m_mutex; ///< Only for sleeping and waking.
+    std::condition_variable m_wake; ///< Wakes the thread.
+    bool m_running; ///< Cleared to end the thread, guarded by m_mutex.
+    std::atomic<bool> m_idle; ///< The thread sleeps or is about to.
+    std::thread m_thread; ///< The writer thread, declared last to start after the members.
+  };
+
+  WriteWorker& writeWorker()
+  {
+    static WriteWorker worker;
+    static bool registered = false;
+    if(!registered)
+    {
+      // Finish the writes while DDS is still alive, before static destruction
+      registered = true;
+      qAddPostRoutine([](){ writeWorker().stop(); });
+    }
+    return worker;
+  }
+}
+
+DdsPublisher::DdsPublisher(QObject *parent) :
+  QObject(parent),
+  m_maxRateHz(0.0),
+  m_lastWriteMs(std::numeric_limits<int64_t>::min()/2),
+  m_dueMs(0),
+  m_pending(false),
+  m_pendingTimer(0),
+  m_updateDepth(0),
+  m_updateChanged(false),
+  m_asyncWrite(false),
+  m_maxQueuedWrites(16),
+  m_congested(false),
+  m_written(false),
+  m_queued(std::make_shared<std::atomic<int>>(0))
+{}
+
+DdsPublisher::~DdsPublisher()
+{
+  cancelPending();
+}
+
+double DdsPublisher::maxRateHz() const { return m_maxRateHz; }
+
+void DdsPublisher::setMaxRateHz(double rate)
+{
+  if(rate == m_maxRateHz) return;
+  m_maxRateHz = rate;
+
+  if(m_pending)
+  {
+    cancelPending();
+    requestWrite();
+  }
+  emit maxRateHzChanged(rate);
+}
+
+bool DdsPublisher::asyncWrite() const { return m_asyncWrite; }
+int DdsPublisher::maxQueuedWrites() const { return m_maxQueuedWrites; }
+bool DdsPublisher::congested() const { return m_congested; }
+int DdsPublisher::queuedWrites() const { return m_queued->load(); }
+
+void DdsPublisher::setAsyncWrite(bool async)
+{
+  if(async == m_asyncWrite) return;
+  m_asyncWrite = async;
+  // Synchronous writes cannot congest
+  if(!async) setCongested(false);
+  emit asyncWriteChanged(async);
+}
+
+void DdsPublisher::setMaxQueuedWrites(int limit)
+{
+  if(limit == m_maxQueuedWrites) return;
+  m_maxQueuedWrites = limit;
+  emit maxQueuedWritesChanged(limit);
+}
+
+void DdsPublisher::setCongested(bool congested)
+{
+  if(congested == m_congested) return;
+  m_congested = congested;
+  emit congestedChanged(congested);
+}
+
+void DdsPublisher::enqueue(std::function<void()>&& task)
+{
+  auto queued = m_queued;
+  if(queued->load() < m_maxQueuedWrites)
+  {
+    ++*queued;
+    auto counted =
+     [queued, task = std::move(task)]()
+     {
+       try { task(); }
+       catch(...) { --*queued; throw; }
+       --*queued;
+     };
+    if(writeWorker().push(std::move(counted)))
+    {
+      m_written = true;
+      setCongested(false);
+      return;
+    }
+    --*queued;
+  }
+
+  // Retry with the sample at that time, which supersedes this one
+  m_written = false;
+  setCongested(true);
+  if(!m_pending)
+  {
+    m_dueMs = steadyMs() + congestion_retry_ms;
+    schedulePending();
+  }
+}
+
+void DdsPublisher::beginUpdate()
+{
+  ++m_updateDepth;
+}
+
+void DdsPublisher::commit()
+{
+  if(m_updateDepth == 0)
+  {
+    std::cerr << "DdsPublisher: commit() without beginUpdate()" << std::endl;
+    return;
+  }
+  if(--m_updateDepth > 0 || !m_updateChanged) return;
+
+  m_updateChanged = false;
+  requestWrite();
+}
+
+void DdsPublisher::markChanged()
+{
+  if(m_updateDepth > 0) m_updateChanged = true;
+}
+
+void DdsPublisher::requestWrite()
+{
+  if(m_updateDepth > 0)
+  {
+    m_updateChanged = true;
+    return;
+  }
+
+  if(m_maxRateHz <= 0.0)
+  {
+    writeNow();
+    return;
+  }
+
+  // The pending write takes the latest sample, whenever it happens
+  if(m_pending) return;
+
+  const int64_t periodMs = static_cast<int64_t>(std::ceil(1000.0/m_maxRateHz));
+  const int64_t now = steadyMs();
+  if(now - m_lastWriteMs >= periodMs)
+  {
+    writeNow();
+    return;
+  }
+
+  m_dueMs = m_lastWriteMs + periodMs;
+  schedulePending();
+}
+
+void DdsPublisher::writeNow()
+{
+  cancelPending();
+  m_lastWriteMs = steadyMs();
+  writeSample();
+}
+
+void DdsPublisher::schedulePending()
+{
+  m_pending = true;
+  m_pendingTimer = sinspekto::TimerWheel::instance().schedule(
+      std::max<int64_t>(0, m_dueMs - steadyMs()),
+      [this]()
+      {
+        m_pending = false;
+        writeNow();
+      });
+}
+
+void DdsPublisher::cancelPending()
+{
+  if(!m_pending) return;
+  m_pending = false;
+  sinspekto::TimerWheel::instance().cancel(m_pendingTimer);
+}
+
+DdsBatchPublisher::DdsBatchPublisher(QObject *parent) :
+  DdsPublisher(parent),
+  m_maxBatchSize(100),
+  m_maxBatchAgeMs(100)
+{
+  m_ageTimer.setSingleShot(true);
+  m_ageTimer.setTimerType(Qt::PreciseTimer);
+
+  QObject::connect(
+      &m_ageTimer, &QTimer::timeout,
+      this, &DdsBatchPublisher::flush);
+}
+
+DdsBatchPublisher::~DdsBatchPublisher() = default;
+
+int DdsBatchPublisher::maxBatchSize() const { return m_maxBatchSize; }
+int DdsBatchPublisher::maxBatchAgeMs() const { return m_maxBatchAgeMs; }
+
+void DdsBatchPublisher::setMaxBatchSize(int size)
+{
+  size = std::max(1, size);
+  if(size == m_maxBatchSize) return;
+  m_maxBatchSize = size;
+  emit maxBatchSizeChanged(size);
+
+  if(batchSize() >= m_maxBatchSize) flush();
+}
+
+void DdsBatchPublisher::setMaxBatchAgeMs(int age)
+{
+  if(age == m_maxBatchAgeMs) return;
+  m_maxBatchAgeMs = age;
+  emit maxBatchAgeMsChanged(age);
+
+  // The new age applies from now on to the samples already collected
+  m_ageTimer.stop();
+  if(batchSize() > 0 && m_maxBatchAgeMs > 0) m_ageTimer.start(m_maxBatchAgeMs);
+}
+
+void DdsBatchPublisher::flush()
+{
+  m_ageTimer.stop();
+  if(batchSize() > 0) writeNow();
+}
+
+void DdsBatchPublisher::sampleAppended()
+{
+  const int size = batchSize();
+  emit batchSizeChanged(size);
+
+  if(size >= m_maxBatchSize)
+    flush();
+  else if(!m_ageTimer.isActive() && m_maxBatchAgeMs > 0)
+    m_ageTimer.start(m_maxBatchAgeMs);
+}
+
+void DdsBatchPublisher::batchCleared()
+{
+  m_ageTimer.stop();
+  emit batchSizeChanged(0);
+}
+
+int64_t DdsBatchPublisher::nowMillis()
+{
+  return QDateTime::currentMSecsSinceEpoch();
+}
@@ -2,6 +2,9 @@
 #include "sinspekto/DdsStateAutomaton.hpp"
 #include "sinspekto/QtToDdsPriv.hpp"
 
+#include <algorithm>
+#include <utility>
+
 // TODO: Move to namespace
 typedef std::map<fkin::ProcessStateKind, QString> ProcessStateName;
 
@@ -32,8 +35,9 @@ void DdsStateAutomaton::init(
   m_reader = std::make_unique<sinspekto::Reader<fkin::ProcessStateAutomaton>>(dds, notifyTopicName, true);
   m_reader->listener = sinspekto::DdsReaderListener<fkin::ProcessStateAutomaton>(
       std::bind(&DdsStateAutomaton::eventHeard, this));
-  m_reader->reader.listener(&m_reader->listener, dds::core::status::StatusMask::data_available());
-  QObject::connect(this, &DdsStateAutomaton::eventHeard, this, &DdsStateAutomaton::updateState);
+  m_reader->listen();
+  sinspekto::connect_event(
+      this, &DdsStateAutomaton::eventHeard, &DdsStateAutomaton::updateState, notifyTopicName);
 }
 
 fkin::ProcessStateKind DdsStateAutomaton::state() const
@@ -52,25 +56,172 @@ void DdsStateAutomaton::updateState()
 {
   if(!m_reader) return;
 
-  const auto query = dds::sub::Query(
-      m_reader->reader,
-      "identifier = %0",
-      {m_identifier.toStdString()});
+  auto old_state = m_reader->sample.state();
+  if(m_reader->takeLast(
+         "identifier", m_identifier.toStdString(),
+         [](const fkin::ProcessStateAutomaton& s) { return s.identifier(); }))
+  {
+    if( old_state != m_reader->sample.state())
+    {
+      emit stateChanged(m_reader->sample.state());
+      emit stateNameChanged(processStateName_t[m_reader->sample.state()]);
+    }
+  }
+}
+
+
+DdsProcessStateModel::DdsProcessStateModel(QObject *parent) :
+  QAbstractListModel(parent),
+  m_reader(nullptr)
+{}
+
+DdsProcessStateModel::~DdsProcessStateModel() = default;
+
+void DdsProcessStateModel::init(QtToDds* dds, const QString& topic)
+{
+  if(dds->loopback())
+  {
+    std::cerr << "DdsProcessStateModel: topic " << topic.toStdString()
+              << " is not supported by the loopback transport" << std::endl;
+    return;
+  }
+
+  m_reader = std::make_unique<sinspekto::Reader<fkin::ProcessStateAutomaton>>(dds, topic, true);
+  m_reader->listener = sinspekto::DdsReaderListener<fkin::ProcessStateAutomaton>(
+      std::bind(&DdsProcessStateModel::eventHeard, this));
+  m_reader->listen();
+  sinspekto::connect_event(
+      this, &DdsProcessStateModel::eventHeard, &DdsProcessStateModel::updateStates, topic);
+
+  // Transient local samples may have arrived before the listener was set
+  updateStates();
+}
+
+int DdsProcessStateModel::rowCount(const QModelIndex& parent) const
+{
+  if(parent.isValid()) return 0;
+  return count();
+}
+
+QVariant DdsProcessStateModel::data(const QModelIndex& index, int role) const
+{
+  if(!index.isValid() || index.row() < 0 || index.row() >= count()) return QVariant();
+
+  const Row& row = m_rows[static_cast<size_t>(index.row())];
+  switch(role)
+  {
+  case Qt::DisplayRole:
+  case IdentifierRole:
+    return row.identifier;
+  case StateRole:
+    return QVariant::fromValue(row.state);
+  case StateNameRole:
+    return processStateName_t[row.state];
+  case TimestampRole:
+    return row.timestamp;
+  default:
+    return QVariant();
+  }
+}
+
+QHash<int, QByteArray> DdsProcessStateModel::roleNames() const
+{
+  return {
+    { IdentifierRole, "identifier" },
+    { StateRole, "state" },
+    { StateNameRole, "stateName" },
+    { TimestampRole, "timestamp" }
+  };
+}
+
+int DdsProcessStateModel::indexOf(const QString& identifier) const
+{
+  return m_rowIndex.value(identifier, -1);
+}
+
+fkin::ProcessStateKind DdsProcessStateModel::state(const QString& identifier) const
+{
+  const int row = indexOf(identifier);
+  if(row < 0) return fkin::ProcessStateKind::UNKNOWN;
+  return m_rows[static_cast<size_t>(row)].state;
+}
+
+void DdsProcessStateModel::updateStates()
+{
+  if(!m_reader) return;
 
   dds::sub::LoanedSamples<fkin::ProcessStateAutomaton> samples =
    m_reader->reader.select()
    .state(dds::sub::status::DataState::new_data())
-   .content(query).take();
+   .take();
 
-  if(samples.length() > 0)
+  const int oldCount = count();
+  std::vector<Row> added; // rows of new identifiers, inserted together below
+  QHash<QString, int> addedIndex; // row of each new identifier, moved to m_rowIndex with the rows
+  std::vector<int> stateChanged, timeChanged;
+  // Emitted last, so that handlers find the rows in the model
+  std::vector<std::pair<QString, fkin::ProcessStateKind>> changes;
+
+  for(const auto& sample : samples)
   {
-    auto old_state = m_reader->sample.state();
+    if(!sample.info().valid()) continue;
 
-    m_reader->sample = (--samples.end())->data();
-    if( old_state != m_reader->sample.state())
+    const auto& data = sample.data();
+    const QString identifier = QString::fromStdString(data.identifier());
+    const auto& stamp = sample.info().timestamp();
+    const QDateTime timestamp = QDateTime::fromMSecsSinceEpoch(
+        static_cast<qint64>(stamp.sec())*1000 + stamp.nanosec()/1000000);
+
+    int rowIndex = m_rowIndex.value(identifier, -1);
+    if(rowIndex < 0) rowIndex = addedIndex.value(identifier, -1);
+    if(rowIndex < 0)
     {
-      emit stateChanged(m_reader->sample.state());
-      emit stateNameChanged(processStateName_t[m_reader->sample.state()]);
+      addedIndex.insert(identifier, oldCount + static_cast<int>(added.size()));
+      added.push_back(Row{identifier, data.state(), timestamp});
+      changes.emplace_back(identifier, data.state());
+      continue;
+    }
+
+    Row& row = rowIndex < oldCount
+     ? m_rows[static_cast<size_t>(rowIndex)]
+     : added[static_cast<size_t>(rowIndex - oldCount)];
+    row.timestamp = timestamp;
+    if(row.state == data.state())
+    {
+      if(rowIndex < oldCount) timeChanged.push_back(rowIndex);
+      continue;
     }
+
+    row.state = data.state();
+    if(rowIndex < oldCount) stateChanged.push_back(rowIndex);
+    changes.emplace_back(identifier, row.state);
   }
+
+  if(!added.empty())
+  {
+    beginInsertRows(QModelIndex(), oldCount, oldCount + static_cast<int>(added.size()) - 1);
+    m_rows.insert(m_rows.end(), added.begin(), added.end());
+    for(auto it = addedIndex.constBegin(); it != addedIndex.constEnd(); ++it)
+      m_rowIndex.insert(it.key(), it.value());
+    endInsertRows();
+    emit countChanged();
+  }
+
+  // One notification per row, with only the roles that changed
+  auto notify =
+   [this](std::vector<int>& rows, const QVector<int>& roles, const std::vector<int>& skip)
+   {
+     std::sort(rows.begin(), rows.end());
+     rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+     for(int row : rows)
+     {
+       if(std::binary_search(skip.begin(), skip.end(), row)) continue;
+       emit dataChanged(index(row), index(row), roles);
+     }
+   };
+  notify(stateChanged, { StateRole, StateNameRole, TimestampRole }, {});
+  notify(timeChanged, { TimestampRole }, stateChanged);
+
+  for(const auto& change : changes)
+    emit processStateChanged(change.first, change.second);
 }
@@ -10,11 +10,21 @@ namespace sinspekto
       boost::circular_buffer<int64_t>& b1,
       boost::circular_buffer<double>& b2,
       QXYSeries *xySeries)
+  {
+    SeriesStaging staging;
+    return replace_data_points(b1, b2, xySeries, staging);
+  }
+
+  RangeTX replace_data_points(
+      boost::circular_buffer<int64_t>& b1,
+      boost::circular_buffer<double>& b2,
+      QXYSeries *xySeries,
+      SeriesStaging& staging)
   {
     assert(b1.size() == b2.size());
 
-    QVector<QPointF> bufferData;
-    bufferData.reserve(static_cast<int>(b1.size()));
+    QVector<QPointF>& bufferData = staging.next(static_cast<int>(b1.size()));
+    QPointF *point = bufferData.data();
 
     auto itX = b1.begin();
     auto itY = b2.begin();
@@ -37,7 +47,7 @@ namespace sinspekto
       if(val_y < min_y) min_y = val_y;
       if(val_y > max_y) max_y = val_y;
 
-      bufferData.push_back(QPointF(val_x, val_y));
+      *point++ = QPointF(val_x, val_y);
     }
 
     xySeries->replace(bufferData);
@@ -55,7 +65,8 @@ DdsTimepointBuffer::DdsTimepointBuffer(QObject *parent) :
   QObject(parent),
   m_buffer(0),
   m_min_t(QDateTime::currentDateTime()),
-  m_max_t(QDateTime::currentDateTime())
+  m_max_t(QDateTime::currentDateTime()),
+  m_appended(0)
 {}
 
 DdsTimepointBuffer::~DdsTimepointBuffer() = default;
@@ -65,6 +76,18 @@ void DdsTimepointBuffer::setCapacity(int buffer_size)
   m_buffer.set_capacity(buffer_size);
 }
 
+void DdsTimepointBuffer::append(int64_t timepoint)
+{
+  m_buffer.push_back(timepoint);
+  ++m_appended;
+}
+
+void DdsTimepointBuffer::clear()
+{
+  m_buffer.clear();
+  m_appended = 0;
+}
+
 QDateTime DdsTimepointBuffer::rangeTmin() const { return m_min_t; }
 QDateTime DdsTimepointBuffer::rangeTmax() const { return m_max_t; }
 
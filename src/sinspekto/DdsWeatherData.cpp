@@ -28,9 +28,10 @@ void DdsWeatherDataSubscriber::init(
   {
     m_reader->listener = sinspekto::DdsReaderListener<weather::ModuleData>(
         std::bind(&DdsWeatherDataSubscriber::eventHeard, this));
-    m_reader->reader.listener(&m_reader->listener, dds::core::status::StatusMask::data_available());
+    m_reader->listen();
 
-    QObject::connect(this, &DdsWeatherDataSubscriber::eventHeard, this, &DdsWeatherDataSubscriber::updateValues);
+    sinspekto::connect_event(
+        this, &DdsWeatherDataSubscriber::eventHeard, &DdsWeatherDataSubscriber::updateValues, topic);
   }
 }
 
@@ -134,22 +135,10 @@ QDateTime DdsWeatherDataSubscriber::timestamp() const
 void DdsWeatherDataSubscriber::updateValues()
 {
   if(!m_reader) return;
-  const auto query = dds::sub::Query(
-      m_reader->reader,
-      "module_name = %0", {m_id.toStdString()});
-  dds::sub::LoanedSamples<weather::ModuleData> samples =
-    m_reader->reader.select()
-    .content(query)
-    .state(dds::sub::status::DataState::new_data()).take();
-  uint32_t num = samples.length();
-
-  if(num > 0)
+  if(m_reader->takeLast(
+         "module_name", m_id.toStdString(),
+         [](const weather::ModuleData& s) { return s.module_name(); }))
     {
-      auto sample = (--samples.end()); // picks the last sample
-      m_reader->sample = sample->data();
-      m_reader->timepoint = sample->info().timestamp();
-      auto datetime = QDateTime();
-
       emit CO2Changed(m_reader->sample.CO2());
       emit noiseChanged(m_reader->sample.noise());
       emit humidityChanged(m_reader->sample.humidity());
@@ -0,0 +1,257 @@
+#include <algorithm>
+#include <chrono>
+#include <QCoreApplication>
+#include <QEvent>
+#include "sinspekto/EventLoopMonitor.hpp"
+#include "sinspekto/TimerWheel.hpp"
+
+namespace
+{
+  /// Event type of the probes, registered once.
+  QEvent::Type probeType()
+  {
+    static const QEvent::Type type = static_cast<QEvent::Type>(QEvent::registerEventType());
+    return type;
+  }
+
+  /// Probe event, carries the time it was due.
+  class ProbeEvent : public QEvent
+  {
+  public:
+    explicit ProbeEvent(int64_t due) : QEvent(probeType()), due(due) {}
+    const int64_t due; ///< Steady microseconds when the probe was due.
+  };
+
+  const int64_t windowUs = 1000000; ///< Statistics are evaluated once a second.
+}
+
+std::atomic<bool> EventLoopMonitor::s_active(false);
+std::atomic<int> EventLoopMonitor::s_queued(0);
+
+EventLoopMonitor::Dispatch::Dispatch(const QObject *adapter, const QString& name,
+                                     std::atomic<int>& pending) :
+  m_adapter(adapter),
+  m_name(name),
+  m_start(0)
+{
+  pending.fetch_sub(1, std::memory_order_relaxed);
+  const int waiting = s_queued.fetch_sub(1, std::memory_order_relaxed);
+  if(!s_active.load(std::memory_order_relaxed)) return;
+
+  EventLoopMonitor& monitor = instance();
+  monitor.m_windowQueueDepth = std::max(monitor.m_windowQueueDepth, waiting);
+  m_start = steadyMicros();
+}
+
+EventLoopMonitor::Dispatch::~Dispatch()
+{
+  if(m_start)
+    instance().slotFinished(m_adapter, m_name, steadyMicros() - m_start);
+}
+
+EventLoopMonitor::EventLoopMonitor(QObject *parent) :
+  QObject(parent),
+  m_probeIntervalMs(50),
+  m_latencyThresholdMs(100.0),
+  m_slotThresholdMs(20.0),
+  m_queueThreshold(100),
+  m_timer(0),
+  m_lastProbe(0),
+  m_windowStart(0),
+  m_windowLatencyUs(0),
+  m_windowQueueDepth(0),
+  m_latencyMs(0.0),
+  m_queueDepth(0)
+{
+  // Construct the wheel first, so that it outlives this static instance
+  sinspekto::TimerWheel::instance();
+}
+
+EventLoopMonitor::~EventLoopMonitor()
+{
+  if(m_timer) sinspekto::TimerWheel::instance().cancel(m_timer);
+}
+
+EventLoopMonitor& EventLoopMonitor::instance()
+{
+  static EventLoopMonitor monitor;
+  return monitor;
+}
+
+int64_t EventLoopMonitor::steadyMicros()
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void EventLoopMonitor::setEnabled(bool enabled)
+{
+  if(enabled == s_active.load()) return;
+
+  auto& wheel = sinspekto::TimerWheel::instance();
+  if(enabled)
+  {
+    m_slots.clear();
+    m_lastProbe = m_windowStart = steadyMicros();
+    m_windowLatencyUs = 0;
+    m_windowQueueDepth = 0;
+    m_timer = wheel.schedulePeriodic(m_probeIntervalMs, [this]() { postProbe(); });
+  }
+  else
+  {
+    wheel.cancel(m_timer);
+    m_timer = 0;
+  }
+
+  s_active.store(enabled);
+  emit enabledChanged(enabled);
+}
+
+void EventLoopMonitor::setProbeIntervalMs(int interval)
+{
+  interval = std::max(10, interval);
+  if(interval == m_probeIntervalMs) return;
+
+  m_probeIntervalMs = interval;
+  if(m_timer)
+  {
+    auto& wheel = sinspekto::TimerWheel::instance();
+    wheel.cancel(m_timer);
+    m_timer = wheel.schedulePeriodic(m_probeIntervalMs, [this]() { postProbe(); });
+  }
+  emit thresholdsChanged();
+}
+
+void EventLoopMonitor::setLatencyThresholdMs(double threshold)
+{
+  if(threshold == m_latencyThresholdMs) return;
+  m_latencyThresholdMs = threshold;
+  emit thresholdsChanged();
+}
+
+void EventLoopMonitor::setSlotThresholdMs(double threshold)
+{
+  if(threshold == m_slotThresholdMs) return;
+  m_slotThresholdMs = threshold;
+  emit thresholdsChanged();
+}
+
+void EventLoopMonitor::setQueueThreshold(int threshold)
+{
+  if(threshold == m_queueThreshold) return;
+  m_queueThreshold = threshold;
+  emit thresholdsChanged();
+}
+
+void EventLoopMonitor::postProbe()
+{
+  // Due one period after the last probe, a blocked loop makes the timer itself late
+  const int64_t now = steadyMicros();
+  const int64_t due = std::min(now, m_lastProbe + int64_t(m_probeIntervalMs)*1000);
+  m_lastProbe = now;
+  QCoreApplication::postEvent(this, new ProbeEvent(due));
+}
+
+bool EventLoopMonitor::event(QEvent *event)
+{
+  if(event->type() != probeType())
+    return QObject::event(event);
+
+  const int64_t now = steadyMicros();
+  m_windowLatencyUs = std::max(m_windowLatencyUs, now - static_cast<ProbeEvent *>(event)->due);
+  m_windowQueueDepth = std::max(m_windowQueueDepth, s_queued.load(std::memory_order_relaxed));
+
+  if(now - m_windowStart >= windowUs)
+    evaluate(now);
+  return true;
+}
+
+void EventLoopMonitor::slotFinished(const QObject *adapter, const QString& name, int64_t durationUs)
+{
+  SlotStats& stats = m_slots[adapter];
+  if(stats.calls == 0) stats.name = name;
+  ++stats.calls;
+  stats.totalUs += durationUs;
+  stats.maxUs = std::max(stats.maxUs, durationUs);
+}
+
+std::vector<EventLoopMonitor::SlotStats> EventLoopMonitor::sortedSlots() const
+{
+  std::vector<SlotStats> sorted;
+  sorted.reserve(m_slots.size());
+  for(const auto& entry : m_slots)
+    sorted.push_back(entry.second);
+
+  std::sort(sorted.begin(), sorted.end(),
+   [](const SlotStats& a, const SlotStats& b) { return a.maxUs > b.maxUs; });
+  return sorted;
+}
+
+void EventLoopMonitor::evaluate(int64_t now)
+{
+  m_lastSlots = sortedSlots();
+  m_latencyMs = static_cast<double>(m_windowLatencyUs)/1000.0;
+  m_queueDepth = m_windowQueueDepth;
+
+  const bool slowLoop = m_latencyMs > m_latencyThresholdMs;
+  const bool deepQueue = m_queueDepth > m_queueThreshold;
+
+  QStringList offenders;
+  for(const SlotStats& stats : m_lastSlots)
+  {
+    if(static_cast<double>(stats.maxUs)/1000.0 > m_slotThresholdMs) offenders.append(stats.name);
+  }
+  const bool slowSlots = !offenders.isEmpty();
+
+  // Congested without a slow slot, the busiest adapters are the best guess
+  if(!slowSlots && (slowLoop || deepQueue))
+  {
+    auto busiest = m_lastSlots;
+    std::sort(busiest.begin(), busiest.end(),
+     [](const SlotStats& a, const SlotStats& b) { return a.totalUs > b.totalUs; });
+    for(size_t i = 0; i < std::min<size_t>(3, busiest.size()); ++i)
+      offenders.append(busiest[i].name);
+  }
+
+  QString warning;
+  if(slowLoop || deepQueue || slowSlots)
+  {
+    QStringList reasons;
+    if(slowLoop) reasons.append(QString("event loop latency %1 ms").arg(m_latencyMs, 0, 'f', 1));
+    if(deepQueue) reasons.append(QString("%1 queued adapter events").arg(m_queueDepth));
+    if(slowSlots)
+      reasons.append(QString("slot of %1 took %2 ms")
+       .arg(m_lastSlots.front().name)
+       .arg(static_cast<double>(m_lastSlots.front().maxUs)/1000.0, 0, 'f', 1));
+    warning = reasons.join(", ");
+    if(!offenders.isEmpty()) warning += "; offenders: " + offenders.join(", ");
+  }
+
+  const bool notify = !warning.isEmpty() && (!congested() || offenders != m_offenders);
+  m_offenders = offenders;
+  m_warning = warning;
+
+  m_slots.clear();
+  m_windowStart = now;
+  m_windowLatencyUs = 0;
+  m_windowQueueDepth = 0;
+
+  emit statisticsChanged();
+  if(notify) emit congestionWarning(m_warning, m_offenders);
+}
+
+QVariantList EventLoopMonitor::slowestSlots(int count) const
+{
+  QVariantList list;
+  for(const SlotStats& stats : m_lastSlots)
+  {
+    if(list.size() >= count) break;
+    QVariantMap map;
+    map["name"] = stats.name;
+    map["calls"] = static_cast<qulonglong>(stats.calls);
+    map["maxMs"] = static_cast<double>(stats.maxUs)/1000.0;
+    map["meanMs"] = stats.calls ? static_cast<double>(stats.totalUs)/static_cast<double>(stats.calls)/1000.0 : 0.0;
+    list.append(map);
+  }
+  return list;
+}
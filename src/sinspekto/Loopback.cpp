@@ -0,0 +1,79 @@
+#include <exception>
+#include <iostream>
+#include <QCoreApplication>
+#include "sinspekto/Loopback.hpp"
+
+namespace sinspekto {
+
+  LoopbackBus::LoopbackBus() :
+    m_running(true),
+    m_thread([this](){ run(); })
+  {}
+
+  LoopbackBus::~LoopbackBus()
+  {
+    stop();
+  }
+
+  LoopbackBus& LoopbackBus::instance()
+  {
+    static LoopbackBus bus;
+    static bool registered = false;
+    if(!registered)
+    {
+      // Listeners emit signals of adapters, end the deliveries with the application
+      registered = true;
+      qAddPostRoutine([](){ instance().stop(); });
+    }
+    return bus;
+  }
+
+  void LoopbackBus::post(std::function<void()>&& task)
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if(!m_running) return;
+      m_tasks.push_back(std::move(task));
+    }
+    m_wake.notify_one();
+  }
+
+  void LoopbackBus::stop()
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if(!m_running) return;
+      m_running = false;
+    }
+    m_wake.notify_one();
+    if(m_thread.joinable()) m_thread.join();
+  }
+
+  void LoopbackBus::run()
+  {
+    std::deque<std::function<void()>> tasks;
+    for(;;)
+    {
+      {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_wake.wait(lock, [this](){ return !m_running || !m_tasks.empty(); });
+        if(m_tasks.empty()) return;
+        tasks.swap(m_tasks);
+      }
+
+      for(auto& task : tasks)
+      {
+        try { task(); }
+        catch(const std::exception& e)
+        {
+          std::cerr << "LoopbackBus: delivery failed: " << e.what() << std::endl;
+        }
+        catch(...)
+        {
+          std::cerr << "LoopbackBus: delivery failed" << std::endl;
+        }
+      }
+      tasks.clear();
+    }
+  }
+}
@@ -0,0 +1,228 @@
+#pragma once
+/**
+   @file Loopback.hpp
+   @brief In-process stand-in for DDS, used by QtToDds::initLoopback().
+*/
+
+#include <chrono>
+#include <cinttypes>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <typeindex>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+namespace sinspekto {
+
+  template <typename T> class LoopbackTopic;
+
+  /**
+     @brief Topics and delivery thread of the loopback transport.
+
+     Topics are identified by domain and name as in DDS, and each is bound to the type it
+     is first used with. Writers hand their samples to the readers of the topic right
+     away. Readers are notified on the delivery thread, which takes the place of the
+     listener threads of OpenSplice, so the adapters receive their eventHeard() signals
+     queued from another thread just as with DDS.
+  */
+  class LoopbackBus
+  {
+  public:
+    /// Bus shared by all QtToDds instances in loopback mode.
+    static LoopbackBus& instance();
+    /// Source timestamp of a written sample, milliseconds since epoch.
+    static int64_t nowMillis()
+    {
+      return std::chrono::duration_cast<std::chrono::milliseconds>(
+          std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    ~LoopbackBus();
+    LoopbackBus(const LoopbackBus&) = delete;
+    LoopbackBus& operator=(const LoopbackBus&) = delete;
+
+    /**
+       @brief Get a topic, created on first use.
+
+       @param[in] domain Domain given to QtToDds::initLoopback().
+       @param[in] name Topic name.
+       @return The topic, shared by all writers and readers of the name in the domain.
+       @throws std::runtime_error if the topic exists with another type.
+    */
+    template <typename T>
+    std::shared_ptr<LoopbackTopic<T>> topic(uint32_t domain, const std::string& name);
+
+    /// Run a task on the delivery thread.
+    void post(std::function<void()>&& task);
+    /// Run the remaining tasks and end the delivery thread.
+    void stop();
+
+  private:
+    LoopbackBus();
+    void run();
+
+    std::mutex m_topicMutex; ///< Guards m_topics.
+    std::map<std::pair<uint32_t, std::string>,
+             std::pair<std::type_index, std::shared_ptr<void>>> m_topics; ///< Topics with their type.
+    std::mutex m_mutex; ///< Guards the tasks and m_running.
+    std::condition_variable m_wake; ///< Wakes the delivery thread.
+    std::deque<std::function<void()>> m_tasks; ///< Notifications to deliver.
+    bool m_running; ///< Cleared to end the thread.
+    std::thread m_thread; ///< The delivery thread, declared last to start after the members.
+  };
+
+  /**
+     @brief Samples of a topic waiting to be taken by one reader.
+
+     A reader keeps at most depth samples, dropping the oldest, which bounds the memory of
+     a reader that is never drained. The listener is called once for all samples written
+     since the previous notification, as a DDS listener does when the data available
+     status is already set.
+  */
+  template <typename T>
+  class LoopbackReader : public std::enable_shared_from_this<LoopbackReader<T>>
+  {
+  public:
+    /// Sample with its source timestamp in milliseconds since epoch.
+    typedef std::pair<T, int64_t> Entry;
+
+    /// @param[in] depth Maximal number of samples waiting to be taken.
+    explicit LoopbackReader(size_t depth) :
+      m_depth(depth),
+      m_notified(false)
+    {}
+
+    /**
+       @brief Set the function called on the delivery thread when samples arrive.
+       @param[in] listener Function, or nullptr to stop the calls. No call is running when
+       this returns.
+    */
+    void setListener(std::function<void()> listener)
+    {
+      std::lock_guard<std::mutex> lock(m_listenerMutex);
+      m_listener = std::move(listener);
+    }
+
+    /// Queue a sample, called by the writing thread.
+    void deliver(const T& sample, int64_t millis)
+    {
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if(m_samples.size() >= m_depth) m_samples.pop_front();
+        m_samples.emplace_back(sample, millis);
+        if(m_notified) return;
+        m_notified = true;
+      }
+
+      std::weak_ptr<LoopbackReader<T>> weak = this->shared_from_this();
+      LoopbackBus::instance().post(
+          [weak]()
+          {
+            if(auto reader = weak.lock()) reader->notify();
+          });
+    }
+
+    /**
+       @brief Take all waiting samples.
+       @param[out] samples Samples in the order written, oldest first.
+    */
+    void take(std::deque<Entry>& samples)
+    {
+      samples.clear();
+      std::lock_guard<std::mutex> lock(m_mutex);
+      samples.swap(m_samples);
+    }
+
+  private:
+    /// Call the listener, on the delivery thread.
+    void notify()
+    {
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_notified = false;
+      }
+      std::lock_guard<std::mutex> lock(m_listenerMutex);
+      if(m_listener) m_listener();
+    }
+
+    std::mutex m_mutex; ///< Guards the samples and m_notified.
+    std::deque<Entry> m_samples; ///< Samples waiting to be taken.
+    size_t m_depth; ///< Maximal number of waiting samples.
+    bool m_notified; ///< A notification is posted and has not started yet.
+    std::mutex m_listenerMutex; ///< Held while the listener is called or replaced.
+    std::function<void()> m_listener; ///< Called when samples arrive.
+  };
+
+  /**
+     @brief A topic of the loopback transport, hands written samples to its readers.
+  */
+  template <typename T>
+  class LoopbackTopic
+  {
+  public:
+    /**
+       @brief Add a reader that receives the samples written from now on.
+       @param[in] depth Maximal number of samples waiting to be taken.
+    */
+    std::shared_ptr<LoopbackReader<T>> createReader(size_t depth)
+    {
+      auto reader = std::make_shared<LoopbackReader<T>>(depth);
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_readers.push_back(reader);
+      return reader;
+    }
+
+    /**
+       @brief Write a sample to all readers.
+       @param[in] sample Sample to write.
+       @param[in] millis Source timestamp, milliseconds since epoch.
+    */
+    void publish(const T& sample, int64_t millis)
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      for(auto it = m_readers.begin(); it != m_readers.end();)
+      {
+        if(auto reader = it->lock())
+        {
+          reader->deliver(sample, millis);
+          ++it;
+        }
+        else
+          it = m_readers.erase(it);
+      }
+    }
+
+    /// Write a sample to all readers, stamped with the current time.
+    void publish(const T& sample) { publish(sample, LoopbackBus::nowMillis()); }
+
+  private:
+    std::mutex m_mutex; ///< Guards m_readers.
+    std::vector<std::weak_ptr<LoopbackReader<T>>> m_readers; ///< Readers, removed when gone.
+  };
+
+  template <typename T>
+  std::shared_ptr<LoopbackTopic<T>> LoopbackBus::topic(uint32_t domain, const std::string& name)
+  {
+    std::lock_guard<std::mutex> lock(m_topicMutex);
+    const auto key = std::make_pair(domain, name);
+    auto it = m_topics.find(key);
+    if(it == m_topics.end())
+    {
+      std::shared_ptr<void> topic = std::make_shared<LoopbackTopic<T>>();
+      it = m_topics.emplace(key, std::make_pair(std::type_index(typeid(T)), topic)).first;
+    }
+    else if(it->second.first != std::type_index(typeid(T)))
+    {
+      throw std::runtime_error("Loopback topic " + name + " is already used with another type");
+    }
+    return std::static_pointer_cast<LoopbackTopic<T>>(it->second.second);
+  }
+}
@@ -13,7 +13,8 @@
 QtToDds::QtToDds(QObject *parent) :
   QObject(parent),
   dds(nullptr),
-  m_ready(false)
+  m_ready(false),
+  m_loopback(false)
 { }
 
 QtToDds::~QtToDds() = default;
@@ -23,9 +24,23 @@ bool QtToDds::initialized() const
   return m_ready;
 }
 
+bool QtToDds::loopback() const
+{
+  return m_loopback;
+}
+
 void QtToDds::init(int domain)
 {
   dds = std::make_unique<QtToDds::Dds>(static_cast<uint32_t>(domain));
   m_ready = true;
+  m_loopback = false;
+  emit initializedChanged(m_ready);
+}
+
+void QtToDds::initLoopback(int domain)
+{
+  dds = std::make_unique<QtToDds::Dds>(static_cast<uint32_t>(domain), QtToDds::Dds::Loopback());
+  m_ready = true;
+  m_loopback = true;
   emit initializedChanged(m_ready);
 }
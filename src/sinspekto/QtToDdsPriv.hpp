@@ -5,11 +5,15 @@
 #include <iostream>
 #include <string>
 #include <map>
+#include <memory>
+#include <type_traits>
 
 #include "sinspekto/FkinDds.hpp"
 #include "sinspekto/RatatoskDds.hpp"
 #include "sinspekto/QtToDds.hpp"
 #include "sinspekto/sinspekto.hpp"
+#include "sinspekto/EventLoopMonitor.hpp"
+#include "sinspekto/Loopback.hpp"
 
 /**
    @brief Dds container class
@@ -17,26 +21,47 @@
    Simple container class that holds instances of DDS-related classes. For details on DDS,
    please consult e.g. <a href="http://download.prismtech.com/docs/Vortex/apis/ospl/isocpp2/html/index.html">OpenSplice ISO C++ 2 DCPS documentation.</a>
 
-   This class is instanced by QtToDds.
+   This class is instanced by QtToDds. With the loopback transport its DDS entities are
+   null, and sinspekto::Reader and sinspekto::Writer use sinspekto::LoopbackBus instead.
 
 */
 struct QtToDds::Dds {
 
+  /// Tag of the constructor for the loopback transport.
+  struct Loopback {};
+
   /**
      @brief Constructor.
 
      @param id domain id for which to enlist. Often 0.
   */
   Dds(uint32_t id) :
+    domainId(id),
+    loopback(false),
     domainParticipant(id),
     subscriber(domainParticipant),
     publisher(domainParticipant)
   { }
 
+  /**
+     @brief Constructor for the loopback transport, without DDS entities.
+
+     @param id domain id, separates the topics of the loopback transport.
+  */
+  Dds(uint32_t id, Loopback) :
+    domainId(id),
+    loopback(true),
+    domainParticipant(dds::core::null),
+    subscriber(dds::core::null),
+    publisher(dds::core::null)
+  { }
+
   /**
      @brief Destructor.
   */
   ~Dds() = default;
+  uint32_t domainId; ///< Domain id.
+  bool loopback; ///< Use sinspekto::LoopbackBus instead of DDS.
   dds::domain::DomainParticipant domainParticipant; ///< DDS domain participant.
   dds::sub::Subscriber subscriber; ///< DDS subscriber.
   dds::pub::Publisher publisher; ///< DDS publisher.
@@ -87,13 +112,52 @@ namespace sinspekto {
     std::function<void()> m_qtEventSignal; ///< Function pointer to Qt signal to emit.
 };
 
+  /**
+     @brief Connect the listener signal of an adapter to the slot that takes the samples.
+
+     The signal is emitted on a DDS thread and queued to the adapter's thread. Both ends
+     are reported to EventLoopMonitor, which counts the queued signals and times the slot.
+     Signals still queued when the adapter is destroyed are discarded by Qt, and are
+     subtracted from the count then.
+
+     \rst
+     .. code-block:: cpp
+
+       sinspekto::connect_event(
+           this, &DdsDoubleSubscriber::eventHeard, &DdsDoubleSubscriber::updateValue, topic);
+
+     \endrst
+
+     @param[in] adapter Adapter that emits the signal and owns the slot.
+     @param[in] signal Signal given to the DdsReaderListener.
+     @param[in] slot Slot that takes the samples.
+     @param[in] topic Topic of the adapter, names it in EventLoopMonitor::offenders.
+  */
+  template <typename A, typename Signal, typename Slot>
+  void connect_event(A *adapter, Signal signal, Slot slot, const QString& topic)
+  {
+    auto pending = std::make_shared<std::atomic<int>>(0);
+    QObject::connect(adapter, signal, [pending]() { EventLoopMonitor::posted(*pending); });
+    QObject::connect(adapter, &QObject::destroyed,
+     [pending]() { EventLoopMonitor::discarded(*pending); });
+    const QString name = QString(adapter->metaObject()->className()) + " " + topic;
+    QObject::connect(adapter, signal, adapter,
+     [adapter, slot, name, pending]()
+     {
+       EventLoopMonitor::Dispatch dispatch(adapter, name, *pending);
+       (adapter->*slot)();
+     });
+  }
+
   /// Wrapper class that sets up a DDS data writer
   template <typename T>
   struct Writer
   {
     /// Constructor that sets up a writer on the provided domain.
     Writer<T>(QtToDds * const dds, const QString &topic, bool transient_local=false) :
-      writer(dds::pub::DataWriter<T>(dds::core::null))
+      writer(dds::pub::DataWriter<T>(dds::core::null)),
+      handle(dds::core::InstanceHandle::nil()),
+      loopback(nullptr)
     {
       if(dds->dds == nullptr)
       {
@@ -106,6 +170,12 @@ namespace sinspekto {
                + std::string(__FUNCTION__));
       }
 
+      if(dds->dds->loopback)
+      {
+        loopback = LoopbackBus::instance().topic<T>(dds->dds->domainId, topic.toStdString());
+        return;
+      }
+
       auto signalTopic = dds::topic::Topic<T>(
           dds->dds->domainParticipant,
           topic.toStdString());
@@ -120,17 +190,87 @@ namespace sinspekto {
           signalTopic,
           signalWriterQos);
     }
-    dds::pub::DataWriter<T> writer; ///< The DDS data writer.
+    /**
+       @brief Register the instance given by the key of the current sample.
+
+       Later writes pass the instance handle, so that the middleware does not look up the
+       key on every write. The key of the sample must not change afterwards. Does nothing
+       with the loopback transport.
+    */
+    void registerInstance()
+    {
+      if(!loopback)
+        handle = writer.register_instance(sample);
+    }
+
+    /// Write the current sample, with the registered instance handle if any.
+    void write()
+    {
+      write_sample(writer, loopback, sample, handle);
+    }
+
+    /**
+       @brief Write a range of samples in one call.
+       @param[in] begin Iterator to first sample.
+       @param[in] end Iterator past the last sample.
+    */
+    template <typename FwdIterator>
+    void write(const FwdIterator& begin, const FwdIterator& end)
+    {
+      if(!loopback)
+      {
+        writer.write(begin, end);
+        return;
+      }
+      const int64_t now = LoopbackBus::nowMillis();
+      for(auto it = begin; it != end; ++it)
+        loopback->publish(*it, now);
+    }
+
+    /// Write a sample to the loopback topic if any, else with an instance handle unless it is nil.
+    static void write_sample(
+        dds::pub::DataWriter<T>& writer,
+        const std::shared_ptr<LoopbackTopic<T>>& loopback,
+        const T& sample,
+        const dds::core::InstanceHandle& handle)
+    {
+      if(loopback)
+        loopback->publish(sample);
+      else if(handle.is_nil())
+        writer << sample;
+      else
+        writer.write(sample, handle);
+    }
+
+    dds::pub::DataWriter<T> writer; ///< The DDS data writer, null with the loopback transport.
     T sample; ///< A sample of the DDS type the Data writer manages.
+    dds::core::InstanceHandle handle; ///< Registered instance of the sample's key, or nil.
+    std::shared_ptr<LoopbackTopic<T>> loopback; ///< Topic of the loopback transport, or null.
   };
 
+  /**
+     @brief Append an element and its timestamp to the sequences of a Batch* sample.
+     @param[in,out] batch Batch sample, e.g. fkin::BatchIdVec1d.
+     @param[in] element Element of the batch sequence.
+     @param[in] unix_millis Timestamp of the element, milliseconds since epoch.
+  */
+  template <typename Batch, typename Element>
+  void append_to_batch(Batch& batch, const Element& element, int64_t unix_millis)
+  {
+    typename std::decay<decltype(batch.timestamps())>::type::value_type stamp;
+    stamp.unixMillis() = unix_millis;
+    batch.batch().push_back(element);
+    batch.timestamps().push_back(stamp);
+  }
+
   /// Wrapper class that sets up DDS data reader
   template <typename T>
   struct Reader
   {
     /// Constructor that sets up a reader on the provided domain.
     Reader<T>(QtToDds * const dds, const QString &topic, bool transient_local=false) :
-      reader(dds::sub::DataReader<T>(dds::core::null))
+      reader(dds::sub::DataReader<T>(dds::core::null)),
+      loopback(nullptr)
     {
       if(dds->dds == nullptr)
       {
@@ -143,6 +283,13 @@ namespace sinspekto {
          + std::string(__FUNCTION__));
       }
 
+      if(dds->dds->loopback)
+      {
+        loopback = LoopbackBus::instance().topic<T>(dds->dds->domainId, topic.toStdString())
+         ->createReader(loopback_depth);
+        return;
+      }
+
       auto signalTopic = dds::topic::Topic<T>(
           dds->dds->domainParticipant,
           topic.toStdString());
@@ -158,16 +305,89 @@ namespace sinspekto {
           signalTopic,
           signalReaderQos);
     }
-    dds::sub::DataReader<T> reader; ///< DDS data reader.
+
+    /**
+       @brief Call the listener when data is available, on a thread of the transport.
+
+       To be called after the listener is set.
+    */
+    void listen()
+    {
+      if(loopback)
+        loopback->setListener([this]() { listener.on_data_available(reader); });
+      else
+        reader.listener(&listener, dds::core::status::StatusMask::data_available());
+    }
+
+    /**
+       @brief Take the new samples of an instance, and keep the last one in sample and timepoint.
+
+       Samples of other instances stay in the DDS reader, but are dropped by the loopback
+       transport, since each adapter reads a single instance.
+
+       @param[in] field Key field in the DDS content filter, e.g. "id".
+       @param[in] key Value of the key field, all new samples are taken if empty.
+       @param[in] keyOf Function giving the key of a sample, filters the loopback samples.
+       @return True if a sample was taken.
+    */
+    template <typename KeyOf>
+    bool takeLast(const std::string& field, const std::string& key, KeyOf keyOf)
+    {
+      if(loopback)
+      {
+        std::deque<typename LoopbackReader<T>::Entry> samples;
+        loopback->take(samples);
+        for(auto it = samples.rbegin(); it != samples.rend(); ++it)
+        {
+          if(!key.empty() && keyOf(it->first) != key) continue;
+          sample = it->first;
+          timepoint = dds::core::Time::from_millisecs(it->second);
+          return true;
+        }
+        return false;
+      }
+
+      auto selector = reader.select().state(dds::sub::status::DataState::new_data());
+      if(!key.empty())
+        selector.content(dds::sub::Query(reader, field + " = %0", {key}));
+      dds::sub::LoanedSamples<T> samples = selector.take();
+      if(samples.length() == 0) return false;
+
+      auto last = (--samples.end()); // picks the last sample
+      sample = last->data();
+      timepoint = last->info().timestamp();
+      return true;
+    }
+
+    /// Take the new samples with the given id, see takeLast() above.
+    bool takeLast(const std::string& id)
+    {
+      return takeLast("id", id, [](const T& s) { return s.id(); });
+    }
+
+    /// Take all new samples, see takeLast() above.
+    bool takeLast()
+    {
+      return takeLast(std::string(), std::string(), [](const T&) { return std::string(); });
+    }
+
+    dds::sub::DataReader<T> reader; ///< DDS data reader, null with the loopback transport.
     T sample; ///<
     dds::core::Time timepoint; ///< time point with type used in DDS
     sinspekto::DdsReaderListener<T> listener; ///< Wrapper class to dispatch Qt events on data available.
+    std::shared_ptr<LoopbackReader<T>> loopback; ///< Reader of the loopback transport, or null.
 
     /// Destructor
     ~Reader<T>()
     {
-      reader.listener(nullptr, dds::core::status::StatusMask::none());
+      if(loopback)
+        loopback->setListener(nullptr);
+      else
+        reader.listener(nullptr, dds::core::status::StatusMask::none());
     }
 
+  private:
+    static constexpr size_t loopback_depth = 4096; ///< Samples kept by a loopback reader.
+
   };
 }
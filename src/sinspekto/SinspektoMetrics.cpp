@@ -0,0 +1,251 @@
+#include <algorithm>
+#include <iostream>
+#include <QDateTime>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+#include "sinspekto/SinspektoMetrics.hpp"
+#include "sinspekto/TimerWheel.hpp"
+
+namespace
+{
+  /// Quote a CSV field, doubling embedded quotes.
+  QString csvQuoted(QString field)
+  {
+    return "\"" + field.replace("\"", "\"\"") + "\"";
+  }
+}
+
+SinspektoMetrics::SinspektoMetrics(QObject *parent) :
+  QAbstractListModel(parent),
+  m_intervalMs(1000),
+  m_timer(0),
+  m_exportJson(false)
+{
+  // Construct the wheel first, so that it outlives this static instance
+  sinspekto::TimerWheel::instance();
+  m_elapsed.start();
+}
+
+SinspektoMetrics::~SinspektoMetrics()
+{
+  if(m_timer) sinspekto::TimerWheel::instance().cancel(m_timer);
+}
+
+SinspektoMetrics& SinspektoMetrics::instance()
+{
+  static SinspektoMetrics metrics;
+  return metrics;
+}
+
+void SinspektoMetrics::attach(
+    QObject *adapter,
+    const QString& name,
+    const Counters *counters,
+    std::function<uint64_t()> bytesBuffered)
+{
+  if(!adapter || !counters) return;
+
+  auto it = std::find_if(m_rows.begin(), m_rows.end(),
+   [adapter](const Row& row) { return row.adapter == adapter; });
+  if(it != m_rows.end())
+  {
+    it->name = name;
+    const QModelIndex changed = index(static_cast<int>(it - m_rows.begin()));
+    emit dataChanged(changed, changed, {NameRole});
+    return;
+  }
+
+  Row row;
+  row.adapter = adapter;
+  row.name = name;
+  row.type = adapter->metaObject()->className();
+  row.counters = counters;
+  row.bytesBuffered = std::move(bytesBuffered);
+  row.samples = counters->samples.load(std::memory_order_relaxed);
+  row.drains = counters->drains.load(std::memory_order_relaxed);
+  row.points = counters->points.load(std::memory_order_relaxed);
+
+  beginInsertRows(QModelIndex(), count(), count());
+  m_rows.push_back(std::move(row));
+  endInsertRows();
+  emit countChanged();
+
+  if(!m_timer) schedule();
+}
+
+void SinspektoMetrics::detach(QObject *adapter)
+{
+  auto it = std::find_if(m_rows.begin(), m_rows.end(),
+   [adapter](const Row& row) { return row.adapter == adapter; });
+  if(it == m_rows.end()) return;
+
+  const int row = static_cast<int>(it - m_rows.begin());
+  beginRemoveRows(QModelIndex(), row, row);
+  m_rows.erase(it);
+  endRemoveRows();
+  emit countChanged();
+}
+
+int SinspektoMetrics::rowCount(const QModelIndex& parent) const
+{
+  if(parent.isValid()) return 0;
+  return count();
+}
+
+QVariant SinspektoMetrics::data(const QModelIndex& index, int role) const
+{
+  if(!index.isValid() || index.row() < 0 || index.row() >= count()) return QVariant();
+
+  const Row& row = m_rows[static_cast<size_t>(index.row())];
+  switch(role)
+  {
+  case Qt::DisplayRole:
+  case NameRole:
+    return row.name;
+  case TypeRole:
+    return row.type;
+  case SamplesPerSecondRole:
+    return row.samplesPerSecond;
+  case DrainsPerSecondRole:
+    return row.drainsPerSecond;
+  case CoalescedEventsRole:
+    return static_cast<qulonglong>(row.counters->coalesced.load(std::memory_order_relaxed));
+  case SeriesRebuildsRole:
+    return static_cast<qulonglong>(row.counters->rebuilds.load(std::memory_order_relaxed));
+  case PointsPerSecondRole:
+    return row.pointsPerSecond;
+  case PointsUploadedRole:
+    return static_cast<qulonglong>(row.points);
+  case BytesBufferedRole:
+    return static_cast<qulonglong>(row.bytes);
+  default:
+    return QVariant();
+  }
+}
+
+QHash<int, QByteArray> SinspektoMetrics::roleNames() const
+{
+  return {
+    { NameRole, "name" },
+    { TypeRole, "type" },
+    { SamplesPerSecondRole, "samplesPerSecond" },
+    { DrainsPerSecondRole, "drainsPerSecond" },
+    { CoalescedEventsRole, "coalescedEvents" },
+    { SeriesRebuildsRole, "seriesRebuilds" },
+    { PointsPerSecondRole, "pointsPerSecond" },
+    { PointsUploadedRole, "pointsUploaded" },
+    { BytesBufferedRole, "bytesBuffered" }
+  };
+}
+
+void SinspektoMetrics::setIntervalMs(int interval)
+{
+  interval = std::max(100, interval);
+  if(interval == m_intervalMs) return;
+
+  m_intervalMs = interval;
+  if(m_timer)
+  {
+    sinspekto::TimerWheel::instance().cancel(m_timer);
+    schedule();
+  }
+  emit intervalMsChanged(m_intervalMs);
+}
+
+void SinspektoMetrics::setExportFile(const QString& fileName)
+{
+  if(fileName == m_exportFile.fileName()) return;
+
+  m_exportFile.close();
+  m_exportFile.setFileName(fileName);
+  m_exportJson = fileName.endsWith(".json", Qt::CaseInsensitive);
+
+  if(!fileName.isEmpty())
+  {
+    if(!m_exportFile.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+      std::cerr << "SinspektoMetrics: cannot write " << fileName.toStdString() << std::endl;
+    else if(!m_exportJson)
+      m_exportFile.write(
+          "time,name,type,samples_per_second,drains_per_second,coalesced_events,"
+          "series_rebuilds,points_per_second,points_uploaded,bytes_buffered\n");
+  }
+  emit exportFileChanged();
+}
+
+void SinspektoMetrics::schedule()
+{
+  m_timer = sinspekto::TimerWheel::instance().schedulePeriodic(
+      m_intervalMs, [this]() { refresh(); });
+}
+
+void SinspektoMetrics::refresh()
+{
+  const double seconds = static_cast<double>(std::max<qint64>(1, m_elapsed.restart()))/1000.0;
+
+  for(Row& row : m_rows)
+  {
+    const uint64_t samples = row.counters->samples.load(std::memory_order_relaxed);
+    const uint64_t drains = row.counters->drains.load(std::memory_order_relaxed);
+    const uint64_t points = row.counters->points.load(std::memory_order_relaxed);
+
+    row.samplesPerSecond = static_cast<double>(samples - row.samples)/seconds;
+    row.drainsPerSecond = static_cast<double>(drains - row.drains)/seconds;
+    row.pointsPerSecond = static_cast<double>(points - row.points)/seconds;
+    row.samples = samples;
+    row.drains = drains;
+    row.points = points;
+    row.bytes = row.bytesBuffered ? row.bytesBuffered() : 0;
+  }
+
+  if(!m_rows.empty())
+    emit dataChanged(index(0), index(count() - 1));
+
+  if(m_exportFile.isOpen())
+    writeRecords(QDateTime::currentMSecsSinceEpoch());
+}
+
+void SinspektoMetrics::writeRecords(qint64 timestamp)
+{
+  if(m_exportJson)
+  {
+    QJsonArray adapters;
+    for(const Row& row : m_rows)
+    {
+      adapters.append(QJsonObject{
+        { "name", row.name },
+        { "type", row.type },
+        { "samplesPerSecond", row.samplesPerSecond },
+        { "drainsPerSecond", row.drainsPerSecond },
+        { "coalescedEvents", static_cast<qint64>(row.counters->coalesced.load(std::memory_order_relaxed)) },
+        { "seriesRebuilds", static_cast<qint64>(row.counters->rebuilds.load(std::memory_order_relaxed)) },
+        { "pointsPerSecond", row.pointsPerSecond },
+        { "pointsUploaded", static_cast<qint64>(row.points) },
+        { "bytesBuffered", static_cast<qint64>(row.bytes) }
+      });
+    }
+    const QJsonObject record{ { "time", timestamp }, { "adapters", adapters } };
+    m_exportFile.write(QJsonDocument(record).toJson(QJsonDocument::Compact));
+    m_exportFile.write("\n");
+  }
+  else
+  {
+    QTextStream out(&m_exportFile);
+    for(const Row& row : m_rows)
+    {
+      out
+        << timestamp << ','
+        << csvQuoted(row.name) << ','
+        << row.type << ','
+        << row.samplesPerSecond << ','
+        << row.drainsPerSecond << ','
+        << static_cast<qulonglong>(row.counters->coalesced.load(std::memory_order_relaxed)) << ','
+        << static_cast<qulonglong>(row.counters->rebuilds.load(std::memory_order_relaxed)) << ','
+        << row.pointsPerSecond << ','
+        << static_cast<qulonglong>(row.points) << ','
+        << static_cast<qulonglong>(row.bytes) << '\n';
+    }
+  }
+  m_exportFile.flush();
+}
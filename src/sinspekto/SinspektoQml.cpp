@@ -2,6 +2,7 @@
 
 #include "sinspekto/QtToDds.hpp"
 #include "sinspekto/AxisEqualizer.hpp"
+#include "sinspekto/TimeAxisController.hpp"
 #include "sinspekto/DdsDouble.hpp"
 #include "sinspekto/DdsBit.hpp"
 #include "sinspekto/DdsIdVec1d.hpp"
@@ -10,15 +11,20 @@
 #include "sinspekto/DdsIdVec4d.hpp"
 #include "sinspekto/DdsKinematics2D.hpp"
 #include "sinspekto/DdsKinematics6D.hpp"
+#include "sinspekto/DdsDoubleBuffer.hpp"
 #include "sinspekto/DdsIdVec1dBuffer.hpp"
 #include "sinspekto/DdsIdVec2dBuffer.hpp"
 #include "sinspekto/DdsIdVec3dBuffer.hpp"
 #include "sinspekto/DdsIdVec4dBuffer.hpp"
 #include "sinspekto/DdsKinematics2DBuffer.hpp"
 #include "sinspekto/DdsKinematics6DBuffer.hpp"
+#include "sinspekto/DdsLineSeries.hpp"
 #include "sinspekto/DdsCommand.hpp"
 #include "sinspekto/DdsStateAutomaton.hpp"
 #include "sinspekto/DdsDataSource.hpp"
+#include "sinspekto/DdsLatencyTrace.hpp"
+#include "sinspekto/SinspektoMetrics.hpp"
+#include "sinspekto/EventLoopMonitor.hpp"
 #include "sinspekto/DdsNlpConfig.hpp"
 #include "sinspekto/DdsOptiStats.hpp"
 #include "sinspekto/DdsWeatherData.hpp"
@@ -41,12 +47,14 @@ namespace sinspekto
   {
     qmlRegisterType<QtToDds>("fkin.Dds", 1, 0, "QtToDds");
     qmlRegisterType<AxisEqualizer>("fkin.Dds", 1, 0, "AxisEqualizer");
+    qmlRegisterType<TimeAxisController>("fkin.Dds", 1, 0, "TimeAxisController");
     qmlRegisterType<DdsBitSubscriber>("fkin.Dds", 1, 0, "DdsBitSubscriber");
     qmlRegisterType<DdsBitPublisher>("fkin.Dds", 1, 0, "DdsBitPublisher");
     qmlRegisterType<DdsDoubleSubscriber>("fkin.Dds", 1, 0, "DdsDoubleSubscriber");
     qmlRegisterType<DdsDoublePublisher>("fkin.Dds", 1, 0, "DdsDoublePublisher");
     qmlRegisterType<DdsIdVec1dSubscriber>("fkin.Dds", 1, 0, "DdsIdVec1dSubscriber");
     qmlRegisterType<DdsIdVec1dPublisher>("fkin.Dds", 1, 0, "DdsIdVec1dPublisher");
+    qmlRegisterType<DdsBatchIdVec1dPublisher>("fkin.Dds", 1, 0, "DdsBatchIdVec1dPublisher");
     qmlRegisterType<DdsIdVec2dSubscriber>("fkin.Dds", 1, 0, "DdsIdVec2dSubscriber");
     qmlRegisterType<DdsIdVec2dPublisher>("fkin.Dds", 1, 0, "DdsIdVec2dPublisher");
     qmlRegisterType<DdsIdVec3dSubscriber>("fkin.Dds", 1, 0, "DdsIdVec3dSubscriber");
@@ -55,20 +63,45 @@ namespace sinspekto
     qmlRegisterType<DdsIdVec4dPublisher>("fkin.Dds", 1, 0, "DdsIdVec4dPublisher");
     qmlRegisterType<DdsKinematics2DSubscriber>("fkin.Dds", 1, 0, "DdsKinematics2DSubscriber");
     qmlRegisterType<DdsKinematics2DPublisher>("fkin.Dds", 1, 0, "DdsKinematics2DPublisher");
+    qmlRegisterType<DdsBatchKinematics2DPublisher>("fkin.Dds", 1, 0, "DdsBatchKinematics2DPublisher");
     qmlRegisterType<DdsKinematics6DSubscriber>("fkin.Dds", 1, 0, "DdsKinematics6DSubscriber");
     qmlRegisterType<DdsKinematics6DPublisher>("fkin.Dds", 1, 0, "DdsKinematics6DPublisher");
+    qmlRegisterType<DdsBatchKinematics6DPublisher>("fkin.Dds", 1, 0, "DdsBatchKinematics6DPublisher");
     qmlRegisterType<DdsIdVec1dBuffer>("fkin.Dds", 1, 0, "DdsIdVec1dBuffer");
     qmlRegisterType<DdsIdVec2dBuffer>("fkin.Dds", 1, 0, "DdsIdVec2dBuffer");
     qmlRegisterType<DdsIdVec3dBuffer>("fkin.Dds", 1, 0, "DdsIdVec3dBuffer");
     qmlRegisterType<DdsIdVec4dBuffer>("fkin.Dds", 1, 0, "DdsIdVec4dBuffer");
     qmlRegisterType<DdsKinematics2DBuffer>("fkin.Dds", 1, 0, "DdsKinematics2DBuffer");
     qmlRegisterType<DdsKinematics6DBuffer>("fkin.Dds", 1, 0, "DdsKinematics6DBuffer");
+    qmlRegisterUncreatableType<DdsDoubleBuffer>("fkin.Dds", 1, 0, "DdsDoubleBuffer",
+     "Error: access with DdsBuffer::dimension()");
+    qmlRegisterType<DdsLineSeries>("fkin.Dds", 1, 0, "DdsLineSeries");
     qmlRegisterType<DdsCommandSubscriber>("fkin.Dds", 1, 0, "DdsCommandSubscriber");
     qmlRegisterType<DdsCommandPublisher>("fkin.Dds", 1, 0, "DdsCommandPublisher");
     qmlRegisterType<DdsStateAutomaton>("fkin.Dds", 1, 0, "DdsStateNotification");
+    qmlRegisterType<DdsProcessStateModel>("fkin.Dds", 1, 0, "DdsProcessStateModel");
     qmlRegisterType<DdsDataSource>("fkin.Dds", 1, 0, "DdsDataSource");
     qmlRegisterType<DdsNlpConfigSubscriber>("fkin.Dds", 1, 0, "DdsNlpConfigSubscriber");
     qmlRegisterType<DdsOptiStatsSubscriber>("fkin.Dds", 1, 0, "DdsOptiStatsSubscriber");
+    qmlRegisterSingletonType<DdsLatencyTrace>("fkin.Dds", 1, 0, "DdsLatencyTrace",
+     [](QQmlEngine *, QJSEngine *) -> QObject *
+     {
+       // Shared with the buffers, must not be garbage collected by the QML engine
+       QQmlEngine::setObjectOwnership(&DdsLatencyTrace::instance(), QQmlEngine::CppOwnership);
+       return &DdsLatencyTrace::instance();
+     });
+    qmlRegisterSingletonType<SinspektoMetrics>("fkin.Dds", 1, 0, "SinspektoMetrics",
+     [](QQmlEngine *, QJSEngine *) -> QObject *
+     {
+       QQmlEngine::setObjectOwnership(&SinspektoMetrics::instance(), QQmlEngine::CppOwnership);
+       return &SinspektoMetrics::instance();
+     });
+    qmlRegisterSingletonType<EventLoopMonitor>("fkin.Dds", 1, 0, "EventLoopMonitor",
+     [](QQmlEngine *, QJSEngine *) -> QObject *
+     {
+       QQmlEngine::setObjectOwnership(&EventLoopMonitor::instance(), QQmlEngine::CppOwnership);
+       return &EventLoopMonitor::instance();
+     });
 
     // ratatosk
     qmlRegisterType<RatatoskDoubleValSubscriber>("ratatosk", 1, 0, "RatatoskDoubleValSubscriber");
@@ -103,6 +136,7 @@ namespace sinspekto
     qRegisterMetaType<qml_enums::ProcessStateKind>();
     qRegisterMetaType<qml_enums::CommandType>();
     qRegisterMetaType<qml_enums::DimId>();
+    qRegisterMetaType<qml_enums::JoinMode>();
 
     // For some reason any enum declared in fkin namespace fails to properly register in qml
     // Forward declared DDS enums are unknown in qml
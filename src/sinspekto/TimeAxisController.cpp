@@ -0,0 +1,137 @@
+#include <algorithm>
+#include <iostream>
+#include <QDateTimeAxis>
+#include "sinspekto/TimeAxisController.hpp"
+
+TimeAxisController::TimeAxisController(QObject *parent) :
+  QObject(parent),
+  m_source(nullptr),
+  m_horizonMS(29000),
+  m_futureMS(1000),
+  m_latestMS(0),
+  m_hasLatest(false),
+  m_minMS(0),
+  m_maxMS(0)
+{
+  m_frameTimer.setSingleShot(true);
+  m_frameTimer.setInterval(16);
+
+  QObject::connect(
+      &m_frameTimer, &QTimer::timeout,
+      this, &TimeAxisController::flush);
+}
+
+TimeAxisController::~TimeAxisController() = default;
+
+DdsBuffer* TimeAxisController::source() const { return m_source; }
+int TimeAxisController::horizonMS() const { return m_horizonMS; }
+int TimeAxisController::futureMS() const { return m_futureMS; }
+QDateTime TimeAxisController::min() const { return QDateTime::fromMSecsSinceEpoch(m_minMS); }
+QDateTime TimeAxisController::max() const { return QDateTime::fromMSecsSinceEpoch(m_maxMS); }
+
+void TimeAxisController::attachAxis(QAbstractAxis *axis)
+{
+  if(!qobject_cast<QDateTimeAxis*>(axis))
+  {
+    std::cerr << "TimeAxisController: only DateTimeAxis can be attached" << std::endl;
+    return;
+  }
+  if(std::find(m_axes.begin(), m_axes.end(), axis) != m_axes.end()) return;
+
+  m_axes.push_back(axis);
+  QObject::connect(
+      axis, &QObject::destroyed,
+      this, [this](QObject *obj)
+            {
+              m_axes.erase(std::remove(m_axes.begin(), m_axes.end(), obj), m_axes.end());
+            });
+
+  if(m_hasLatest)
+    static_cast<QDateTimeAxis*>(axis)->setRange(min(), max());
+}
+
+void TimeAxisController::detachAxis(QAbstractAxis *axis)
+{
+  auto it = std::find(m_axes.begin(), m_axes.end(), axis);
+  if(it == m_axes.end()) return;
+
+  QObject::disconnect(axis, &QObject::destroyed, this, nullptr);
+  m_axes.erase(it);
+}
+
+void TimeAxisController::setSource(DdsBuffer *source)
+{
+  if(source == m_source) return;
+
+  if(m_source)
+    QObject::disconnect(m_source, nullptr, this, nullptr);
+
+  m_source = source;
+
+  if(m_source)
+  {
+    // newData() is declared by each buffer type, not by DdsBuffer
+    if(!QObject::connect(m_source, SIGNAL(newData()), this, SLOT(sourceUpdated())))
+      std::cerr << "TimeAxisController: source has no newData() signal" << std::endl;
+    QObject::connect(
+        m_source, &QObject::destroyed,
+        this, [this](){ m_source = nullptr; emit sourceChanged(); });
+    sourceUpdated();
+  }
+
+  emit sourceChanged();
+}
+
+void TimeAxisController::setHorizonMS(int horizon)
+{
+  if(horizon == m_horizonMS) return;
+  m_horizonMS = horizon;
+  schedule();
+  emit horizonMSChanged();
+}
+
+void TimeAxisController::setFutureMS(int future)
+{
+  if(future == m_futureMS) return;
+  m_futureMS = future;
+  schedule();
+  emit futureMSChanged();
+}
+
+void TimeAxisController::setLatest(const QDateTime& latest)
+{
+  m_latestMS = latest.toMSecsSinceEpoch();
+  m_hasLatest = true;
+  schedule();
+}
+
+void TimeAxisController::sourceUpdated()
+{
+  const DdsTimepointBuffer *time = m_source->timepoints();
+  if(!time || time->Buffer().empty()) return;
+
+  m_latestMS = time->Buffer().back();
+  m_hasLatest = true;
+  schedule();
+}
+
+void TimeAxisController::schedule()
+{
+  if(m_hasLatest && !m_frameTimer.isActive()) m_frameTimer.start();
+}
+
+void TimeAxisController::flush()
+{
+  const int64_t maxMS = m_latestMS + m_futureMS;
+  const int64_t minMS = maxMS - m_horizonMS;
+  if(minMS == m_minMS && maxMS == m_maxMS) return;
+
+  m_minMS = minMS;
+  m_maxMS = maxMS;
+
+  const QDateTime tmin = min(), tmax = max();
+  for(auto axis : m_axes)
+    static_cast<QDateTimeAxis*>(axis)->setRange(tmin, tmax);
+
+  emit rangeChanged();
+}
@@ -0,0 +1,333 @@
+#include <algorithm>
+#include <chrono>
+#include <QCoreApplication>
+#include "sinspekto/TimerWheel.hpp"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace
+{
+  /// Milliseconds of a monotonic clock.
+  int64_t steadyMs()
+  {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  /// Index of the lowest set bit, x must not be 0.
+  unsigned lowestBit(uint64_t x)
+  {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_ctzll(x));
+#elif defined(_MSC_VER)
+    unsigned long i;
+    _BitScanForward64(&i, x);
+    return static_cast<unsigned>(i);
+#else
+    unsigned i = 0;
+    while(!(x & 1)) { x >>= 1; ++i; }
+    return i;
+#endif
+  }
+
+  /// Rotate right, such that bit n becomes bit 0.
+  uint64_t rotate(uint64_t x, unsigned n)
+  {
+    return n ? (x >> n) | (x << (64 - n)) : x;
+  }
+}
+
+namespace sinspekto
+{
+  TimerWheel::TimerWheel(int tickMs) :
+    m_tickMs(std::max(1, tickMs)),
+    m_originMs(steadyMs()),
+    m_now(0),
+    m_size(0),
+    m_free(npos),
+    m_armedTick(0)
+  {
+    std::fill(std::begin(m_heads), std::end(m_heads), npos);
+    std::fill(std::begin(m_occupied), std::end(m_occupied), 0);
+  }
+
+  TimerWheel::~TimerWheel()
+  {
+    delete m_timer.data();
+  }
+
+  TimerWheel& TimerWheel::instance()
+  {
+    static TimerWheel wheel(1);
+    return wheel;
+  }
+
+  TimerWheel::TimerId TimerWheel::schedule(int64_t delayMs, std::function<void()> callback)
+  {
+    const uint64_t ticks = static_cast<uint64_t>(std::max<int64_t>(1, (delayMs + m_tickMs - 1)/m_tickMs));
+    return add(ticks, 0, std::move(callback));
+  }
+
+  TimerWheel::TimerId TimerWheel::schedulePeriodic(int64_t periodMs, std::function<void()> callback)
+  {
+    const uint64_t ticks = static_cast<uint64_t>(std::max<int64_t>(1, (periodMs + m_tickMs - 1)/m_tickMs));
+    return add(ticks, ticks, std::move(callback));
+  }
+
+  TimerWheel::TimerId TimerWheel::add(
+      uint64_t delayTicks,
+      uint64_t period,
+      std::function<void()>&& callback)
+  {
+    // Nothing to keep in order when empty, catch up with the clock at no cost
+    if(m_size == 0) m_now = std::max(m_now, clockTick());
+
+    uint32_t idx = m_free;
+    if(idx != npos)
+      m_free = m_nodes[idx].next;
+    else
+    {
+      idx = static_cast<uint32_t>(m_nodes.size());
+      m_nodes.emplace_back();
+    }
+
+    Node& node = m_nodes[idx];
+    node.expiry = std::max(m_now, clockTick()) + delayTicks;
+    node.period = period;
+    node.callback = std::move(callback);
+    node.cancelled = false;
+    place(idx);
+    ++m_size;
+
+    arm(node.expiry);
+    return (static_cast<TimerId>(node.generation) << 32) | (static_cast<TimerId>(idx) + 1);
+  }
+
+  TimerWheel::Node* TimerWheel::find(TimerId id)
+  {
+    const uint64_t idx = (id & 0xffffffffu) - 1;
+    if(idx >= m_nodes.size()) return nullptr;
+    Node& node = m_nodes[idx];
+    if(node.generation != static_cast<uint32_t>(id >> 32) || node.cancelled) return nullptr;
+    if(node.list == npos && !node.firing) return nullptr;
+    return &node;
+  }
+
+  const TimerWheel::Node* TimerWheel::find(TimerId id) const
+  {
+    return const_cast<TimerWheel*>(this)->find(id);
+  }
+
+  bool TimerWheel::pending(TimerId id) const
+  {
+    const Node *node = find(id);
+    return node && node->list != npos;
+  }
+
+  bool TimerWheel::cancel(TimerId id)
+  {
+    Node *node = find(id);
+    if(!node || node->list == npos) return false;
+
+    const uint32_t idx = static_cast<uint32_t>((id & 0xffffffffu) - 1);
+    unlink(idx);
+    --m_size;
+
+    // The running callback is still in the node, release it when it returns
+    if(node->firing)
+      node->cancelled = true;
+    else
+      release(idx);
+    return true;
+  }
+
+  void TimerWheel::place(uint32_t idx)
+  {
+    const uint64_t expiry = m_nodes[idx].expiry;
+    const uint64_t delta = expiry > m_now ? expiry - m_now : 0;
+
+    for(unsigned level = 0; level < levels - 1; ++level)
+    {
+      if(delta < (uint64_t(1) << (level_bits*(level + 1))))
+      {
+        link(idx, level*slots + ((expiry >> (level_bits*level)) & (slots - 1)));
+        return;
+      }
+    }
+
+    // Beyond reach, wait in the furthest slot and be placed again from there
+    const unsigned top = levels - 1;
+    const uint64_t reach = (uint64_t(1) << (level_bits*levels)) - 1;
+    const uint64_t tick = m_now + std::min(delta, reach);
+    link(idx, top*slots + ((tick >> (level_bits*top)) & (slots - 1)));
+  }
+
+  void TimerWheel::link(uint32_t idx, uint32_t list)
+  {
+    Node& node = m_nodes[idx];
+    node.prev = npos;
+    node.next = m_heads[list];
+    if(node.next != npos) m_nodes[node.next].prev = idx;
+    m_heads[list] = idx;
+    node.list = list;
+
+    if(list < firing_list)
+      m_occupied[list/slots] |= uint64_t(1) << (list % slots);
+  }
+
+  void TimerWheel::unlink(uint32_t idx)
+  {
+    Node& node = m_nodes[idx];
+    const uint32_t list = node.list;
+    if(node.prev != npos)
+      m_nodes[node.prev].next = node.next;
+    else
+      m_heads[list] = node.next;
+    if(node.next != npos) m_nodes[node.next].prev = node.prev;
+
+    if(list < firing_list && m_heads[list] == npos)
+      m_occupied[list/slots] &= ~(uint64_t(1) << (list % slots));
+
+    node.prev = node.next = npos;
+    node.list = npos;
+  }
+
+  void TimerWheel::release(uint32_t idx)
+  {
+    Node& node = m_nodes[idx];
+    node.callback = nullptr;
+    node.cancelled = false;
+    ++node.generation;
+    node.next = m_free;
+    m_free = idx;
+  }
+
+  void TimerWheel::cascade(uint32_t list)
+  {
+    uint32_t idx = m_heads[list];
+    m_heads[list] = npos;
+    m_occupied[list/slots] &= ~(uint64_t(1) << (list % slots));
+
+    while(idx != npos)
+    {
+      const uint32_t next = m_nodes[idx].next;
+      m_nodes[idx].list = npos;
+      place(idx);
+      idx = next;
+    }
+  }
+
+  void TimerWheel::step()
+  {
+    ++m_now;
+
+    for(unsigned level = 1; level < levels; ++level)
+    {
+      const uint64_t below = (uint64_t(1) << (level_bits*level)) - 1;
+      if(m_now & below) break;
+      cascade(level*slots + ((m_now >> (level_bits*level)) & (slots - 1)));
+    }
+
+    // Move the expired timers to the firing list first, as callbacks may cancel any of them
+    const uint32_t slot = static_cast<uint32_t>(m_now & (slots - 1));
+    while(m_heads[slot] != npos)
+    {
+      const uint32_t idx = m_heads[slot];
+      unlink(idx);
+      link(idx, firing_list);
+    }
+
+    while(m_heads[firing_list] != npos)
+    {
+      const uint32_t idx = m_heads[firing_list];
+      unlink(idx);
+      Node& node = m_nodes[idx];
+
+      if(node.period == 0)
+      {
+        --m_size;
+        auto callback = std::move(node.callback);
+        release(idx);
+        callback();
+        continue;
+      }
+
+      node.expiry += node.period;
+      if(node.expiry <= m_now)
+        node.expiry = m_now + node.period - (m_now - node.expiry) % node.period;
+      place(idx);
+
+      node.firing = true;
+      node.callback();
+      node.firing = false;
+      if(node.cancelled) release(idx);
+    }
+  }
+
+  uint64_t TimerWheel::nextEvent() const
+  {
+    uint64_t next = 0;
+
+    for(unsigned level = 0; level < levels; ++level)
+    {
+      if(!m_occupied[level]) continue;
+
+      // Slots are visited in circular order, starting after the current one
+      const uint64_t current = m_now >> (level_bits*level);
+      const unsigned from = static_cast<unsigned>((current + 1) & (slots - 1));
+      const uint64_t ahead = lowestBit(rotate(m_occupied[level], from)) + 1;
+      const uint64_t tick = (current + ahead) << (level_bits*level);
+      if(next == 0 || tick < next) next = tick;
+    }
+    return next;
+  }
+
+  void TimerWheel::advance(int64_t nowMs)
+  {
+    const uint64_t target = nowMs > m_originMs ? static_cast<uint64_t>((nowMs - m_originMs)/m_tickMs) : 0;
+
+    while(m_now < target)
+    {
+      // Skip ticks without anything to cascade or fire
+      const uint64_t next = nextEvent();
+      if(next == 0 || next > target)
+      {
+        m_now = target;
+        break;
+      }
+      m_now = next - 1;
+      step();
+    }
+  }
+
+  uint64_t TimerWheel::clockTick() const
+  {
+    const int64_t ms = steadyMs() - m_originMs;
+    return ms > 0 ? static_cast<uint64_t>(ms/m_tickMs) : 0;
+  }
+
+  void TimerWheel::arm(uint64_t tick)
+  {
+    if(!m_timer)
+    {
+      m_timer = new QTimer(QCoreApplication::instance());
+      m_timer->setSingleShot(true);
+      m_timer->setTimerType(Qt::PreciseTimer);
+      QObject::connect(m_timer.data(), &QTimer::timeout, [this](){ onTimeout(); });
+    }
+    if(m_timer->isActive() && m_armedTick <= tick) return;
+
+    m_armedTick = tick;
+    const int64_t wait = m_originMs + static_cast<int64_t>(tick)*m_tickMs - steadyMs();
+    m_timer->start(static_cast<int>(std::min<int64_t>(std::max<int64_t>(0, wait), 24*3600*1000)));
+  }
+
+  void TimerWheel::onTimeout()
+  {
+    advance(steadyMs());
+    const uint64_t next = nextEvent();
+    if(next != 0) arm(next);
+  }
+}
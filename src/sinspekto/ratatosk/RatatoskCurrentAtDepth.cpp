@@ -26,9 +26,10 @@ void RatatoskCurrentAtDepthSubscriber::init(
   {
     m_reader->listener = sinspekto::DdsReaderListener<ratatosk::types::CurrentAtDepth>(
         std::bind(&RatatoskCurrentAtDepthSubscriber::eventHeard, this));
-    m_reader->reader.listener(&m_reader->listener, dds::core::status::StatusMask::data_available());
+    m_reader->listen();
 
-    QObject::connect(this, &RatatoskCurrentAtDepthSubscriber::eventHeard, this, &RatatoskCurrentAtDepthSubscriber::updateValue);
+    sinspekto::connect_event(
+        this, &RatatoskCurrentAtDepthSubscriber::eventHeard, &RatatoskCurrentAtDepthSubscriber::updateValue, topic);
   }
 }
 
@@ -72,18 +73,8 @@ QDateTime RatatoskCurrentAtDepthSubscriber::timestamp() const
 void RatatoskCurrentAtDepthSubscriber::updateValue()
 {
   if(!m_reader) return;
-  dds::sub::LoanedSamples<ratatosk::types::CurrentAtDepth> samples =
-    m_reader->reader.select()
-    .state(dds::sub::status::DataState::new_data()).take();
-  uint32_t num = samples.length();
-
-  if(num > 0)
+  if(m_reader->takeLast())
     {
-      auto sample = (--samples.end()); // picks the last sample
-      m_reader->sample = sample->data();
-      m_reader->timepoint = sample->info().timestamp();
-      auto datetime = QDateTime();
-
       emit depthChanged(m_reader->sample.depth());
       emit directionChanged(m_reader->sample.direction());
       emit speedChanged(m_reader->sample.speed());
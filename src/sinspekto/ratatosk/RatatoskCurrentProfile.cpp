@@ -26,9 +26,10 @@ void RatatoskCurrentProfileSubscriber::init(
   {
     m_reader->listener = sinspekto::DdsReaderListener<ratatosk::types::CurrentProfile>(
         std::bind(&RatatoskCurrentProfileSubscriber::eventHeard, this));
-    m_reader->reader.listener(&m_reader->listener, dds::core::status::StatusMask::data_available());
+    m_reader->listen();
 
-    QObject::connect(this, &RatatoskCurrentProfileSubscriber::eventHeard, this, &RatatoskCurrentProfileSubscriber::updateValue);
+    sinspekto::connect_event(
+        this, &RatatoskCurrentProfileSubscriber::eventHeard, &RatatoskCurrentProfileSubscriber::updateValue, topic);
   }
 }
 
@@ -90,18 +91,8 @@ QDateTime RatatoskCurrentProfileSubscriber::timestamp() const
 void RatatoskCurrentProfileSubscriber::updateValue()
 {
   if(!m_reader) return;
-  dds::sub::LoanedSamples<ratatosk::types::CurrentProfile> samples =
-    m_reader->reader.select()
-    .state(dds::sub::status::DataState::new_data()).take();
-  uint32_t num = samples.length();
-
-  if(num > 0)
+  if(m_reader->takeLast())
     {
-      auto sample = (--samples.end()); // picks the last sample
-      m_reader->sample = sample->data();
-      m_reader->timepoint = sample->info().timestamp();
-      auto datetime = QDateTime();
-
       auto currents = m_reader->sample.currents();
       std::vector<double> depths, directions, speeds;
 
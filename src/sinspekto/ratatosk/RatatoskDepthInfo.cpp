@@ -26,9 +26,10 @@ void RatatoskDepthInfoSubscriber::init(
   {
     m_reader->listener = sinspekto::DdsReaderListener<ratatosk::types::DepthInfo>(
         std::bind(&RatatoskDepthInfoSubscriber::eventHeard, this));
-    m_reader->reader.listener(&m_reader->listener, dds::core::status::StatusMask::data_available());
+    m_reader->listen();
 
-    QObject::connect(this, &RatatoskDepthInfoSubscriber::eventHeard, this, &RatatoskDepthInfoSubscriber::updateValue);
+    sinspekto::connect_event(
+        this, &RatatoskDepthInfoSubscriber::eventHeard, &RatatoskDepthInfoSubscriber::updateValue, topic);
   }
 }
 
@@ -64,18 +65,8 @@ QDateTime RatatoskDepthInfoSubscriber::timestamp() const
 void RatatoskDepthInfoSubscriber::updateValue()
 {
   if(!m_reader) return;
-  dds::sub::LoanedSamples<ratatosk::types::DepthInfo> samples =
-    m_reader->reader.select()
-    .state(dds::sub::status::DataState::new_data()).take();
-  uint32_t num = samples.length();
-
-  if(num > 0)
+  if(m_reader->takeLast())
     {
-      auto sample = (--samples.end()); // picks the last sample
-      m_reader->sample = sample->data();
-      m_reader->timepoint = sample->info().timestamp();
-      auto datetime = QDateTime();
-
       emit depthChanged(m_reader->sample.depth());
       emit depthBelowTransducerChanged(m_reader->sample.depthBelowTransducer());
 
@@ -26,9 +26,10 @@ void RatatoskDouble2Subscriber::init(
   {
     m_reader->listener = sinspekto::DdsReaderListener<ratatosk::types::Double2>(
         std::bind(&RatatoskDouble2Subscriber::eventHeard, this));
-    m_reader->reader.listener(&m_reader->listener, dds::core::status::StatusMask::data_available());
+    m_reader->listen();
 
-    QObject::connect(this, &RatatoskDouble2Subscriber::eventHeard, this, &RatatoskDouble2Subscriber::updateValue);
+    sinspekto::connect_event(
+        this, &RatatoskDouble2Subscriber::eventHeard, &RatatoskDouble2Subscriber::updateValue, topic);
   }
 }
 
@@ -60,18 +61,8 @@ QDateTime RatatoskDouble2Subscriber::timestamp() const
 void RatatoskDouble2Subscriber::updateValue()
 {
   if(!m_reader) return;
-  dds::sub::LoanedSamples<ratatosk::types::Double2> samples =
-    m_reader->reader.select()
-    .state(dds::sub::status::DataState::new_data()).take();
-  uint32_t num = samples.length();
-
-  if(num > 0)
+  if(m_reader->takeLast())
     {
-      auto sample = (--samples.end()); // picks the last sample
-      m_reader->sample = sample->data();
-      m_reader->timepoint = sample->info().timestamp();
-      auto datetime = QDateTime();
-
       emit valueChanged(QVector2D(
            m_reader->sample.x(),
            m_reader->sample.y()));
@@ -87,7 +78,7 @@ void RatatoskDouble2Subscriber::updateValue()
 
 
 RatatoskDouble2Publisher::RatatoskDouble2Publisher(QObject *parent) :
-  QObject(parent),
+  DdsPublisher(parent),
   m_writer(nullptr)
 { }
 
@@ -105,7 +96,7 @@ void RatatoskDouble2Publisher::init(
   setValue(start_value);
 
   if (send_first)
-    m_writer->writer << m_writer->sample;
+    writeNow();
 
 }
 
@@ -132,12 +123,18 @@ void RatatoskDouble2Publisher::setValue(QVector2D value)
   {
     m_writer->sample.x() = value.x();
     m_writer->sample.y() = value.y();
-    m_writer->writer << m_writer->sample;
+    requestWrite();
     emit valueChanged(value);
   }
 }
 
 void RatatoskDouble2Publisher::publish()
 {
-  m_writer->writer << m_writer->sample;
+  requestWrite();
+}
+
+void RatatoskDouble2Publisher::writeSample()
+{
+  if(!m_writer) return;
+  write(*m_writer);
 }
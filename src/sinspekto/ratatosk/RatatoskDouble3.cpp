@@ -26,9 +26,10 @@ void RatatoskDouble3Subscriber::init(
   {
     m_reader->listener = sinspekto::DdsReaderListener<ratatosk::types::Double3>(
         std::bind(&RatatoskDouble3Subscriber::eventHeard, this));
-    m_reader->reader.listener(&m_reader->listener, dds::core::status::StatusMask::data_available());
+    m_reader->listen();
 
-    QObject::connect(this, &RatatoskDouble3Subscriber::eventHeard, this, &RatatoskDouble3Subscriber::updateValue);
+    sinspekto::connect_event(
+        this, &RatatoskDouble3Subscriber::eventHeard, &RatatoskDouble3Subscriber::updateValue, topic);
   }
 }
 
@@ -61,18 +62,8 @@ QDateTime RatatoskDouble3Subscriber::timestamp() const
 void RatatoskDouble3Subscriber::updateValue()
 {
   if(!m_reader) return;
-  dds::sub::LoanedSamples<ratatosk::types::Double3> samples =
-    m_reader->reader.select()
-    .state(dds::sub::status::DataState::new_data()).take();
-  uint32_t num = samples.length();
-
-  if(num > 0)
+  if(m_reader->takeLast())
     {
-      auto sample = (--samples.end()); // picks the last sample
-      m_reader->sample = sample->data();
-      m_reader->timepoint = sample->info().timestamp();
-      auto datetime = QDateTime();
-
       emit valueChanged(QVector3D(
            m_reader->sample.x(),
            m_reader->sample.y(),
@@ -89,7 +80,7 @@ void RatatoskDouble3Subscriber::updateValue()
 
 
 RatatoskDouble3Publisher::RatatoskDouble3Publisher(QObject *parent) :
-  QObject(parent),
+  DdsPublisher(parent),
   m_writer(nullptr)
 { }
 
@@ -108,7 +99,7 @@ void RatatoskDouble3Publisher::init(
   setValue(start_value);
 
   if (send_first)
-    m_writer->writer << m_writer->sample;
+    writeNow();
 
 }
 
@@ -138,12 +129,18 @@ void RatatoskDouble3Publisher::setValue(QVector3D value)
     m_writer->sample.x() = value.x();
     m_writer->sample.y() = value.y();
     m_writer->sample.z() = value.z();
-    m_writer->writer << m_writer->sample;
+    requestWrite();
     emit valueChanged(value);
   }
 }
 
 void RatatoskDouble3Publisher::publish()
 {
-  m_writer->writer << m_writer->sample;
+  requestWrite();
+}
+
+void RatatoskDouble3Publisher::writeSample()
+{
+  if(!m_writer) return;
+  write(*m_writer);
 }
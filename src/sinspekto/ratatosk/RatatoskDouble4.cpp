@@ -26,9 +26,10 @@ void RatatoskDouble4Subscriber::init(
   {
     m_reader->listener = sinspekto::DdsReaderListener<ratatosk::types::Double4>(
         std::bind(&RatatoskDouble4Subscriber::eventHeard, this));
-    m_reader->reader.listener(&m_reader->listener, dds::core::status::StatusMask::data_available());
+    m_reader->listen();
 
-    QObject::connect(this, &RatatoskDouble4Subscriber::eventHeard, this, &RatatoskDouble4Subscriber::updateValue);
+    sinspekto::connect_event(
+        this, &RatatoskDouble4Subscriber::eventHeard, &RatatoskDouble4Subscriber::updateValue, topic);
   }
 }
 
@@ -62,18 +63,8 @@ QDateTime RatatoskDouble4Subscriber::timestamp() const
 void RatatoskDouble4Subscriber::updateValue()
 {
   if(!m_reader) return;
-  dds::sub::LoanedSamples<ratatosk::types::Double4> samples =
-    m_reader->reader.select()
-    .state(dds::sub::status::DataState::new_data()).take();
-  uint32_t num = samples.length();
-
-  if(num > 0)
+  if(m_reader->takeLast())
     {
-      auto sample = (--samples.end()); // picks the last sample
-      m_reader->sample = sample->data();
-      m_reader->timepoint = sample->info().timestamp();
-      auto datetime = QDateTime();
-
       emit valueChanged(QVector4D(
            m_reader->sample.x(),
            m_reader->sample.y(),
@@ -91,7 +82,7 @@ void RatatoskDouble4Subscriber::updateValue()
 
 
 RatatoskDouble4Publisher::RatatoskDouble4Publisher(QObject *parent) :
-  QObject(parent),
+  DdsPublisher(parent),
   m_writer(nullptr)
 { }
 
@@ -111,7 +102,7 @@ void RatatoskDouble4Publisher::init(
   setValue(start_value);
 
   if (send_first)
-    m_writer->writer << m_writer->sample;
+    writeNow();
 
 }
 
@@ -144,12 +135,18 @@ void RatatoskDouble4Publisher::setValue(QVector4D value)
     m_writer->sample.y() = value.y();
     m_writer->sample.z() = value.z();
     m_writer->sample.w() = value.w();
-    m_writer->writer << m_writer->sample;
+    requestWrite();
     emit valueChanged(value);
   }
 }
 
 void RatatoskDouble4Publisher::publish()
 {
-  m_writer->writer << m_writer->sample;
+  requestWrite();
+}
+
+void RatatoskDouble4Publisher::writeSample()
+{
+  if(!m_writer) return;
+  write(*m_writer);
 }
@@ -23,9 +23,10 @@ void RatatoskDoubleValSubscriber::init(QtToDds* dds, const QString& topic, bool
   {
     m_reader->listener = sinspekto::DdsReaderListener<ratatosk::types::DoubleVal>(
         std::bind(&RatatoskDoubleValSubscriber::eventHeard, this));
-    m_reader->reader.listener(&m_reader->listener, dds::core::status::StatusMask::data_available());
+    m_reader->listen();
 
-    QObject::connect(this, &RatatoskDoubleValSubscriber::eventHeard, this, &RatatoskDoubleValSubscriber::updateValue);
+    sinspekto::connect_event(
+        this, &RatatoskDoubleValSubscriber::eventHeard, &RatatoskDoubleValSubscriber::updateValue, topic);
   }
 }
 
@@ -52,17 +53,8 @@ void RatatoskDoubleValSubscriber::updateValue()
 {
   if(!m_reader) return;
 
-  dds::sub::LoanedSamples<ratatosk::types::DoubleVal> samples =
-    m_reader->reader.select().state(dds::sub::status::DataState::new_data()).take();
-  uint32_t num = samples.length();
-
-  if(num > 0)
+  if(m_reader->takeLast())
     {
-      auto sample = (--samples.end()); // picks the last sample
-      m_reader->sample = sample->data();
-      m_reader->timepoint = sample->info().timestamp();
-      auto datetime = QDateTime();
-
       emit valChanged(m_reader->sample.val());
       emit timestampChanged(
           [inTime = m_reader->timepoint.to_millisecs()]()
@@ -76,7 +68,7 @@ void RatatoskDoubleValSubscriber::updateValue()
 
 
 RatatoskDoubleValPublisher::RatatoskDoubleValPublisher(QObject *parent) :
-  QObject(parent),
+  DdsPublisher(parent),
   m_writer(nullptr)
 { }
 
@@ -90,7 +82,7 @@ void RatatoskDoubleValPublisher::init(QtToDds* dds, const QString& topic, double
   setVal(start_value);
 
   if (send_first)
-    m_writer->writer << m_writer->sample;
+    writeNow();
 
 }
 
@@ -108,12 +100,18 @@ void RatatoskDoubleValPublisher::setVal(double value)
   else
   {
     m_writer->sample.val() = value;
-    m_writer->writer << m_writer->sample;
+    requestWrite();
     emit valChanged(value);
   }
 }
 
 void RatatoskDoubleValPublisher::publish()
 {
-  m_writer->writer << m_writer->sample;
+  requestWrite();
+}
+
+void RatatoskDoubleValPublisher::writeSample()
+{
+  if(!m_writer) return;
+  write(*m_writer);
 }
@@ -26,9 +26,10 @@ void RatatoskGyroInfoSubscriber::init(
   {
     m_reader->listener = sinspekto::DdsReaderListener<ratatosk::types::GyroInfo>(
         std::bind(&RatatoskGyroInfoSubscriber::eventHeard, this));
-    m_reader->reader.listener(&m_reader->listener, dds::core::status::StatusMask::data_available());
+    m_reader->listen();
 
-    QObject::connect(this, &RatatoskGyroInfoSubscriber::eventHeard, this, &RatatoskGyroInfoSubscriber::updateValue);
+    sinspekto::connect_event(
+        this, &RatatoskGyroInfoSubscriber::eventHeard, &RatatoskGyroInfoSubscriber::updateValue, topic);
   }
 }
 
@@ -64,18 +65,8 @@ QDateTime RatatoskGyroInfoSubscriber::timestamp() const
 void RatatoskGyroInfoSubscriber::updateValue()
 {
   if(!m_reader) return;
-  dds::sub::LoanedSamples<ratatosk::types::GyroInfo> samples =
-    m_reader->reader.select()
-    .state(dds::sub::status::DataState::new_data()).take();
-  uint32_t num = samples.length();
-
-  if(num > 0)
+  if(m_reader->takeLast())
     {
-      auto sample = (--samples.end()); // picks the last sample
-      m_reader->sample = sample->data();
-      m_reader->timepoint = sample->info().timestamp();
-      auto datetime = QDateTime();
-
       emit hdtChanged(m_reader->sample.hdt());
       emit rotChanged(m_reader->sample.rot());
 
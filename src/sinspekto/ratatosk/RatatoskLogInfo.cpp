@@ -26,9 +26,10 @@ void RatatoskLogInfoSubscriber::init(
   {
     m_reader->listener = sinspekto::DdsReaderListener<ratatosk::types::LogInfo>(
         std::bind(&RatatoskLogInfoSubscriber::eventHeard, this));
-    m_reader->reader.listener(&m_reader->listener, dds::core::status::StatusMask::data_available());
+    m_reader->listen();
 
-    QObject::connect(this, &RatatoskLogInfoSubscriber::eventHeard, this, &RatatoskLogInfoSubscriber::updateValue);
+    sinspekto::connect_event(
+        this, &RatatoskLogInfoSubscriber::eventHeard, &RatatoskLogInfoSubscriber::updateValue, topic);
   }
 }
 
@@ -56,18 +57,8 @@ QDateTime RatatoskLogInfoSubscriber::timestamp() const
 void RatatoskLogInfoSubscriber::updateValue()
 {
   if(!m_reader) return;
-  dds::sub::LoanedSamples<ratatosk::types::LogInfo> samples =
-    m_reader->reader.select()
-    .state(dds::sub::status::DataState::new_data()).take();
-  uint32_t num = samples.length();
-
-  if(num > 0)
+  if(m_reader->takeLast())
     {
-      auto sample = (--samples.end()); // picks the last sample
-      m_reader->sample = sample->data();
-      m_reader->timepoint = sample->info().timestamp();
-      auto datetime = QDateTime();
-
       emit speedChanged(m_reader->sample.speed());
 
       emit timestampChanged(
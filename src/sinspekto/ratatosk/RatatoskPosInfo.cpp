@@ -26,9 +26,10 @@ void RatatoskPosInfoSubscriber::init(
   {
     m_reader->listener = sinspekto::DdsReaderListener<ratatosk::types::PosInfo>(
         std::bind(&RatatoskPosInfoSubscriber::eventHeard, this));
-    m_reader->reader.listener(&m_reader->listener, dds::core::status::StatusMask::data_available());
+    m_reader->listen();
 
-    QObject::connect(this, &RatatoskPosInfoSubscriber::eventHeard, this, &RatatoskPosInfoSubscriber::updateValue);
+    sinspekto::connect_event(
+        this, &RatatoskPosInfoSubscriber::eventHeard, &RatatoskPosInfoSubscriber::updateValue, topic);
   }
 }
 
@@ -80,18 +81,8 @@ QDateTime RatatoskPosInfoSubscriber::timestamp() const
 void RatatoskPosInfoSubscriber::updateValue()
 {
   if(!m_reader) return;
-  dds::sub::LoanedSamples<ratatosk::types::PosInfo> samples =
-    m_reader->reader.select()
-    .state(dds::sub::status::DataState::new_data()).take();
-  uint32_t num = samples.length();
-
-  if(num > 0)
+  if(m_reader->takeLast())
     {
-      auto sample = (--samples.end()); // picks the last sample
-      m_reader->sample = sample->data();
-      m_reader->timepoint = sample->info().timestamp();
-      auto datetime = QDateTime();
-
       emit latChanged(m_reader->sample.lat());
       emit lonChanged(m_reader->sample.lon());
       emit sogChanged(m_reader->sample.sog());
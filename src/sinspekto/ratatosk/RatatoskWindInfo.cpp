@@ -26,9 +26,10 @@ void RatatoskWindInfoSubscriber::init(
   {
     m_reader->listener = sinspekto::DdsReaderListener<ratatosk::types::WindInfo>(
         std::bind(&RatatoskWindInfoSubscriber::eventHeard, this));
-    m_reader->reader.listener(&m_reader->listener, dds::core::status::StatusMask::data_available());
+    m_reader->listen();
 
-    QObject::connect(this, &RatatoskWindInfoSubscriber::eventHeard, this, &RatatoskWindInfoSubscriber::updateValue);
+    sinspekto::connect_event(
+        this, &RatatoskWindInfoSubscriber::eventHeard, &RatatoskWindInfoSubscriber::updateValue, topic);
   }
 }
 
@@ -89,18 +90,8 @@ QDateTime RatatoskWindInfoSubscriber::timestamp() const
 void RatatoskWindInfoSubscriber::updateValue()
 {
   if(!m_reader) return;
-  dds::sub::LoanedSamples<ratatosk::types::WindInfo> samples =
-    m_reader->reader.select()
-    .state(dds::sub::status::DataState::new_data()).take();
-  uint32_t num = samples.length();
-
-  if(num > 0)
+  if(m_reader->takeLast())
     {
-      auto sample = (--samples.end()); // picks the last sample
-      m_reader->sample = sample->data();
-      m_reader->timepoint = sample->info().timestamp();
-      auto datetime = QDateTime();
-
       emit trueSpeedChanged(m_reader->sample.trueSpeed());
       emit trueDirChanged(m_reader->sample.trueDir());
       emit relSpeedChanged(m_reader->sample.relSpeed());
@@ -0,0 +1,66 @@
+/**
+   @file test_batch_publisher.cpp
+   @brief Batches are cleared once written, also after congested asynchronous writes.
+*/
+
+#include <QtTest>
+
+#include "sinspekto/QtToDds.hpp"
+#include "sinspekto/DdsIdVec1d.hpp"
+
+class TestBatchPublisher : public QObject
+{
+  Q_OBJECT
+
+private slots:
+  void initTestCase()
+  {
+    m_dds.initLoopback(0);
+    QVERIFY(m_dds.loopback());
+  }
+
+  void flushClearsBatch()
+  {
+    DdsBatchIdVec1dPublisher publisher;
+    publisher.init(&m_dds, "testBatch", "flush");
+    publisher.setMaxBatchAgeMs(0);
+
+    publisher.append(1.0);
+    publisher.append(2.0);
+    QCOMPARE(publisher.batchSize(), 2);
+    publisher.flush();
+    QCOMPARE(publisher.batchSize(), 0);
+  }
+
+  /// A batch kept while congested is written by the next synchronous write.
+  void congestedThenSynchronous()
+  {
+    DdsBatchIdVec1dPublisher publisher;
+    publisher.init(&m_dds, "testBatch", "congested");
+    publisher.setMaxBatchAgeMs(0);
+    publisher.setMaxQueuedWrites(0);
+    publisher.setAsyncWrite(true);
+
+    publisher.append(1.0);
+    publisher.flush();
+    QVERIFY(publisher.congested());
+    QCOMPARE(publisher.batchSize(), 1);
+
+    publisher.setAsyncWrite(false);
+    QVERIFY(!publisher.congested());
+
+    publisher.append(2.0);
+    publisher.flush();
+    QCOMPARE(publisher.batchSize(), 0);
+
+    publisher.append(3.0);
+    publisher.flush();
+    QCOMPARE(publisher.batchSize(), 0);
+  }
+
+private:
+  QtToDds m_dds; ///< Loopback transport shared by the tests.
+};
+
+QTEST_GUILESS_MAIN(TestBatchPublisher)
+#include "test_batch_publisher.moc"
@@ -0,0 +1,105 @@
+/**
+   @file test_rolling_statistics.cpp
+   @brief Rolling statistics over a window evicted in order, as by a circular buffer.
+*/
+
+#include <cmath>
+#include <limits>
+#include <QtTest>
+#include <boost/circular_buffer.hpp>
+
+#include "sinspekto/DdsDoubleBuffer.hpp"
+
+namespace
+{
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+
+  /// Window of values that evicts the oldest into the statistics.
+  class Window
+  {
+  public:
+    explicit Window(int capacity) :
+      m_values(static_cast<size_t>(capacity)),
+      m_stats(capacity)
+    {}
+
+    void append(double value)
+    {
+      if(m_values.full()) m_stats.removeOldest(m_values.front());
+      m_values.push_back(value);
+      m_stats.add(value);
+    }
+
+    const sinspekto::RollingStatistics& stats() const { return m_stats; }
+
+  private:
+    boost::circular_buffer<double> m_values;
+    sinspekto::RollingStatistics m_stats;
+  };
+}
+
+class TestRollingStatistics : public QObject
+{
+  Q_OBJECT
+
+private slots:
+  void slidingWindow()
+  {
+    Window window(3);
+    for(double value : { 1.0, 2.0, 3.0, 4.0 })
+      window.append(value);
+
+    QCOMPARE(window.stats().count(), uint64_t(3));
+    QCOMPARE(window.stats().mean(), 3.0);
+    QCOMPARE(window.stats().stddev(), 1.0);
+    QCOMPARE(window.stats().minimum(), 2.0);
+    QCOMPARE(window.stats().maximum(), 4.0);
+  }
+
+  /// A NaN sample neither enters the statistics nor blocks later evictions.
+  void ignoresNaN()
+  {
+    Window window(3);
+    for(double value : { 1.0, nan, 2.0 })
+      window.append(value);
+
+    QCOMPARE(window.stats().count(), uint64_t(2));
+    QCOMPARE(window.stats().mean(), 1.5);
+    QCOMPARE(window.stats().minimum(), 1.0);
+    QCOMPARE(window.stats().maximum(), 2.0);
+
+    // Evicts 1, NaN and 2
+    for(double value : { 5.0, 6.0, 7.0 })
+      window.append(value);
+
+    QCOMPARE(window.stats().count(), uint64_t(3));
+    QCOMPARE(window.stats().mean(), 6.0);
+    QCOMPARE(window.stats().stddev(), 1.0);
+    QCOMPARE(window.stats().minimum(), 5.0);
+    QCOMPARE(window.stats().maximum(), 7.0);
+    QVERIFY(!std::isnan(window.stats().quantile(0.5)));
+  }
+
+  /// Only NaN in the window is the same as an empty window.
+  void onlyNaN()
+  {
+    Window window(2);
+    window.append(1.0);
+    window.append(nan);
+    window.append(nan);
+
+    QCOMPARE(window.stats().count(), uint64_t(0));
+    QVERIFY(std::isnan(window.stats().mean()));
+    QVERIFY(std::isnan(window.stats().minimum()));
+    QVERIFY(std::isnan(window.stats().maximum()));
+
+    window.append(4.0);
+    QCOMPARE(window.stats().count(), uint64_t(1));
+    QCOMPARE(window.stats().mean(), 4.0);
+    QCOMPARE(window.stats().minimum(), 4.0);
+    QCOMPARE(window.stats().maximum(), 4.0);
+  }
+};
+
+QTEST_GUILESS_MAIN(TestRollingStatistics)
+#include "test_rolling_statistics.moc"
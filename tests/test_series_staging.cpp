@@ -0,0 +1,155 @@
+/**
+   @file test_series_staging.cpp
+   @brief Steady state series updates through SeriesStaging must not allocate.
+*/
+
+#include <cmath>
+#include <QLineSeries>
+#include <QtTest>
+
+#include "sinspekto/DdsBuffer.hpp"
+#include "sinspekto/DdsDoubleBuffer.hpp"
+#include "sinspekto/DdsTimepointBuffer.hpp"
+#include "bench/AllocationCount.hpp"
+
+QT_CHARTS_USE_NAMESPACE
+
+namespace
+{
+  const int capacity = 500; ///< Buffer size of the tests.
+  const int updates = 50; ///< Updates counted after warm up.
+  const int64_t epochMs = 1700000000000; ///< Time of the first sample.
+
+  /// Buffer with samples appended by the test instead of a DDS reader.
+  class TestBuffer : public DdsBuffer
+  {
+  public:
+    TestBuffer()
+    {
+      m_buffers[qml_enums::DimId::X] = new DdsDoubleBuffer(this);
+      m_buffers[qml_enums::DimId::Y] = new DdsDoubleBuffer(this);
+      m_topic = "test";
+      init(capacity);
+      for(auto& buf : m_buffers)
+        buf.second->setCapacity(capacity);
+    }
+
+    /// Append one sample to all dimensions.
+    void append(int64_t time, double value)
+    {
+      sinspekto::SeqLock::WriteGuard write(m_seqlock);
+      m_time->append(time);
+      for(auto& buf : m_buffers)
+        buf.second->append(value);
+    }
+
+    void updateBuffers() override {}
+  };
+}
+
+class TestSeriesStaging : public QObject
+{
+  Q_OBJECT
+
+private slots:
+  void initTestCase()
+  {
+    if(!SINSPEKTO_COUNTS_MALLOC)
+      qWarning("Only operator new is counted on this platform");
+  }
+
+  /// The two vectors handed out are reused, not reallocated.
+  void reusesStorage()
+  {
+    sinspekto::SeriesStaging staging;
+    QLineSeries series;
+    QVector<QPointF>& a = staging.next(capacity);
+    const QPointF *first = a.constData();
+    series.replace(a);
+    QVector<QPointF>& b = staging.next(capacity);
+    const QPointF *second = b.constData();
+    series.replace(b);
+
+    for(int i = 0; i < updates; ++i)
+    {
+      QVector<QPointF>& points = staging.next(capacity);
+      QCOMPARE(points.constData(), i % 2 == 0 ? first : second);
+      series.replace(points);
+    }
+  }
+
+  void replaceDataPoints()
+  {
+    boost::circular_buffer<int64_t> time(capacity);
+    boost::circular_buffer<double> values(capacity);
+    for(int i = 0; i < capacity; ++i)
+    {
+      time.push_back(epochMs + i);
+      values.push_back(std::sin(0.01*i));
+    }
+
+    QLineSeries series;
+    sinspekto::SeriesStaging staging;
+    sinspekto::replace_data_points(time, values, &series, staging);
+    sinspekto::replace_data_points(time, values, &series, staging);
+
+    const uint64_t before = sinspekto::allocations();
+    for(int i = 0; i < updates; ++i)
+      sinspekto::replace_data_points(time, values, &series, staging);
+    QCOMPARE(sinspekto::allocations() - before, uint64_t(0));
+    QCOMPARE(series.count(), capacity);
+  }
+
+  void replaceDoublePoints()
+  {
+    boost::circular_buffer<double> x(capacity);
+    boost::circular_buffer<double> y(capacity);
+    for(int i = 0; i < capacity; ++i)
+    {
+      x.push_back(std::cos(0.01*i));
+      y.push_back(std::sin(0.01*i));
+    }
+
+    QLineSeries series;
+    sinspekto::SeriesStaging staging;
+    sinspekto::replace_double_points(x, y, &series, staging);
+    sinspekto::replace_double_points(x, y, &series, staging);
+
+    const uint64_t before = sinspekto::allocations();
+    for(int i = 0; i < updates; ++i)
+      sinspekto::replace_double_points(x, y, &series, staging);
+    QCOMPARE(sinspekto::allocations() - before, uint64_t(0));
+    QCOMPARE(series.count(), capacity);
+  }
+
+  /// Full buffers evict a sample per append, as in steady operation.
+  void updateSeries()
+  {
+    TestBuffer buffer;
+    int64_t t = epochMs;
+    for(int i = 0; i < capacity; ++i, ++t)
+      buffer.append(t, std::sin(0.01*static_cast<double>(t)));
+
+    QLineSeries timeSeries;
+    QLineSeries xySeries;
+    for(int i = 0; i < 2; ++i)
+    {
+      buffer.updateSeries(&timeSeries, qml_enums::DimId::T, qml_enums::DimId::X);
+      buffer.updateSeries(&xySeries, qml_enums::DimId::X, qml_enums::DimId::Y);
+    }
+
+    const uint64_t before = sinspekto::allocations();
+    for(int i = 0; i < updates; ++i, ++t)
+    {
+      buffer.append(t, std::sin(0.01*static_cast<double>(t)));
+      buffer.updateSeries(&timeSeries, qml_enums::DimId::T, qml_enums::DimId::X);
+      buffer.updateSeries(&xySeries, qml_enums::DimId::X, qml_enums::DimId::Y);
+    }
+    QCOMPARE(sinspekto::allocations() - before, uint64_t(0));
+    QCOMPARE(timeSeries.count(), capacity);
+    QCOMPARE(xySeries.count(), capacity);
+  }
+};
+
+QTEST_MAIN(TestSeriesStaging)
+#include "test_series_staging.moc"